@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "aggregation.hpp"
+#include "allocation_counter.hpp"
+#include "csv_handling.hpp"
+#include "cxxopts.hpp"
+#include "dataset_generator.hpp"
+#include "dicts.hpp"
+#include "fmt/chrono.h"
+#include "fmt/format.h"
+#include "plot_getters.hpp"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "spdlog/spdlog.h"
+#include "string_helpers.hpp"
+#include "thread_pool.hpp"
+#include "utility.hpp"
+
+namespace {
+	using clock = std::chrono::steady_clock;
+
+	volatile double sink{0.0};  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	struct benchmark_t {
+		std::string name;
+		size_t rows{0};	   // rows or points processed per run
+		size_t bytes{0};   // input bytes per run, 0 if not applicable
+		std::function<void()> run;
+		bool per_frame{false};	// runs every frame while drawing, must not allocate
+	};
+
+	struct result_t {
+		std::string name;
+		size_t repetitions{0};
+		double best_seconds{0.0};
+		double mean_seconds{0.0};
+		double rows_per_second{0.0};
+		double mb_per_second{0.0};
+		double allocations_per_run{0.0};
+	};
+
+	struct synthetic_input_t {
+		size_t rows{0};
+		data_dict_t dict{};
+		std::vector<std::string> date_strings{};
+		std::vector<time_t> deltas{};
+		std::filesystem::path csv_path{};
+		size_t csv_size{0};
+	};
+
+	// one second sampling with occasional jitter and a gap every 100'000 samples, values are a noisy sine. The CSV
+	// file is written by the dataset generator with the same number of rows.
+	auto createSyntheticInput(size_t rows, size_t csv_columns, const std::filesystem::path &directory)
+		-> synthetic_input_t {
+		synthetic_input_t input{.rows = rows};
+		// mapped from the raw generator output like the dataset generator does, so every toolchain gets the same input
+		std::mt19937_64 rng{42};
+
+		auto &dict = input.dict;
+		dict.name = "synthetic";
+		dict.uuid = "00000000-0000-0000-0000-000000000000";
+		dict.updateIDs();
+		dict.timestamp->reserve(rows);
+		dict.data->reserve(rows);
+
+		time_t timestamp{1'735'689'600};  // 2025-01-01 00:00:00
+
+		for (size_t i = 0; i < rows; ++i) {
+			timestamp += (randomIndex(rng, 21) == 0) ? 2 : 1;
+			if (i % 100'000 == 99'999) {
+				timestamp += 3'600;
+			}
+
+			dict.timestamp->push_back(timestamp);
+			dict.data->push_back(std::sin(static_cast<double>(i) / 1'000.0) + (0.35 * (randomUniform(rng) - 0.5)));
+		}
+
+		input.deltas.reserve(rows - 1);
+		for (size_t i = 1; i < rows; ++i) {
+			input.deltas.push_back(dict.timestamp->at(i) - dict.timestamp->at(i - 1));
+		}
+		dict.delta_t = calculateMedian(input.deltas);
+
+		input.date_strings.reserve(rows);
+		for (const auto &ts : *dict.timestamp) {
+			input.date_strings.push_back(
+				fmt::format("{:%Y/%m/%d %H:%M:%S}", std::chrono::sys_seconds{std::chrono::seconds{ts}}));
+		}
+
+		const dataset_options_t dataset{.seed = 42,
+										.files = 1,
+										.rows = rows,
+										.columns = csv_columns,
+										.prefix = "spreadsheet_analyzer_bench"};
+		const auto csv_path = generateDataset(dataset, directory).front();
+
+		input.csv_path = csv_path;
+		input.csv_size = std::filesystem::file_size(csv_path);
+
+		return input;
+	}
+
+	auto runBenchmark(const benchmark_t &benchmark, size_t repetitions) -> result_t {
+		result_t result{.name = benchmark.name, .repetitions = repetitions};
+
+		// warm up caches and lazily initialized state
+		benchmark.run();
+
+		double total_seconds{0.0};
+		size_t total_allocations{0};
+		result.best_seconds = std::numeric_limits<double>::max();
+
+		for (size_t i = 0; i < repetitions; ++i) {
+			// counted on all threads, the loaders finalize their columns on the thread pool
+			const auto allocations_start = allocation_counter::getProcessHeapAllocations();
+			const auto start = clock::now();
+			benchmark.run();
+			const auto seconds = std::chrono::duration<double>(clock::now() - start).count();
+			total_allocations += allocation_counter::getProcessHeapAllocations() - allocations_start;
+
+			total_seconds += seconds;
+			result.best_seconds = std::min(result.best_seconds, seconds);
+		}
+
+		result.mean_seconds = total_seconds / static_cast<double>(repetitions);
+		result.rows_per_second = static_cast<double>(benchmark.rows) / result.best_seconds;
+		result.mb_per_second = static_cast<double>(benchmark.bytes) / 1e6 / result.best_seconds;
+		result.allocations_per_run = static_cast<double>(total_allocations) / static_cast<double>(repetitions);
+
+		return result;
+	}
+
+	auto createBenchmarks(synthetic_input_t &input) -> std::vector<benchmark_t> {
+		std::vector<benchmark_t> benchmarks{};
+
+		benchmarks.push_back({.name = "loadCSVs", .rows = input.rows, .bytes = input.csv_size, .run = [&input]() {
+								  progress_counter_t finished{0};
+								  const cancellation_token_t stop_loading{false};
+								  const auto result = loadCSVs({input.csv_path}, finished, stop_loading);
+								  sink = static_cast<double>(result.data.size());
+							  }});
+
+		benchmarks.push_back({.name = "readCSV", .rows = input.rows, .bytes = input.csv_size, .run = [&input]() {
+								  const cancellation_token_t stop_loading{false};
+								  double sum{0.0};
+								  readCSV(
+									  input.csv_path, stop_loading, [](const auto & /*header*/) {},
+									  [&sum](time_t /*date*/, auto row) { sum += row.front(); });
+								  sink = sum;
+							  }});
+
+		size_t date_bytes{0};
+		for (const auto &e : input.date_strings) {
+			date_bytes += e.size();
+		}
+
+		benchmarks.push_back({.name = "parseDate", .rows = input.rows, .bytes = date_bytes, .run = [&input]() {
+								  size_t prefered_fmt{0};
+								  time_t sum{0};
+								  for (const auto &e : input.date_strings) {
+									  sum += parseDate(e, prefered_fmt);
+								  }
+								  sink = static_cast<double>(sum);
+							  }});
+
+		benchmarks.push_back({.name = "calculateMedian", .rows = input.deltas.size(), .run = [&input]() {
+								  sink = static_cast<double>(calculateMedian(input.deltas));
+							  }});
+
+		for (const auto reduction_factor : {10uz, 100uz, 1'000uz}) {
+			benchmarks.push_back({.name = fmt::format("calculateAggregates/{}", reduction_factor),
+								  .rows = input.rows,
+								  .run = [&input, reduction_factor]() {
+									  const auto aggregates = calculateAggregates(input.dict, reduction_factor);
+									  sink = static_cast<double>(aggregates.size());
+								  }});
+		}
+
+		for (const auto reduction_factor : {1uz, 50uz, 1'000uz}) {
+			benchmarks.push_back({.name = fmt::format("getValueRangeAggregated/{}", reduction_factor),
+								  .rows = input.rows,
+								  .run = [&input, reduction_factor]() {
+									  const auto [min, max] = getValueRangeAggregated(input.dict, reduction_factor);
+									  sink = max - min;
+								  }});
+		}
+
+		static constexpr size_t getter_reduction_factor = 10;
+		input.dict.aggregates = std::make_shared<const aggregate_level_t>(aggregate_level_t{
+			.reduction_factor = getter_reduction_factor,
+			.values = calculateAggregates(input.dict, getter_reduction_factor)});
+		input.dict.fit_zoom_range = getValueRangeAggregated(input.dict, getter_reduction_factor);
+
+		const auto getter_count = static_cast<int>(input.dict.aggregates->values.size()) + 4;
+
+		using getter_t = ImPlotPoint (*)(int, void *);
+		const auto getters = std::array{std::pair<std::string_view, getter_t>{"plotDict", plotDict},
+										std::pair<std::string_view, getter_t>{"plotDictMean", plotDictMean},
+										std::pair<std::string_view, getter_t>{"plotDictStdPlus", plotDictStdPlus}};
+
+		for (const auto &[name, getter] : getters) {
+			benchmarks.push_back({.name = fmt::format("getter/{}", name),
+								  .rows = static_cast<size_t>(getter_count),
+								  .run = [&input, getter, getter_count]() {
+									  plot_data_t plot_data{.data = &input.dict,
+															.reduction_factor = getter_reduction_factor,
+															.start_index = 0,
+															.count = getter_count,
+															.linked_date_range = {0.0, 0.0}};
+									  double sum{0.0};
+									  for (int i = 0; i < getter_count; ++i) {
+										  const auto point = getter(i, &plot_data);
+										  sum += std::isnan(point.y) ? 0.0 : point.y;
+									  }
+									  sink = sum;
+								  },
+								  .per_frame = true});
+		}
+
+		return benchmarks;
+	}
+
+	auto writeResultsJSON(std::ostream &out, const std::vector<result_t> &results, size_t rows) -> void {
+		out << fmt::format("{{\n  \"rows\": {},\n  \"allocation_counting\": {},\n  \"benchmarks\": [", rows,
+						   allocation_counter::isEnabled());
+
+		for (bool first = true; const auto &r : results) {
+			out << fmt::format(
+				"{}\n    {{\"name\": \"{}\", \"repetitions\": {}, \"best_seconds\": {}, \"mean_seconds\": {}, "
+				"\"rows_per_second\": {}, \"mb_per_second\": {}, \"allocations_per_run\": {}}}",
+				first ? "" : ",", escapeJSON(r.name), r.repetitions, r.best_seconds, r.mean_seconds,
+				r.rows_per_second, r.mb_per_second, r.allocations_per_run);
+			first = false;
+		}
+
+		out << "\n  ]\n}\n";
+	}
+
+	auto writeResultsCSV(std::ostream &out, const std::vector<result_t> &results) -> void {
+		out << "name,repetitions,best_seconds,mean_seconds,rows_per_second,mb_per_second,allocations_per_run\n";
+
+		for (const auto &r : results) {
+			out << fmt::format("{},{},{},{},{},{},{}\n", escapeCSV(r.name), r.repetitions, r.best_seconds,
+							   r.mean_seconds, r.rows_per_second, r.mb_per_second, r.allocations_per_run);
+		}
+	}
+}  // namespace
+
+auto main(int argc, char **argv) -> int {
+	// keep stdout free for the results
+	spdlog::set_default_logger(spdlog::stderr_color_mt("bench"));
+	spdlog::set_level(spdlog::level::warn);
+
+	cxxopts::Options options(argv[0], "Spreadsheet Analyzer benchmarks");
+
+	options.add_options()
+		("h,help", "Print usage")
+		("r,rows", "rows of the synthetic input", cxxopts::value<size_t>()->default_value("1000000"), "N")
+		("c,columns", "columns of the synthetic CSV file", cxxopts::value<size_t>()->default_value("4"), "N")
+		("n,repetitions", "measured runs per benchmark", cxxopts::value<size_t>()->default_value("5"), "N")
+		("filter", "only run benchmarks whose name contains TEXT", cxxopts::value<std::string>(), "TEXT")
+		("f,format", "output format, json or csv", cxxopts::value<std::string>()->default_value("json"), "FORMAT")
+		("o,output", "write to FILE instead of stdout", cxxopts::value<std::string>(), "FILE")
+		;
+
+	try {
+		const auto result = options.parse(argc, argv);
+
+		if (result.count("help") != 0u) {
+			std::cout << options.help() << '\n';
+			return EXIT_SUCCESS;
+		}
+
+		const auto rows = std::max(result["rows"].as<size_t>(), 2uz);
+		const auto repetitions = std::max(result["repetitions"].as<size_t>(), 1uz);
+		const auto format = result["format"].as<std::string>();
+
+		if (format != "json" && format != "csv") {
+			spdlog::error("Unknown output format \"{}\", expected json or csv", format);
+			return EXIT_FAILURE;
+		}
+
+		auto input = createSyntheticInput(rows, std::max(result["columns"].as<size_t>(), 1uz),
+										  std::filesystem::temp_directory_path());
+		const auto benchmarks = createBenchmarks(input);
+
+		std::vector<result_t> results{};
+		bool frame_allocations{false};
+
+		for (const auto &benchmark : benchmarks) {
+			if (result.count("filter") != 0u &&
+				benchmark.name.find(result["filter"].as<std::string>()) == std::string::npos) {
+				continue;
+			}
+
+			const auto r = runBenchmark(benchmark, repetitions);
+			std::cerr << fmt::format("{:<32} {:>10.3f} ms {:>14.0f} rows/s {:>10.1f} MB/s {:>10.0f} allocs\n", r.name,
+									 r.best_seconds * 1e3, r.rows_per_second, r.mb_per_second,
+									 r.allocations_per_run);
+			results.push_back(r);
+
+			if (benchmark.per_frame && r.allocations_per_run > 0.0) {
+				spdlog::error("{} runs every frame but allocated {} times per run", r.name, r.allocations_per_run);
+				frame_allocations = true;
+			}
+		}
+
+		std::filesystem::remove(input.csv_path);
+
+		std::ofstream file{};
+		if (result.count("output") != 0u) {
+			file.open(result["output"].as<std::string>());
+		}
+
+		auto &out = file.is_open() ? static_cast<std::ostream &>(file) : std::cout;
+
+		if (format == "json") {
+			writeResultsJSON(out, results, rows);
+		} else {
+			writeResultsCSV(out, results);
+		}
+
+		// only ever set with ENABLE_ALLOCATION_COUNTER, the counts are zero otherwise
+		if (frame_allocations) {
+			return EXIT_FAILURE;
+		}
+	} catch (const std::exception &e) {
+		spdlog::critical(e.what());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
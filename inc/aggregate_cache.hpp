@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "dicts.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * Process-wide store of everything derived from the samples of a column alone: the aggregate levels and fit ranges
+ * per (column, reduction factor) and the gap segments per column. Columns are identified by their sample buffers,
+ * which duplicated windows and windows opened on the same files share, so those reuse each other's levels and only
+ * build their own once they look at a different resolution. Levels are only referenced weakly, they are freed once no
+ * column uses them anymore, entries of freed buffers are dropped. Prefetched levels are the exception, they are held
+ * until other levels are prefetched for the same column.
+ */
+class AggregateCache {
+public:
+	static auto getInstance() -> AggregateCache & {
+		static AggregateCache instance;
+		return instance;
+	}
+
+	AggregateCache(const AggregateCache &) = delete;
+	AggregateCache(AggregateCache &&) = delete;
+	auto operator=(const AggregateCache &) -> AggregateCache & = delete;
+	auto operator=(AggregateCache &&) -> AggregateCache & = delete;
+
+	// built unless a column with the same samples already holds this reduction factor
+	auto getLevel(const data_dict_t &dict, size_t reduction_factor) -> std::shared_ptr<const aggregate_level_t>;
+	// builds the missing levels in the background at prefetch priority and drops previously prefetched other ones
+	auto prefetchLevels(const data_dict_t &dict, const std::vector<size_t> &reduction_factors) -> void;
+	// see getValueRangeAggregated
+	auto getFitRange(const data_dict_t &dict, size_t reduction_factor) -> std::pair<double, double>;
+
+private:
+	using segments_t = std::vector<std::pair<size_t, size_t>>;
+
+	struct column_entry_t {
+		// the buffers could be freed and their addresses reused, expired entries belong to other samples
+		std::weak_ptr<std::vector<time_t>> timestamps{};
+		std::weak_ptr<std::vector<double>> values{};
+
+		std::shared_ptr<const segments_t> segments{};
+		std::map<size_t, std::weak_ptr<const aggregate_level_t>> levels{};
+		std::map<size_t, std::pair<double, double>> fit_ranges{};
+
+		std::map<size_t, std::shared_ptr<const aggregate_level_t>> prefetched{};
+		std::set<size_t> prefetching{};
+	};
+
+	AggregateCache();
+	~AggregateCache() = default;
+
+	// needs the mutex to be held
+	auto getEntry(const data_dict_t &dict) -> column_entry_t &;
+	auto buildLevel(const data_dict_t &dict, size_t reduction_factor, task_priority_t priority)
+		-> std::shared_ptr<const aggregate_level_t>;
+
+	std::mutex mutex{};
+	std::map<std::pair<const void *, const void *>, column_entry_t> columns{};
+};
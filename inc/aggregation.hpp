@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <ctime>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "dicts.hpp"
+#include "thread_pool.hpp"
+
+auto calcMax(std::span<const double> data) -> double;
+auto calcMin(std::span<const double> data) -> double;
+auto calcMean(std::span<const double> data) -> double;
+auto calcStd(std::span<const double> data, double mean) -> double;
+
+// summarizes one block of consecutive samples, blocks of less than three samples only use their first value
+auto aggregateBlock(std::span<const double> values, time_t date) -> data_aggregate_t;
+
+// splits the timestamps into segments wherever two consecutive samples are more than gap_threshold apart
+auto createSegments(std::span<const time_t> timestamps, time_t gap_threshold)
+	-> std::vector<std::pair<size_t, size_t>>;
+
+// aggregates every reduction_factor samples within each segment, segments are terminated by a NaN aggregate
+auto calculateAggregates(const data_dict_t &dict, size_t reduction_factor) -> std::vector<data_aggregate_t>;
+// same with the segments already known, they don't depend on the reduction factor, built in chunks on the pool
+auto calculateAggregates(const data_dict_t &dict, std::span<const std::pair<size_t, size_t>> segments,
+						 size_t reduction_factor, task_priority_t priority = task_priority_t::visible)
+	-> std::vector<data_aggregate_t>;
+auto getValueRangeAggregated(const data_dict_t &dict, size_t reduction_factor) -> std::pair<double, double>;
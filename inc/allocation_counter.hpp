@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+// Counts heap allocations by replacing the global operator new and hooking the ImGui allocator. Only built with the
+// ENABLE_ALLOCATION_COUNTER option, otherwise the allocator is left alone and all counters stay at zero.
+namespace allocation_counter {
+	struct counts_t {
+		size_t heap{0};	  // operator new on the calling thread
+		size_t imgui{0};  // ImGui/ImPlot allocations, these only happen on the main thread
+
+		auto operator-(const counts_t &other) const -> counts_t {
+			return {.heap = heap - other.heap, .imgui = imgui - other.imgui};
+		}
+	};
+
+	constexpr auto isEnabled() -> bool {
+#ifdef ENABLE_ALLOCATION_COUNTER
+		return true;
+#else
+		return false;
+#endif
+	}
+
+#ifdef ENABLE_ALLOCATION_COUNTER
+	auto countHeapAllocation() -> void;
+	auto getThreadCounts() -> counts_t;
+	// operator new on all threads, e.g. for work that is split up on the thread pool
+	auto getProcessHeapAllocations() -> size_t;
+	// needs to be called before ImGui::CreateContext()
+	auto installImGuiHooks() -> void;
+#else
+	inline auto getThreadCounts() -> counts_t {
+		return {};
+	}
+
+	inline auto getProcessHeapAllocations() -> size_t {
+		return 0;
+	}
+
+	inline auto installImGuiHooks() -> void {}
+#endif
+}  // namespace allocation_counter
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <ctime>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "csv_handling.hpp"
+#include "dicts.hpp"
+#include "thread_pool.hpp"
+
+struct catalog_file_t {
+	std::filesystem::path path;
+	uintmax_t size{0};
+	time_t first{0};
+	time_t last{0};
+	std::vector<size_t> columns{};	// catalog column of each header column
+};
+
+/**
+ * Index of a folder of CSV files which only knows the time range and the columns of each file, read from their first
+ * line and their tail. Files are ordered by their first date, columns are the union of all headers and keep their
+ * uuid for as long as the catalog lives.
+ */
+struct catalog_t {
+	std::vector<catalog_file_t> files{};
+	std::vector<csv_column_t> columns{};
+	std::vector<std::string> uuids{};
+
+	// indices of the files holding rows within [from, to]
+	[[nodiscard]] auto getOverlapping(time_t from, time_t to) const -> std::vector<size_t>;
+};
+
+// files without a readable header or date are left out, finished counts the files already indexed
+auto buildCatalog(const std::vector<std::filesystem::path> &paths, progress_counter_t &finished,
+				  const cancellation_token_t &stop_loading) -> catalog_t;
+
+// samples of one file, per catalog column
+struct catalog_samples_t {
+	std::vector<std::vector<std::pair<time_t, double>>> columns{};
+
+	[[nodiscard]] auto getMemoryUsage() const -> size_t;
+};
+
+struct catalog_file_read_t {
+	catalog_samples_t summary{};  // block means over a fixed number of equally long intervals of the file
+	catalog_samples_t rows{};	  // empty unless the rows were requested
+};
+
+constexpr auto catalog_summary_points = 32uz;
+
+auto readCatalogFile(const catalog_t &catalog, size_t file, bool keep_rows, const cancellation_token_t &stop_loading)
+	-> catalog_file_read_t;
+
+// where the samples of each file are within the assembled columns, [column][file]
+struct catalog_slice_t {
+	size_t offset{0};
+	size_t count{0};
+	bool loaded{false};
+};
+
+using catalog_layout_t = std::vector<std::vector<catalog_slice_t>>;
+
+struct catalog_sources_t {
+	// columns and layout of the previous assembly, columns in catalog order, both may be empty
+	const std::vector<data_dict_t> &previous;
+	const catalog_layout_t &layout;
+	// per file, the previously loaded rows of files not kept are replaced by their summary
+	const std::vector<bool> &keep_loaded;
+	const std::map<size_t, catalog_samples_t> &new_rows;
+	const std::vector<std::shared_ptr<const catalog_samples_t>> &summaries;
+};
+
+/**
+ * Builds the columns of the catalog from the rows of the loaded files and the summaries of all others, files without
+ * either are left out. Rows of overlapping files are only taken as long as they are newer than the last one, so the
+ * timestamps stay sorted.
+ */
+auto assembleCatalog(const catalog_t &catalog, const catalog_sources_t &sources, task_priority_t priority)
+	-> std::pair<std::vector<data_dict_t>, catalog_layout_t>;
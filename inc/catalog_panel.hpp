@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "catalog.hpp"
+#include "dicts.hpp"
+#include "thread_pool.hpp"
+
+class WindowContext;
+
+// a loaded file
+struct catalog_tile_t {
+	size_t bytes{0};
+	uint64_t last_used{0};	// update of the last frame the tile was visible in
+};
+
+struct catalog_job_result_t {
+	std::vector<size_t> summarized{};
+	std::vector<std::shared_ptr<const catalog_samples_t>> summaries{};	// of the summarized files
+	std::vector<size_t> loaded{};
+	std::vector<size_t> evicted{};
+
+	std::vector<data_dict_t> columns{};
+	catalog_layout_t layout{};
+};
+
+/**
+ * State of a window opened as catalog: the index of the files, the summaries of every file seen so far and the files
+ * currently loaded. Only the files covering the visible range are loaded, at most as many as fit into the memory
+ * budget, the least recently visible ones are evicted first to make room.
+ */
+struct catalog_state_t {
+	bool open{false};  // the catalog window, not the data window
+	std::vector<std::filesystem::path> paths{};
+
+	std::shared_ptr<const catalog_t> catalog{};
+	std::shared_ptr<task_control_t> control{};	// shared with all jobs, finished counts the indexed files
+	std::future<catalog_t> index_job{};
+	std::future<catalog_job_result_t> job{};
+
+	std::vector<std::shared_ptr<const catalog_samples_t>> summaries{};	// per file, null until summarized
+	std::vector<data_dict_t> columns{};									// per catalog column, empty ones included
+	catalog_layout_t layout{};
+	std::map<size_t, catalog_tile_t> tiles{};
+
+	int memory_budget_mib{1024};
+	uint64_t frame{0};
+	bool over_budget{false};  // the visible files don't fit into the budget, only their summaries are shown
+
+	catalog_state_t() = default;
+	catalog_state_t(const catalog_state_t &) = delete;
+	catalog_state_t(catalog_state_t &&) = default;
+	auto operator=(const catalog_state_t &) -> catalog_state_t & = delete;
+	auto operator=(catalog_state_t &&) -> catalog_state_t & = default;
+
+	// the jobs only share what they use and finish on their own, they should just not read any further
+	~catalog_state_t() {
+		if (this->control != nullptr) {
+			this->control->cancelled = true;
+		}
+	}
+
+	[[nodiscard]] auto isCatalog() const -> bool {
+		return !this->paths.empty();
+	}
+
+	// the index, the summaries and the bookkeeping of the tiles, the loaded rows are the columns of the window
+	[[nodiscard]] auto getMemoryUsage() const -> size_t;
+
+	[[nodiscard]] auto isIndexing() const -> bool {
+		return this->index_job.valid() &&
+			   this->index_job.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+	}
+};
+
+// indexes the files in the background, the window then shows their summaries and loads what becomes visible
+auto openCatalog(WindowContext &window_context, const std::vector<std::filesystem::path> &paths) -> void;
+// installs finished jobs and starts loading, summarizing or evicting files for the visible range, every frame
+auto updateCatalog(WindowContext &window_context) -> void;
+
+auto openCatalogWindow(WindowContext &window_context) -> void;
+// draws the files of the catalog and what is loaded as separate window while it is open
+auto drawCatalogWindow(WindowContext &window_context) -> void;
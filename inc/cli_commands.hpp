@@ -0,0 +1,6 @@
+#pragma once
+
+// Headless subcommands like `spreadsheet_analyzer stats <files>`. They are dispatched before SDL is initialized, so
+// they also run on machines without a display.
+auto isCLICommand(int argc, char **argv) -> bool;
+auto runCLICommand(int argc, char **argv) -> int;
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dicts.hpp"
+
+// Case insensitive name filter for the column list. Queries starting with '^' only match name prefixes and are
+// answered by binary search over a sorted index, all other queries match substrings. Typing further characters only
+// narrows down the previous result instead of scanning all columns again.
+class ColumnFilter {
+public:
+	// rebuilds the index if it was built for another generation of the columns, see WindowContext::invalidateViewState
+	auto ensureIndex(const std::vector<data_dict_t> &data, uint64_t data_generation) -> void;
+	auto setQuery(std::string_view new_query) -> void;
+
+	[[nodiscard]] auto isActive() const -> bool {
+		return !this->query.empty();
+	}
+
+	// indices into the column vector in their original order, only valid if the filter is active
+	[[nodiscard]] auto getMatches() const -> const std::vector<size_t> & {
+		return this->matches;
+	}
+
+	auto getInputRef() -> std::string & {
+		return this->input;
+	}
+
+private:
+	auto applyQuery(const std::string &new_query) -> void;
+
+	uint64_t indexed_generation{std::numeric_limits<uint64_t>::max()};
+	std::vector<std::string> lowercase_names{};
+	std::vector<size_t> sorted_indices{};
+
+	std::string input{};
+	std::string query{};
+	std::vector<size_t> matches{};
+};
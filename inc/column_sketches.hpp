@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "quantile_sketch.hpp"
+#include "thread_pool.hpp"
+
+constexpr size_t histogram_bins = 256;
+
+// summary of one block of samples, blocks of a column can be merged into the summary of any range
+struct sketch_block_t {
+	TDigest digest{};
+	std::array<uint32_t, histogram_bins> histogram{};
+};
+
+/**
+ * Per-block distribution summaries of a column. Blocks hold block_size samples, groups blocks_per_group blocks, so a
+ * range query merges at most ~2 * blocks_per_group blocks plus the groups in between, and touches raw samples only in
+ * the partial blocks at both ends. The histogram bins span the value range of the whole column.
+ */
+struct column_sketches_t {
+	static constexpr size_t block_size = 4'096;
+	static constexpr size_t blocks_per_group = 64;
+	static constexpr size_t group_size = block_size * blocks_per_group;
+
+	double min{0.0};
+	double max{0.0};
+	std::vector<sketch_block_t> blocks{};
+	std::vector<sketch_block_t> groups{};
+
+	[[nodiscard]] auto getBin(double value) const -> size_t;
+	[[nodiscard]] auto getBinEdge(size_t bin) const -> double;
+	[[nodiscard]] auto getMemoryUsage() const -> size_t;
+};
+
+struct distribution_t {
+	TDigest digest{};
+	std::array<uint64_t, histogram_bins> histogram{};
+};
+
+// blocks are summarized in parallel on the pool
+auto buildColumnSketches(std::span<const double> values, task_priority_t priority = task_priority_t::visible)
+	-> column_sketches_t;
+
+// distribution of values[first, last), values need to be the ones the sketches were built from
+auto queryDistribution(std::span<const double> values, const column_sketches_t &sketches, size_t first, size_t last)
+	-> distribution_t;
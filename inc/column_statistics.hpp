@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <ctime>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "dicts.hpp"
+
+// Streaming summary of one column. Samples are added one at a time in file order and per file results can be merged
+// afterwards, so memory only depends on the number of distinct sample intervals, not on the number of rows.
+struct column_statistics_t {
+	std::string name;
+	std::string unit;
+
+	size_t count{0};
+	double min{std::numeric_limits<double>::max()};
+	double max{std::numeric_limits<double>::lowest()};
+	double mean{0.0};
+	double m2{0.0};
+	bool is_boolean{true};
+	// false once samples went backwards in time, within a file or across overlapping files. The GUI sorts those, so
+	// the intervals and with them delta_t and the gap count can only be approximated without keeping the samples.
+	bool ordered{true};
+
+	time_t first_timestamp{0};
+	time_t last_timestamp{0};
+	// number of occurrences per distinct interval between consecutive samples
+	std::map<time_t, size_t> delta_histogram{};
+
+	auto add(time_t timestamp, double value) -> void;
+	// appends the statistics of a part of the same column that starts no earlier than this one
+	auto merge(const column_statistics_t &later) -> void;
+
+	[[nodiscard]] auto getStd() const -> double;
+	[[nodiscard]] auto getDataType() const -> data_type_t;
+	// median interval between samples, same as data_dict_t::delta_t
+	[[nodiscard]] auto getDeltaT() const -> time_t;
+	// number of intervals above 10 * delta_t, same threshold as used to split plot segments
+	[[nodiscard]] auto getGapCount() const -> size_t;
+};
+
+/**
+ * Calculates the statistics of all columns of the given files in a single streaming pass per file, so memory does not
+ * depend on the size of the files. Files are read in parallel on the thread pool and their parts of each column are
+ * merged in time order like the GUI merges the samples. Columns are returned sorted by name.
+ */
+auto calculateColumnStatistics(const std::vector<std::filesystem::path> &paths) -> std::vector<column_statistics_t>;
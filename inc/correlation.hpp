@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <ctime>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "dicts.hpp"
+#include "thread_pool.hpp"
+
+struct correlation_matrix_t {
+	std::vector<std::string> uuids{};
+	std::vector<std::string> names{};
+	std::vector<double> values{};  // row major, names.size() x names.size(), NaN if constant over the common samples
+	time_t from{0};
+	time_t interval{0};
+	size_t samples{0};
+
+	[[nodiscard]] auto at(size_t row, size_t col) const -> double {
+		return this->values[(row * this->names.size()) + col];
+	}
+};
+
+/**
+ * Pearson correlation of all pairs of columns over the samples present in both, the columns are sampled once onto a
+ * common grid over [from, to] with the coarsest delta_t of the columns. Every column is centered with missing samples
+ * as 0, so the products of all pairs are a single Zᵀ·Z. Columns with gaps additionally need their sums over the
+ * samples of the other column. Everything is calculated in cache sized blocks of columns and samples, in parallel on
+ * the pool.
+ */
+auto calculateCorrelationMatrix(std::span<const data_dict_t *const> columns, time_t from, time_t to,
+								task_priority_t priority = task_priority_t::visible) -> correlation_matrix_t;
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "correlation.hpp"
+
+class WindowContext;
+
+struct correlation_panel_state_t {
+	bool open{false};
+	bool all_columns{false};  // all float columns instead of the visible ones
+	std::future<std::shared_ptr<const correlation_matrix_t>> job{};
+	std::shared_ptr<const correlation_matrix_t> result{};
+	std::vector<double> heatmap{};	// result values with NaN replaced, as the colormap can't show them
+
+	[[nodiscard]] auto getMemoryUsage() const -> size_t;
+};
+
+// opens the panel and calculates the matrix for the visible range if there is none yet
+auto openCorrelationWindow(WindowContext &window_context) -> void;
+// draws the correlation heatmap as separate window while it is open, clicking a cell shows that pair in the plot
+auto drawCorrelationWindow(WindowContext &window_context) -> void;
@@ -1,11 +1,48 @@
 #pragma once
 
 #include <atomic>
+#include <ctime>
 #include <filesystem>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "dicts.hpp"
+#include "thread_pool.hpp"
+
+struct csv_column_t {
+	std::string header;
+	std::string name;
+	std::string unit;
+};
+
+using csv_header_callback_t = std::function<void(const std::vector<csv_column_t> &)>;
+// values are in header order, NaN marks empty or unparsable cells
+using csv_row_callback_t = std::function<void(time_t, std::span<const double>)>;
+
+auto parseDate(const std::string &str, size_t &prefered_fmt) -> time_t;
+auto parseValue(std::string_view str) -> double;
+
+/**
+ * Streams a CSV file row by row without keeping it in memory. on_header is called once before the first row. Rows
+ * outside the window are skipped without parsing their values, the whole file is read as a single row out of order
+ * could still fall within the window.
+ */
+auto readCSV(const std::filesystem::path &path, const cancellation_token_t &stop_loading,
+			 const csv_header_callback_t &on_header, const csv_row_callback_t &on_row,
+			 const time_window_t &window = {}) -> void;
+
+// columns of a file from its first line, without reading any rows
+auto readCSVHeader(const std::filesystem::path &path) -> std::vector<csv_column_t>;
+// dates of the first and the last row, only reads the beginning and the tail of the file
+auto readTimeRange(const std::filesystem::path &path) -> std::optional<std::pair<time_t, time_t>>;
 
 auto preparePaths(std::vector<std::filesystem::path> paths) -> std::vector<std::filesystem::path>;
-auto loadCSVs(const std::vector<std::filesystem::path> &paths, size_t &finished, const bool &stop_loading)
-	-> std::vector<data_dict_t>;
\ No newline at end of file
+// files entirely outside the window are skipped by their time range, see readTimeRange
+auto loadCSVs(const std::vector<std::filesystem::path> &paths, progress_counter_t &finished,
+			  const cancellation_token_t &stop_loading,
+			  const time_window_t &window = {}) -> load_result_t;
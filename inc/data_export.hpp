@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "dicts.hpp"
+
+enum class export_statistic_t : uint8_t {
+	MEAN,
+	MIN,
+	MAX,
+	FIRST
+};
+
+enum class export_format_t : uint8_t {
+	CSV,
+	BINARY
+};
+
+struct export_settings_t {
+	time_t from{0};
+	time_t to{0};
+	time_t interval{60};
+	export_statistic_t statistic{export_statistic_t::MEAN};
+	export_format_t format{export_format_t::CSV};
+};
+
+auto getStatisticName(export_statistic_t statistic) -> std::string_view;
+auto parseStatistic(std::string_view name) -> std::optional<export_statistic_t>;
+
+/**
+ * Resamples the columns onto the grid from, from + interval, ... <= to and writes them to path. Each grid cell holds
+ * the chosen statistic over all samples in [t, t + interval), empty cells are left empty (CSV) or NaN (binary).
+ * Rows are written as they are computed, so the result is never held in memory.
+ *
+ * The binary format is little endian and column major:
+ *   "SAEXPORT", uint32 version, uint32 column count, uint64 row count, int64 from, int64 interval,
+ *   per column: uint32 name length, name, uint32 unit length, unit,
+ *   per column: row count float64 values.
+ */
+auto exportResampled(const std::vector<const data_dict_t *> &columns, const export_settings_t &settings,
+					 const std::filesystem::path &path) -> bool;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+// Parameters for synthetic CSV files in the format loadCSVs expects. The output only depends on these values, the
+// same seed always produces byte identical files.
+struct dataset_options_t {
+	uint64_t seed{1};
+	size_t files{1};
+	size_t rows{100'000};			   // per file
+	size_t columns{8};
+	time_t start{1'735'689'600};	   // 2025-01-01 00:00:00 UTC
+	time_t interval{1};				   // seconds between samples
+	time_t jitter{0};				   // maximum random deviation of each timestamp in seconds
+	double gap_probability{0.0};	   // per row, starts a gap of gap_length samples
+	size_t gap_length{600};
+	size_t overlap{0};				   // rows shared between consecutive files
+
+	// mix of channel types, the rest are float channels
+	double boolean_fraction{0.0};
+	double enum_fraction{0.0};
+	size_t enum_levels{5};
+
+	double empty_cell_probability{0.0};
+	double malformed_line_probability{0.0};
+	bool slash_dates{false};		   // 2025/01/01 instead of 2025-01-01
+
+	std::string prefix{"dataset"};
+};
+
+// std distributions are implementation defined, these keep the output identical across standard libraries
+auto randomUniform(std::mt19937_64 &rng) -> double;				  // [0, 1)
+auto randomIndex(std::mt19937_64 &rng, size_t count) -> size_t;  // [0, count)
+
+/**
+ * Writes options.files CSV files named <prefix>_<index>.csv into directory, files are generated in parallel. Throws if
+ * any of them could not be written completely.
+ */
+auto generateDataset(const dataset_options_t &options, const std::filesystem::path &directory)
+	-> std::vector<std::filesystem::path>;
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "dicts.hpp"
+#include "thread_pool.hpp"
+
+// files count as the same as long as path, size and modification time match
+struct file_identity_t {
+	std::filesystem::path path;
+	uintmax_t size{0};
+	std::filesystem::file_time_type modified{};
+
+	auto operator<=>(const file_identity_t &) const = default;
+};
+
+auto getFileIdentity(const std::filesystem::path &path) -> file_identity_t;
+
+// one load of a set of files, shared by all windows showing them
+struct dataset_load_t {
+	std::shared_future<load_result_t> result{};
+	size_t required_files{0};
+	// shared with the loading task, finished counts the files
+	std::shared_ptr<task_control_t> control{std::make_shared<task_control_t>()};
+
+	dataset_load_t() = default;
+	dataset_load_t(const dataset_load_t &) = delete;
+	dataset_load_t(dataset_load_t &&) = delete;
+	auto operator=(const dataset_load_t &) -> dataset_load_t & = delete;
+	auto operator=(dataset_load_t &&) -> dataset_load_t & = delete;
+
+	// the last window letting go stops an unfinished load, which finishes on its own in the background
+	~dataset_load_t() {
+		this->control->cancelled = true;
+	}
+};
+
+/**
+ * Process-wide lookup of the loads by file identity. Windows asking for files that are already loaded or still
+ * loading attach to that load and copy its columns, which share the sample buffers, instead of parsing again. Loads
+ * are only referenced weakly here, they are gone as soon as no window holds them anymore.
+ */
+class DatasetRegistry {
+public:
+	using load_function_t = std::function<load_result_t(std::vector<std::filesystem::path>, progress_counter_t &,
+														const cancellation_token_t &, const time_window_t &)>;
+
+	static auto getInstance() -> DatasetRegistry & {
+		static DatasetRegistry instance;
+		return instance;
+	}
+
+	DatasetRegistry(const DatasetRegistry &) = delete;
+	DatasetRegistry(DatasetRegistry &&) = delete;
+	auto operator=(const DatasetRegistry &) -> DatasetRegistry & = delete;
+	auto operator=(DatasetRegistry &&) -> DatasetRegistry & = delete;
+
+	// queues loading the files with fn on the pool unless a load of the same files and window is running or done
+	auto acquire(const std::vector<std::filesystem::path> &paths, const time_window_t &window,
+				 const load_function_t &fn) -> std::shared_ptr<dataset_load_t>;
+
+private:
+	DatasetRegistry() = default;
+	~DatasetRegistry() = default;
+
+	std::mutex mutex{};
+	std::map<std::pair<std::vector<file_identity_t>, time_window_t>, std::weak_ptr<dataset_load_t>> loads{};
+};
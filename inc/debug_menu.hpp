@@ -0,0 +1,8 @@
+#pragma once
+
+#include <list>
+
+#include "window_context.hpp"
+
+auto showProfilerWindow(bool *open) -> void;
+auto showMemoryWindow(bool *open, const std::list<WindowContext> &window_contexts) -> void;
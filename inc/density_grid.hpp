@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "time_join.hpp"
+
+struct xy_point_t {
+	double x;
+	double y;
+};
+
+// points of all Y columns against the X column, sorted by x so any x range is found by binary search
+auto sortPointsByX(const joined_columns_t &joined, task_priority_t priority = task_priority_t::visible)
+	-> std::vector<xy_point_t>;
+
+struct density_bounds_t {
+	double x_min{0.0};
+	double x_max{0.0};
+	double y_min{0.0};
+	double y_max{0.0};
+	size_t columns{0};
+	size_t rows{0};
+
+	auto operator==(const density_bounds_t &) const -> bool = default;
+};
+
+// counts per bin in row major order, the first row is the one at y_max as ImPlot::PlotHeatmap draws from the top
+struct density_grid_t {
+	density_bounds_t bounds{};
+	std::vector<double> counts{};
+	double max_count{0.0};
+};
+
+// only the points within the x bounds are visited, in parallel on the pool
+auto binDensity(const std::vector<xy_point_t> &points, const density_bounds_t &bounds,
+				task_priority_t priority = task_priority_t::visible) -> density_grid_t;
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+class WindowContext;
+
+struct derived_column_dialog_state_t {
+	std::string name{};
+	std::string unit{};
+	std::string expression{};
+	std::string error{};
+};
+
+auto openDerivedColumnPopup(WindowContext &window_context) -> void;
+// needs to be called every frame within the window the popup belongs to
+auto drawDerivedColumnPopup(WindowContext &window_context) -> void;
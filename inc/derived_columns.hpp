@@ -0,0 +1,56 @@
+#pragma once
+
+#include <ctime>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dicts.hpp"
+#include "expression.hpp"
+#include "tl/expected.hpp"
+
+struct derived_column_t {
+	std::string expression;
+	expression::program_t program;
+	std::vector<std::string> input_uuids;  // in program input order
+};
+
+/**
+ * Creates a computed column from an expression over the existing columns, see expression::parse() for the syntax.
+ * The column stays empty until DerivedColumnJobs evaluated it, which starts once it is visible.
+ */
+auto createDerivedColumn(const std::vector<data_dict_t> &data, const std::string &name, const std::string &unit,
+						 const std::string &text) -> tl::expected<data_dict_t, std::string>;
+
+struct derived_samples_t {
+	std::shared_ptr<std::vector<time_t>> timestamp{};
+	std::shared_ptr<std::vector<double>> data{};
+	time_t delta_t{0};
+	data_type_t data_type{data_type_t::FLOAT};
+};
+
+// drops the samples of a derived column and everything built from them, it is evaluated again once visible
+auto invalidateDerivedColumn(data_dict_t &dict) -> void;
+
+// inputs in the order of derived.input_uuids, derived inputs need to be evaluated already
+auto evaluateDerivedColumn(const derived_column_t &derived, const std::vector<data_dict_t> &inputs)
+	-> derived_samples_t;
+
+// Evaluates the visible derived columns of a window on the thread pool, a column stays empty until it is done.
+class DerivedColumnJobs {
+public:
+	// installs finished columns and starts the next ones, every frame, returns true if any column was installed
+	auto update(std::vector<data_dict_t> &data) -> bool;
+
+private:
+	struct job_t {
+		std::vector<std::shared_ptr<const std::vector<double>>> inputs{};  // the samples the job reads
+		std::future<derived_samples_t> result{};
+	};
+
+	auto start(std::vector<data_dict_t> &data, data_dict_t &dict) -> void;
+
+	std::map<std::string, job_t> jobs{};	// by uuid of the derived column
+};
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <compare>
 #include <ctime>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -20,10 +22,31 @@ struct data_aggregate_t {
 	double first;
 };
 
+// aggregates of a column at one reduction factor, never modified once built so columns of the same samples share them
+struct aggregate_level_t {
+	size_t reduction_factor{0};
+	std::vector<data_aggregate_t> values{};
+};
+
+// precomputed ImGui IDs and axis format, so they don't need to be rebuilt every frame
+struct column_ids_t {
+	std::string label;
+	std::string shaded;
+	std::string inf_line;
+	std::string scatter_line;
+	std::string axis_format;
+};
+
+struct derived_column_t;
+struct column_sketches_t;
+struct block_extrema_t;
+struct range_index_t;
+
 struct data_dict_t {
 	std::string name;
 	std::string uuid;
 	std::string unit;
+	column_ids_t ids{};
 	bool visible{false};
 	data_type_t data_type{data_type_t::FLOAT};
 
@@ -31,11 +54,63 @@ struct data_dict_t {
 	time_t delta_t{};
 	std::shared_ptr<std::vector<double>> data{std::make_shared<std::vector<double>>()};
 
-	size_t aggregated_to{0};
-	std::vector<data_aggregate_t> aggregates{};
+	// replaced instead of modified when the resolution changes, see AggregateCache
+	std::shared_ptr<const aggregate_level_t> aggregates{};
 	std::pair<double, double> fit_zoom_range{std::numeric_limits<double>::quiet_NaN(),
 											 std::numeric_limits<double>::quiet_NaN()};
 	int fit_zoom_calculated_for_points{0};
+
+	// set for computed columns, these are evaluated in the background once visible and stay empty until then
+	std::shared_ptr<const derived_column_t> derived{};
+	bool derived_evaluated{false};
+
+	// distribution summaries for histograms and quantiles, built on first use
+	std::shared_ptr<const column_sketches_t> sketches{};
+	// per-block min/max, built by the first event search in this column
+	std::shared_ptr<const block_extrema_t> extrema{};
+	// prefix sums for the statistics of any range, built when the statistics window first shows this column
+	std::shared_ptr<const range_index_t> range_index{};
+
+	// needs to be called whenever name or uuid change
+	auto updateIDs() -> void {
+		this->ids.label = this->name + "##" + this->uuid;
+		this->ids.shaded = "##" + this->name + "##shaded";
+		this->ids.inf_line = "##" + this->uuid + "inf_line";
+		this->ids.scatter_line = "##" + this->uuid + "scatter_line_y";
+
+		if (this->unit.empty()) {
+			this->ids.axis_format = "%g";
+		} else if (this->unit == "%") {
+			this->ids.axis_format = "%g%%";
+		} else {
+			this->ids.axis_format = "%g " + this->unit;
+		}
+	}
+};
+
+// only rows within [from, to] are loaded, unset bounds are open
+struct time_window_t {
+	std::optional<time_t> from{};
+	std::optional<time_t> to{};
+
+	[[nodiscard]] auto isSet() const -> bool {
+		return this->from.has_value() || this->to.has_value();
+	}
+
+	[[nodiscard]] auto contains(time_t date) const -> bool {
+		return (!this->from.has_value() || date >= *this->from) && (!this->to.has_value() || date <= *this->to);
+	}
+
+	[[nodiscard]] auto overlaps(time_t first, time_t last) const -> bool {
+		return (!this->from.has_value() || last >= *this->from) && (!this->to.has_value() || first <= *this->to);
+	}
+
+	auto operator<=>(const time_window_t &) const = default;
+};
+
+struct load_result_t {
+	std::vector<data_dict_t> data{};
+	size_t peak_memory{0};	// accounted bytes of all intermediate buffers while loading
 };
 
 struct immediate_dict {
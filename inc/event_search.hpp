@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+// min and max of every block_size samples, blocks which cannot contain a match are skipped without reading them
+struct block_extrema_t {
+	static constexpr size_t block_size = 1'024;
+
+	struct block_t {
+		double min;
+		double max;
+		bool has_nan;
+	};
+
+	std::vector<block_t> blocks{};
+
+	[[nodiscard]] auto getMemoryUsage() const -> size_t {
+		return sizeof(block_extrema_t) + (this->blocks.capacity() * sizeof(block_t));
+	}
+};
+
+// blocks are summarized in parallel on the pool
+auto buildBlockExtrema(std::span<const double> values, task_priority_t priority = task_priority_t::visible)
+	-> block_extrema_t;
+
+enum class event_kind_t : uint8_t {
+	ABOVE,
+	BELOW,
+	IN_RANGE,
+	RISING_EDGE,
+	FALLING_EDGE
+};
+
+constexpr auto event_kinds = std::array{event_kind_t::ABOVE, event_kind_t::BELOW, event_kind_t::IN_RANGE,
+										event_kind_t::RISING_EDGE, event_kind_t::FALLING_EDGE};
+
+auto getEventKindName(event_kind_t kind) -> std::string_view;
+// edges are searched in BOOLEAN columns, everything else in FLOAT columns
+auto isEdgeEvent(event_kind_t kind) -> bool;
+
+struct event_query_t {
+	event_kind_t kind{event_kind_t::ABOVE};
+	double lower{0.0};	// threshold of ABOVE and BELOW
+	double upper{0.0};
+	size_t max_events{10'000};
+};
+
+// first and last matching sample of an interval, edges have begin == end
+struct event_t {
+	time_t begin;
+	time_t end;
+};
+
+struct event_search_result_t {
+	std::vector<event_t> events{};
+	bool truncated{false};
+	size_t scanned_blocks{0};
+	size_t skipped_blocks{0};
+};
+
+// events within [first, last) of the samples, extrema need to be built from the same values
+auto findEvents(std::span<const time_t> timestamps, std::span<const double> values, const block_extrema_t &extrema,
+				const event_query_t &query, size_t first, size_t last) -> event_search_result_t;
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <ctime>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "event_search.hpp"
+
+class WindowContext;
+
+struct found_event_t {
+	size_t column;	// index into the columns of the result
+	time_t begin;
+	time_t end;
+};
+
+struct event_search_results_t {
+	std::vector<std::string> names{};
+	std::vector<std::string> uuids{};
+	// summaries built by the search, handed back to the columns so later searches skip building them
+	std::vector<std::shared_ptr<const block_extrema_t>> extrema{};
+	std::vector<std::shared_ptr<const std::vector<double>>> sources{};	// the samples the summaries were built from
+
+	std::vector<found_event_t> events{};  // sorted by begin
+	size_t truncated_columns{0};
+	size_t scanned_blocks{0};
+	size_t skipped_blocks{0};
+};
+
+struct event_search_panel_state_t {
+	bool open{false};
+	event_query_t query{};
+	bool all_columns{false};  // all matching columns instead of the visible ones
+	bool visible_range_only{false};
+
+	std::future<std::shared_ptr<const event_search_results_t>> job{};
+	std::shared_ptr<const event_search_results_t> result{};
+	std::optional<size_t> selected{};
+};
+
+auto openEventSearchWindow(WindowContext &window_context) -> void;
+// draws the search as separate window while it is open, clicking an event zooms the linked plots to it
+auto drawEventSearchWindow(WindowContext &window_context) -> void;
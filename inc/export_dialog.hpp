@@ -0,0 +1,20 @@
+#pragma once
+
+#include <future>
+#include <string>
+
+#include "data_export.hpp"
+
+class WindowContext;
+
+struct export_dialog_state_t {
+	export_settings_t settings{};
+	std::string from{};
+	std::string to{};
+	std::future<bool> job{};  // true if the file was written
+};
+
+// opens the popup with the range currently shown in the plot
+auto openExportPopup(WindowContext &window_context) -> void;
+// needs to be called every frame within the window the popup belongs to, files are written on the thread pool
+auto drawExportPopup(WindowContext &window_context) -> void;
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "tl/expected.hpp"
+
+// Arithmetic expressions over columns like `[Voltage (V)] * [Current (A)]` or `abs(T1 - T2)`. Expressions are compiled
+// into a small stack program which is evaluated over batches of samples, so every instruction is a tight loop over
+// contiguous arrays.
+namespace expression {
+	enum class opcode_t : uint8_t {
+		push_input,
+		push_constant,
+		add,
+		subtract,
+		multiply,
+		divide,
+		power,
+		negate,
+		abs,
+		sqrt,
+		exp,
+		log,
+		log10,
+		sin,
+		cos,
+		tan,
+		min,
+		max
+	};
+
+	struct instruction_t {
+		opcode_t op;
+		size_t input{0};	 // push_input only
+		double constant{0};	 // push_constant only
+	};
+
+	struct program_t {
+		std::vector<instruction_t> instructions{};
+		size_t input_count{0};
+		size_t max_stack_depth{0};
+	};
+
+	struct parse_result_t {
+		program_t program{};
+		std::vector<std::string> inputs{};	// referenced column names in input order
+	};
+
+	/**
+	 * Column references are plain identifiers (`T1`) or any text in square brackets (`[Voltage (V)]`). Supported are
+	 * + - * / ^, parentheses, numbers and the functions abs, sqrt, exp, log, log10, sin, cos, tan, min and max.
+	 */
+	auto parse(std::string_view text) -> tl::expected<parse_result_t, std::string>;
+
+	constexpr size_t batch_size = 1'024;
+
+	// keeps the per batch stack buffers, so evaluating many batches does not allocate
+	class Evaluator {
+	public:
+		explicit Evaluator(const program_t &program);
+
+		// inputs[i] holds the values of input i for the batch, all of the same size <= batch_size
+		auto evaluate(std::span<const std::span<const double>> inputs) -> std::span<const double>;
+
+	private:
+		const program_t &program;
+		std::vector<std::vector<double>> stack{};
+	};
+}  // namespace expression
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <filesystem>
+#include <optional>
+#include <string>
 #include <vector>
 
 auto selectFilesFromDialog(bool select_folder) -> std::vector<std::filesystem::path>;
+auto selectSaveFileFromDialog(const std::string &filter_name, const std::string &extension)
+	-> std::optional<std::filesystem::path>;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <limits>
 #include <utility>
 
@@ -20,6 +22,8 @@ public:
 
 	// NOLINTBEGIN(misc-non-private-member-variables-in-classes)
 	int max_data_points{500};
+	// incremented whenever a setting changes which affects derived view state
+	uint64_t settings_generation{0};
 
 	std::pair<double, double> global_link{std::numeric_limits<double>::quiet_NaN(),
 										  std::numeric_limits<double>::quiet_NaN()};
@@ -34,12 +38,30 @@ public:
 
 	bool show_about{false};
 	bool show_debug_menu{false};
+	bool show_profiler{false};
+	bool show_memory{false};
 	
 	float display_scale{1.0f};
 	SDL_Renderer* renderer{nullptr};
 	SDL_Surface* window_icon{nullptr};
+
+	// custom SDL event used by background jobs to wake up the idle main loop
+	std::atomic<Uint32> wakeup_event_type{0};
 	// NOLINTEND(misc-non-private-member-variables-in-classes)
 
+	// may be called from any thread, does nothing until the event type has been registered
+	auto wakeMainLoop() const -> void {
+		const auto event_type = this->wakeup_event_type.load();
+
+		if (event_type == 0) {
+			return;
+		}
+
+		SDL_Event event{};
+		event.type = event_type;
+		SDL_PushEvent(&event);
+	}
+
 private:
 	AppState() = default;
 };
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "column_sketches.hpp"
+
+class WindowContext;
+
+struct histogram_panel_state_t {
+	bool open{false};
+	std::string column_uuid{};
+	bool show_band{false};	// p1 to p99 band and the median of the visible range in the plot
+
+	std::future<std::shared_ptr<const column_sketches_t>> job{};
+	std::string job_uuid{};
+	std::shared_ptr<const std::vector<double>> job_data{};	// the samples the sketches are built from
+
+	// distribution of the last queried range, only recalculated if the range changes
+	std::string result_uuid{};
+	std::shared_ptr<const column_sketches_t> result_sketches{};
+	size_t result_first{0};
+	size_t result_last{0};
+	distribution_t result{};
+	std::array<double, 3> percentiles{};  // p1, p50, p99
+	std::vector<double> bin_centers{};
+	std::vector<double> bin_counts{};
+	double bin_width{0.0};
+};
+
+auto openHistogramWindow(WindowContext &window_context) -> void;
+// draws the histogram and quantiles of the visible range as separate window while it is open
+auto drawHistogramWindow(WindowContext &window_context) -> void;
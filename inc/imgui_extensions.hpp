@@ -1,7 +1,11 @@
 #pragma once
 
+#include <iterator>
+#include <string>
 #include <string_view>
+#include <vector>
 
+#include "dicts.hpp"
 #include "fmt/format.h"
 #include "imgui.h"
 
@@ -18,10 +22,15 @@ namespace ImGuiExt {
 						ImGuiChildFlags flags = ImGuiChildFlags_None) -> bool;
 	auto EndSubWindow() -> void;
 
+	// selection of one of the float columns with data by uuid, returns true if the selection changed
+	auto FloatColumnCombo(const char *label, const std::vector<data_dict_t> &data, std::string &uuid) -> bool;
+
+	// formats into an inline buffer, so short texts don't allocate
 	template <typename... Args>
 	auto TextFormatted(fmt::format_string<Args...> fmt, Args&&... args) -> void {
-		const auto text = fmt::format(fmt, std::forward<decltype(args)>(args)...);
-		ImGui::Text("%s", text.c_str());  // NOLINT(hicpp-vararg)
+		fmt::memory_buffer buffer{};
+		fmt::format_to(std::back_inserter(buffer), fmt, std::forward<decltype(args)>(args)...);
+		ImGui::TextUnformatted(buffer.data(), buffer.data() + buffer.size());
 	}
 
 	template <typename... Args>
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dicts.hpp"
+
+class WindowContext;
+
+struct column_memory_t {
+	std::string name;
+	size_t timestamps{0};
+	size_t values{0};
+	size_t aggregates{0};
+	size_t caches{0};
+	bool shared{false};	 // timestamp or value buffers are shared with another window
+
+	[[nodiscard]] auto total() const -> size_t {
+		return timestamps + values + aggregates + caches;
+	}
+};
+
+struct window_memory_t {
+	std::string title;
+	std::vector<column_memory_t> columns{};
+	size_t caches{0};  // of the window's overlays and panels, see WindowContext::getCacheMemoryUsage
+	size_t peak_load{0};
+
+	[[nodiscard]] auto total() const -> size_t;
+};
+
+struct process_memory_t {
+	size_t resident{0};
+	size_t peak_resident{0};
+};
+
+auto getMemoryUsage(const std::string &str) -> size_t;
+auto getMemoryUsage(const immediate_dict &dict) -> size_t;
+auto getMemoryUsage(const std::unordered_map<std::string, immediate_dict> &dicts) -> size_t;
+// number of windows holding each sample buffer, other references like the dataset registry or jobs are not counted
+using buffer_owners_t = std::unordered_map<const void *, size_t>;
+
+auto getColumnMemoryUsage(const data_dict_t &col) -> column_memory_t;
+auto countBufferOwners(const std::list<WindowContext> &window_contexts) -> buffer_owners_t;
+// columns are marked as shared if another window in owners holds their buffers as well
+auto getWindowMemoryUsage(const WindowContext &ctx, const buffer_owners_t &owners) -> window_memory_t;
+
+// sums up all windows, buffers shared between windows are only counted once
+auto getTotalMemoryUsage(const std::list<WindowContext> &window_contexts) -> size_t;
+auto getProcessMemoryUsage() -> process_memory_t;
+
+auto formatBytes(size_t bytes) -> std::string;
+auto printMemoryReport(const std::vector<window_memory_t> &windows) -> void;
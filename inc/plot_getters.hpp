@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "dicts.hpp"
+#include "implot.h"
+
+// user data of the ImPlot getters below. Index 0 and count - 1 are padding points at the linked date range, count - 3
+// and count - 2 carry the fit zoom range, everything in between maps to data->aggregates starting at start_index.
+struct plot_data_t {
+	const data_dict_t *data;
+	size_t reduction_factor;
+	size_t start_index;
+	int count;
+
+	std::pair<double, double> linked_date_range;
+};
+
+auto plotDict(int i, void *data) -> ImPlotPoint;
+auto plotDictMean(int i, void *data) -> ImPlotPoint;
+auto plotDictMax(int i, void *data) -> ImPlotPoint;
+auto plotDictMin(int i, void *data) -> ImPlotPoint;
+auto plotDictStdPlus(int i, void *data) -> ImPlotPoint;
+auto plotDictStdMinus(int i, void *data) -> ImPlotPoint;
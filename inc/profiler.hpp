@@ -0,0 +1,166 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Lightweight scoped timers for the loading, aggregation and rendering pipeline. If ENABLE_PROFILING is not
+// defined all timers are empty inline classes and are optimized away completely.
+//
+// While a trace is active every ScopedTimer is additionally written as a span in the Trace Event Format, which
+// can be opened with Perfetto or chrome://tracing.
+namespace profiler {
+	enum class stage : uint8_t {
+		load_csv,
+		parse_date,
+		merge,
+		finalize,
+		calculate_aggregates,
+		derived_columns,
+		rolling_statistics,
+		spectrum,
+		correlation,
+		column_sketches,
+		event_search,
+		join_columns,
+		density_grid,
+		range_statistics,
+		catalog,
+		export_data,
+		plot,
+		render,
+		frame
+	};
+
+	constexpr auto stage_count = static_cast<size_t>(stage::frame) + 1;
+
+	struct stage_statistics_t {
+		std::vector<float> samples_ms{};  // rolling window, oldest first
+		double last_ms{0.0};
+		double mean_ms{0.0};
+		double max_ms{0.0};
+		size_t total_count{0};
+	};
+
+	constexpr auto isEnabled() -> bool {
+#ifdef ENABLE_PROFILING
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	auto getStageName(stage s) -> std::string_view;
+	auto getStageStatistics(stage s) -> stage_statistics_t;
+	auto reset() -> void;
+
+	// returns false if the trace file could not be opened or profiling is disabled
+	auto startTrace(const std::filesystem::path &path) -> bool;
+	auto stopTrace() -> void;
+	auto setThreadName(std::string_view name) -> void;
+
+#ifdef ENABLE_PROFILING
+	using clock = std::chrono::steady_clock;
+
+	auto record(stage s, clock::duration duration) -> void;
+	auto isTracing() -> bool;
+	auto traceSpan(stage s, clock::time_point start, clock::time_point stop, std::string_view detail) -> void;
+
+	class ScopedTimer {
+	public:
+		explicit ScopedTimer(stage s) : current_stage{s} {}
+
+		// the detail (e.g. a file name) is only copied while a trace is recorded
+		ScopedTimer(stage s, std::string_view span_detail) : current_stage{s} {
+			if (isTracing()) {
+				this->detail = span_detail;
+			}
+		}
+
+		ScopedTimer(const ScopedTimer &) = delete;
+		ScopedTimer(ScopedTimer &&) = delete;
+		auto operator=(const ScopedTimer &) -> ScopedTimer & = delete;
+		auto operator=(ScopedTimer &&) -> ScopedTimer & = delete;
+
+		~ScopedTimer() {
+			const auto stop = clock::now();
+			record(this->current_stage, stop - this->start);
+
+			if (isTracing()) {
+				traceSpan(this->current_stage, this->start, stop, this->detail);
+			}
+		}
+
+	private:
+		stage current_stage;
+		std::string detail{};
+		clock::time_point start{clock::now()};
+	};
+
+	// sums up many short sections (e.g. one per row) and records them as one sample per batch
+	class Accumulator {
+	public:
+		Accumulator(stage s, size_t samples_per_batch) : current_stage{s}, batch_size{samples_per_batch} {}
+
+		Accumulator(const Accumulator &) = delete;
+		Accumulator(Accumulator &&) = delete;
+		auto operator=(const Accumulator &) -> Accumulator & = delete;
+		auto operator=(Accumulator &&) -> Accumulator & = delete;
+
+		~Accumulator() {
+			this->flush();
+		}
+
+		auto start() -> void {
+			this->section_start = clock::now();
+		}
+
+		auto stop() -> void {
+			this->accumulated += clock::now() - this->section_start;
+
+			if (++this->sections >= this->batch_size) {
+				this->flush();
+			}
+		}
+
+	private:
+		auto flush() -> void {
+			if (this->sections > 0) {
+				record(this->current_stage, this->accumulated);
+			}
+
+			this->accumulated = {};
+			this->sections = 0;
+		}
+
+		stage current_stage;
+		size_t batch_size;
+		size_t sections{0};
+		clock::duration accumulated{};
+		clock::time_point section_start{};
+	};
+#else
+	constexpr auto isTracing() -> bool {
+		return false;
+	}
+
+	class ScopedTimer {
+	public:
+		explicit ScopedTimer(stage /*s*/) {}
+		ScopedTimer(stage /*s*/, std::string_view /*detail*/) {}
+	};
+
+	class Accumulator {
+	public:
+		Accumulator(stage /*s*/, size_t /*batch_size*/) {}
+
+		auto start() -> void {}
+		auto stop() -> void {}
+	};
+#endif
+}  // namespace profiler
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+/**
+ * Merging t-digest: the distribution is kept as weighted centroids which are small near the tails and large around the
+ * median, so extreme quantiles stay accurate with a few hundred centroids. Digests of disjoint sample sets can be
+ * merged into the digest of their union, which allows to precompute them per block.
+ */
+class TDigest {
+public:
+	static constexpr double default_compression = 200.0;
+
+	TDigest() = default;
+	explicit TDigest(double compression_factor) : compression{compression_factor} {}
+
+	static auto fromValues(std::span<const double> values, double compression_factor = default_compression)
+		-> TDigest;
+
+	auto add(double value) -> void;
+	auto merge(const TDigest &other) -> void;
+	auto compress() -> void;
+
+	// q in [0, 1], NaN if empty. Needs to be called on a compressed digest
+	[[nodiscard]] auto quantile(double q) const -> double;
+
+	[[nodiscard]] auto count() const -> double {
+		return this->total_weight;
+	}
+
+	[[nodiscard]] auto min() const -> double {
+		return this->minimum;
+	}
+
+	[[nodiscard]] auto max() const -> double {
+		return this->maximum;
+	}
+
+	[[nodiscard]] auto getMemoryUsage() const -> size_t {
+		return sizeof(TDigest) + (this->centroids.capacity() * sizeof(centroid_t));
+	}
+
+private:
+	struct centroid_t {
+		double mean;
+		double weight;
+	};
+
+	auto compressIfFull() -> void;
+
+	double compression{default_compression};
+	std::vector<centroid_t> centroids{};
+	size_t compressed_size{0};	// centroids after this are unsorted and not yet merged
+	double total_weight{0.0};
+	double minimum{std::numeric_limits<double>::quiet_NaN()};
+	double maximum{std::numeric_limits<double>::quiet_NaN()};
+};
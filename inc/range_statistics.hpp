@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "dicts.hpp"
+#include "event_search.hpp"
+
+/**
+ * Prefix sums and block extrema of one column, answering the statistics of any range of samples at constant cost:
+ * sums are the difference of two prefix entries, min and max combine two overlapping power of two runs of blocks from
+ * a sparse table and scan at most one partial block at each end. NaN samples are left out of everything.
+ */
+struct range_index_t {
+	double shift{0.0};				  // subtracted before summing, keeps the squares small for the std
+	std::vector<double> sum{};		  // n + 1 entries, sum[i] covers the samples before i
+	std::vector<double> sum_squares{};
+	std::vector<double> integral{};	  // n entries, trapezoidal up to sample i, intervals across gaps add nothing
+	std::vector<size_t> valid_count{};	// n + 1 entries, empty if the column has no NaN
+
+	std::shared_ptr<const block_extrema_t> extrema{};
+	// levels[k][i] covers the blocks [i, i + 2^k)
+	std::vector<std::vector<block_extrema_t::block_t>> levels{};
+
+	[[nodiscard]] auto getMemoryUsage() const -> size_t;
+};
+
+// extrema may be null, they are built then
+auto buildRangeIndex(const data_dict_t &dict, std::shared_ptr<const block_extrema_t> extrema) -> range_index_t;
+
+// prefix of the time above the threshold, each sample holds its value until the next one unless there is a gap
+struct threshold_index_t {
+	double threshold{0.0};
+	std::vector<double> duration{};	 // n entries, up to sample i
+};
+
+auto buildThresholdIndex(const data_dict_t &dict, double threshold) -> threshold_index_t;
+
+struct range_statistics_t {
+	size_t count{0};
+	double min{0.0};
+	double max{0.0};
+	double mean{0.0};
+	double std{0.0};
+	double integral{0.0};
+	double duration_above{0.0};
+};
+
+// statistics of the samples [first, last), duration_above is only set if a threshold index is given
+auto queryRangeStatistics(const data_dict_t &dict, const range_index_t &index, const threshold_index_t *threshold,
+						  size_t first, size_t last) -> range_statistics_t;
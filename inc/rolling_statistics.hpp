@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <future>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "dicts.hpp"
+
+enum class rolling_statistic_t : uint8_t {
+	MEAN,
+	MIN,
+	MAX,
+	STD,
+	LOW_PASS
+};
+
+constexpr auto rolling_statistics = std::array{rolling_statistic_t::MEAN, rolling_statistic_t::MIN,
+											   rolling_statistic_t::MAX, rolling_statistic_t::STD,
+											   rolling_statistic_t::LOW_PASS};
+
+auto getRollingStatisticName(rolling_statistic_t statistic) -> std::string_view;
+
+// samples before the first requested one which are needed to fill the window, the low-pass settles after ~5 windows
+auto getRollingWarmUp(rolling_statistic_t statistic, time_t window) -> time_t;
+
+/**
+ * Calculates the statistic over the trailing window (t - window, t] for every sample in [first, last), earlier
+ * samples are only used to fill the window. Runs in O(n): mean and std use running sums, min and max a monotonic
+ * deque. LOW_PASS is a first order filter with the window as time constant, which also handles irregular sampling.
+ */
+auto calculateRolling(std::span<const time_t> timestamps, std::span<const double> values, size_t first, size_t last,
+					  rolling_statistic_t statistic, time_t window) -> std::vector<double>;
+
+struct rolling_settings_t {
+	std::array<bool, rolling_statistics.size()> enabled{};
+	int window{60};	 // seconds
+
+	[[nodiscard]] auto any() const -> bool;
+	auto operator==(const rolling_settings_t &) const -> bool = default;
+};
+
+/**
+ * Overlay series of a single column. Only the visible range plus half a screen and the window margin on each side is
+ * calculated, on a background thread, and recalculated once the visible range leaves it. The results are plain
+ * columns, so they go through the same aggregation and plotting code as loaded data.
+ */
+class RollingOverlay {
+public:
+	auto getSettingsRef() -> rolling_settings_t & {
+		return this->settings;
+	}
+
+	// to be called every frame the source column is plotted
+	auto update(const data_dict_t &source, double x_min, double x_max) -> void;
+	// drops the series and the running job but keeps the settings, once the samples of the source were replaced
+	auto reset() -> void;
+
+	[[nodiscard]] auto getSeries() -> std::vector<data_dict_t> & {
+		return this->series;
+	}
+
+	[[nodiscard]] auto getMemoryUsage() const -> size_t;
+
+private:
+	struct result_t {
+		std::vector<data_dict_t> series{};
+		rolling_settings_t settings{};
+		const std::vector<double> *source{nullptr};
+		double from{std::numeric_limits<double>::quiet_NaN()};
+		double to{std::numeric_limits<double>::quiet_NaN()};
+	};
+
+	struct request_t {
+		std::shared_ptr<const std::vector<time_t>> timestamps;
+		std::shared_ptr<const std::vector<double>> values;
+		std::string name;
+		std::string uuid;
+		std::string unit;
+		time_t delta_t;
+		rolling_settings_t settings;
+		double from;
+		double to;
+	};
+
+	static auto calculate(const request_t &request) -> result_t;
+
+	rolling_settings_t settings{};
+	std::future<result_t> job{};
+
+	// the currently displayed result, without series
+	result_t computed{};
+	std::vector<data_dict_t> series{};
+};
+
+// keyed by the uuid of the source column
+using rolling_overlays_t = std::unordered_map<std::string, RollingOverlay>;
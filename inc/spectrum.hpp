@@ -0,0 +1,39 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <ctime>
+#include <span>
+#include <vector>
+
+#include "dicts.hpp"
+
+// Spectral analysis of single columns. The FFT is a plain iterative radix-2 implementation, sizes therefore have to
+// be powers of two.
+
+// in-place complex FFT
+auto fft(std::span<std::complex<double>> data) -> void;
+
+// bins 0 to n/2 of the spectrum of a real signal, computed with a complex FFT of half the length
+auto fftReal(std::span<const double> input) -> std::vector<std::complex<double>>;
+
+/**
+ * Samples the column every interval seconds over [from, to]. If the column is sampled exactly at that interval in the
+ * range the raw values are used, otherwise they are linearly interpolated between the neighbouring samples.
+ */
+auto resampleUniform(const data_dict_t &dict, time_t from, time_t to, time_t interval) -> std::vector<double>;
+
+struct psd_t {
+	std::vector<double> frequencies{};	// in Hz
+	std::vector<double> power{};		// in unit² / Hz
+	double sample_rate{0.0};
+	size_t segment_length{0};
+	size_t segments{0};
+};
+
+/**
+ * Power spectral density using Welch's method: the mean of every Hann windowed segment is removed and the one-sided
+ * periodograms of all segments, overlapping by 50%, are averaged. Inputs shorter than segment_length are analysed as a
+ * single, shorter segment.
+ */
+auto calculateWelch(std::span<const double> samples, double sample_rate, size_t segment_length) -> psd_t;
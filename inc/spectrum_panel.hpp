@@ -0,0 +1,55 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <ctime>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "dicts.hpp"
+#include "spectrum.hpp"
+
+class WindowContext;
+
+struct spectrum_key_t {
+	std::string uuid;
+	time_t from;
+	time_t to;
+	size_t segment_length;
+
+	auto operator<=>(const spectrum_key_t &) const = default;
+};
+
+// Calculates spectra on a background thread and keeps the last results, so returning to a previous range is instant.
+class SpectrumJobs {
+public:
+	// the spectrum for key, or the most recent one while it is being calculated
+	auto get(const data_dict_t &column, const spectrum_key_t &key) -> std::shared_ptr<const psd_t>;
+	[[nodiscard]] auto isBusy() const -> bool;
+	// drops all spectra and the running job, once the samples of the column were replaced
+	auto clear() -> void;
+	[[nodiscard]] auto getMemoryUsage() const -> size_t;
+
+private:
+	static constexpr size_t cache_size = 16;
+
+	std::map<spectrum_key_t, std::shared_ptr<const psd_t>> cache{};
+	std::deque<spectrum_key_t> insertion_order{};
+	std::future<std::shared_ptr<const psd_t>> job{};
+	spectrum_key_t job_key{};
+	std::shared_ptr<const psd_t> latest{};
+};
+
+struct spectrum_panel_state_t {
+	bool open{false};
+	std::string column_uuid{};
+	int segment_length{1'024};
+	SpectrumJobs jobs{};
+};
+
+auto openSpectrumWindow(WindowContext &window_context) -> void;
+// draws the spectrum of the visible range as separate window while it is open
+auto drawSpectrumWindow(WindowContext &window_context) -> void;
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "range_statistics.hpp"
+
+class WindowContext;
+
+// indexes are only valid for the samples they were built from, the column may hold other ones under the same uuid
+struct statistics_index_t {
+	std::string uuid;
+	std::shared_ptr<const std::vector<double>> data{};
+	std::shared_ptr<const range_index_t> range{};
+	std::shared_ptr<const threshold_index_t> threshold{};
+};
+
+struct statistics_threshold_t {
+	std::shared_ptr<const std::vector<double>> data{};
+	std::shared_ptr<const threshold_index_t> index{};
+};
+
+struct statistics_panel_state_t {
+	bool open{false};
+	bool use_threshold{false};
+	double threshold{0.0};
+	double threshold_input{0.0};  // only applied once editing finished, every threshold needs new indexes
+
+	// per column uuid for the current threshold, the range indexes are kept with the columns
+	std::unordered_map<std::string, statistics_threshold_t> threshold_indexes{};
+	std::future<std::vector<statistics_index_t>> job{};
+};
+
+auto openStatisticsWindow(WindowContext &window_context) -> void;
+// draws the statistics of the visible columns for the visible range as separate window while it is open
+auto drawStatisticsWindow(WindowContext &window_context) -> void;
@@ -5,4 +5,7 @@
 
 auto trim(std::string_view str) -> std::string_view;
 auto stripUnit(std::string_view header) -> std::pair<std::string, std::string>;
-auto getIncrementedWindowTitle(const std::string &title) -> std::string;
\ No newline at end of file
+auto getIncrementedWindowTitle(const std::string &title) -> std::string;
+auto escapeJSON(std::string_view str) -> std::string;
+// quotes the field if it contains a separator, quote or line break
+auto escapeCSV(std::string_view str) -> std::string;
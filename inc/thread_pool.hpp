@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// set by the owner of a task to stop it early, the task checks it between rows or files
+using cancellation_token_t = std::atomic<bool>;
+// advanced by a task, read by its owner e.g. for a progress bar
+using progress_counter_t = std::atomic<size_t>;
+
+// shared between the owner of a task and the task, so the owner can let go of a task without waiting for it
+struct task_control_t {
+	cancellation_token_t cancelled{false};
+	progress_counter_t finished{0};
+};
+
+// tasks of a higher priority are always taken first, running tasks are not interrupted
+enum class task_priority_t : uint8_t {
+	visible,   // needed for what is drawn right now
+	loading,   // loads the user is waiting for
+	prefetch   // may be needed soon
+};
+
+constexpr auto task_priority_count = static_cast<size_t>(task_priority_t::prefetch) + 1;
+
+/**
+ * Process-wide pool for all background work instead of a thread per job. Every worker has its own queue per priority,
+ * it takes its newest task and steals the oldest ones from the other workers once its own are done. Tasks submitted
+ * from a worker are queued on that worker, all others are spread over the workers in turn. Futures of the pool don't
+ * wait for their task when destroyed, tasks need to own or share everything they use.
+ */
+class ThreadPool {
+public:
+	static auto getInstance() -> ThreadPool & {
+		static ThreadPool instance;
+		return instance;
+	}
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool(ThreadPool &&) = delete;
+	auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+	auto operator=(ThreadPool &&) -> ThreadPool & = delete;
+
+	template <typename Fn>
+	auto submit(task_priority_t priority, Fn &&fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>>> {
+		std::packaged_task<std::invoke_result_t<std::decay_t<Fn>>()> task{std::forward<Fn>(fn)};
+		auto future = task.get_future();
+		this->push(priority, std::move(task));
+		return future;
+	}
+
+	/**
+	 * Runs fn for every index in [0, count) on the pool and the calling thread, returns once all of them are done. The
+	 * calling thread takes indices itself, so this finishes even while all workers are busy with other tasks and may be
+	 * called from within a task. The first exception thrown by fn is rethrown.
+	 */
+	auto parallelFor(task_priority_t priority, size_t count, const std::function<void(size_t)> &fn) -> void;
+
+	[[nodiscard]] auto getWorkerCount() const -> size_t {
+		return this->queues.size();
+	}
+
+private:
+	using task_t = std::move_only_function<void()>;
+
+	struct worker_queue_t {
+		std::mutex mutex{};
+		std::array<std::deque<task_t>, task_priority_count> tasks{};
+	};
+
+	ThreadPool();
+	~ThreadPool();
+
+	auto push(task_priority_t priority, task_t task) -> void;
+	auto take(size_t worker) -> task_t;
+	auto run(const std::stop_token &stop, size_t worker) -> void;
+
+	std::vector<std::unique_ptr<worker_queue_t>> queues{};
+	std::atomic<size_t> next_queue{0};
+
+	std::mutex sleep_mutex{};
+	std::condition_variable_any wake{};
+	size_t pending{0};	// queued tasks, guarded by sleep_mutex
+
+	// last so the workers are stopped before anything they use is destroyed
+	std::vector<std::jthread> workers{};
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "dicts.hpp"
+#include "thread_pool.hpp"
+
+// Aligns columns with independent timestamps onto a common time axis.
+
+// sorted union of the timestamps of all columns
+auto mergeTimestamps(std::span<const data_dict_t *const> columns) -> std::vector<time_t>;
+
+// values of the column at from, from + interval, ... (count points), last value within the gap threshold or NaN
+auto sampleOnGrid(const data_dict_t &dict, time_t from, time_t interval, size_t count) -> std::vector<double>;
+
+enum class join_method_t : uint8_t {
+	PREVIOUS,
+	NEAREST,
+	LINEAR
+};
+
+constexpr auto join_methods = std::array{join_method_t::PREVIOUS, join_method_t::NEAREST, join_method_t::LINEAR};
+
+auto getJoinMethodName(join_method_t method) -> std::string_view;
+
+// Looks up the value of one column at monotonically increasing points in time. Every lookup only advances an index,
+// so sampling a whole column is O(n).
+class JoinCursor {
+public:
+	// tolerance defaults to the gap threshold of the column (10 * delta_t)
+	explicit JoinCursor(const data_dict_t &dict);
+	JoinCursor(const data_dict_t &dict, time_t max_distance);
+
+	// positions the cursor in front of t, so a lookup can start in the middle of the column without advancing there
+	auto seek(time_t t) -> void;
+
+	// last sample at or before t, NaN if there is none within the tolerance
+	auto previous(time_t t) -> double;
+	// closest sample to t within the tolerance
+	auto nearest(time_t t) -> double;
+	// interpolated between the samples around t, both need to be within the tolerance
+	auto linear(time_t t) -> double;
+	auto at(time_t t, join_method_t method) -> double;
+
+private:
+	auto advance(time_t t) -> void;
+
+	std::span<const time_t> timestamps;
+	std::span<const double> values;
+	time_t tolerance;
+	size_t index{0};
+};
+
+struct join_options_t {
+	join_method_t method{join_method_t::PREVIOUS};
+	time_t tolerance{0};  // 0 uses the gap threshold of each column
+};
+
+struct joined_columns_t {
+	std::vector<time_t> timestamps{};
+	std::vector<std::vector<double>> values{};	// one vector per column, each as long as timestamps
+
+	[[nodiscard]] auto getMemoryUsage() const -> size_t;
+};
+
+// Joins the columns onto the union of their timestamps within [from, to]. The range is split into blocks which are
+// merged in parallel on the pool, rows where any column has no value within the tolerance are dropped.
+auto joinColumns(std::span<const data_dict_t *const> columns, time_t from, time_t to, const join_options_t &options,
+				 task_priority_t priority = task_priority_t::visible) -> joined_columns_t;
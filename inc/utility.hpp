@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <concepts>
+#include <cstddef>
+#include <vector>
 
 template <std::signed_integral T>
 constexpr auto fastCeil(T numerator, T denominator) -> T {
@@ -24,4 +26,23 @@ constexpr auto fastFloor(T numerator, T denominator) -> T {
 template <std::unsigned_integral T>
 constexpr auto fastFloor(T numerator, T denominator) -> T {
 	return static_cast<T>(fastFloor(std::make_signed_t<T>(numerator), std::make_signed_t<T>(denominator)));
-}
\ No newline at end of file
+}
+
+template <typename T>
+auto calculateMedian(std::vector<T> data) -> T {
+	if (data.empty()) {
+		return 0;
+	}
+
+	const auto n = data.size() / 2;
+	std::nth_element(data.begin(), data.begin() + static_cast<long>(n), data.end());
+
+	if (data.size() % 2 != 0) {
+		return data.at(n);
+	}
+
+	const auto val1 = data.at(n);
+	const auto val2 = *std::max_element(data.cbegin(), data.cbegin() + static_cast<long>(n));
+
+	return (val1 + val2) / T{2};
+}
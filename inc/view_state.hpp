@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "dicts.hpp"
+
+// Derived per-window state which only changes if the visibility of columns, the data itself or the settings change.
+// It is recomputed lazily when the generation it was computed for is outdated.
+struct view_state_t {
+	static constexpr auto invalid_generation = std::numeric_limits<uint64_t>::max();
+
+	uint64_t data_generation{invalid_generation};
+	uint64_t settings_generation{invalid_generation};
+
+	std::vector<size_t> visible_columns{};	// indices of all visible columns in their original order
+
+	// unpadded time and value range of all visible columns with data
+	std::pair<double, double> x_lims{static_cast<double>(std::numeric_limits<time_t>::max()),
+									 static_cast<double>(std::numeric_limits<time_t>::lowest())};
+	std::pair<double, double> value_lims{std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()};
+	bool has_visible_data{false};
+};
+
+auto computeViewState(const std::vector<data_dict_t> &data, view_state_t &state) -> void;
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 
 auto isLightTheme() -> bool;
 auto hideConsole() -> void;
 auto openWebpage(std::string url) -> void;
+auto getProcessCPUTime() -> std::chrono::nanoseconds;
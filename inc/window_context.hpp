@@ -1,38 +1,56 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <filesystem>
 #include <functional>
 #include <future>
+#include <limits>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "catalog_panel.hpp"
+#include "column_filter.hpp"
+#include "correlation_panel.hpp"
+#include "dataset_registry.hpp"
+#include "derived_column_dialog.hpp"
+#include "derived_columns.hpp"
 #include "dicts.hpp"
+#include "event_search_panel.hpp"
+#include "export_dialog.hpp"
+#include "global_state.hpp"
+#include "histogram_panel.hpp"
 #include "implot.h"
+#include "profiler.hpp"
+#include "rolling_statistics.hpp"
+#include "spectrum_panel.hpp"
 #include "spdlog/spdlog.h"
+#include "statistics_panel.hpp"
 #include "string_helpers.hpp"
 #include "uuid.h"
 #include "uuid_generator.hpp"
+#include "view_state.hpp"
+#include "xy_plot_panel.hpp"
 
 class WindowContext {
 public:
-	using function_signature =
-		std::function<std::vector<data_dict_t>(std::vector<std::filesystem::path>, size_t &, const bool &)>;
+	using function_signature = DatasetRegistry::load_function_t;
 
 	WindowContext() = default;
 	explicit WindowContext(std::vector<data_dict_t> new_data) : data{std::move(new_data)} {}
 
-	WindowContext(const std::vector<std::filesystem::path> &paths, const function_signature& loading_fn) {
+	WindowContext(const std::vector<std::filesystem::path> &paths, const function_signature &loading_fn,
+				  const time_window_t &window = {}) {
 		spdlog::debug("Creating window context with UUID: {}", this->getUUID());
-		this->loadFiles(paths, loading_fn);
+		this->loadFiles(paths, loading_fn, window);
 	}
 
 	~WindowContext() {
 		spdlog::debug("Destroying window context with UUID: {}", this->getUUID());
-		if (this->data_dict_f.valid()) {
-			*this->stop_loading = true;
-			this->data_dict_f.wait();
-		}
+		// cancels an unfinished load if no other window shares it, without waiting for it
+		this->dataset.reset();
 		spdlog::debug("Window context with UUID: {} destroyed", this->getUUID());
 
 		if (this->implot_context != nullptr) {
@@ -41,12 +59,17 @@ public:
 	}
 
 	WindowContext(const WindowContext &other)
-		: data{other.data}, window_title{getIncrementedWindowTitle(other.window_title)} {};
+		: data{other.data},
+		  dataset{other.dataset},
+		  window_title{getIncrementedWindowTitle(other.window_title)} {};
 
 	auto operator=(const WindowContext &other) -> WindowContext & {
 		if (this != &other) {
 			this->data = other.data;
+			this->dataset = other.dataset;
 			this->window_title = getIncrementedWindowTitle(other.window_title);
+			this->updateWindowID();
+			this->invalidateViewState();
 		}
 
 		return *this;
@@ -58,12 +81,29 @@ public:
 		  scheduled_for_deletion(other.scheduled_for_deletion),
 		  global_x_link(other.global_x_link) {
 		std::swap(this->implot_context, other.implot_context);
-		std::swap(this->finished_files, other.finished_files);
-		std::swap(this->stop_loading, other.stop_loading);
+		std::swap(this->dataset, other.dataset);
 		std::swap(this->data_dict_f, other.data_dict_f);
-		std::swap(this->required_files, other.required_files);
+		std::swap(this->peak_load_memory, other.peak_load_memory);
 		std::swap(this->window_title, other.window_title);
 		std::swap(this->uuid, other.uuid);
+		std::swap(this->plot_id, other.plot_id);
+		std::swap(this->window_id, other.window_id);
+		std::swap(this->column_filter, other.column_filter);
+		std::swap(this->data_generation, other.data_generation);
+		std::swap(this->view_state, other.view_state);
+		std::swap(this->export_dialog_state, other.export_dialog_state);
+		std::swap(this->derived_column_dialog_state, other.derived_column_dialog_state);
+		std::swap(this->rolling_overlays, other.rolling_overlays);
+		std::swap(this->spectrum_panel_state, other.spectrum_panel_state);
+		std::swap(this->correlation_panel_state, other.correlation_panel_state);
+		std::swap(this->histogram_panel_state, other.histogram_panel_state);
+		std::swap(this->event_search_panel_state, other.event_search_panel_state);
+		std::swap(this->requested_x_range, other.requested_x_range);
+		std::swap(this->xy_plot_panel_state, other.xy_plot_panel_state);
+		std::swap(this->statistics_panel_state, other.statistics_panel_state);
+		std::swap(this->catalog_state, other.catalog_state);
+		std::swap(this->derived_column_jobs, other.derived_column_jobs);
+		std::swap(this->visible_x_range, other.visible_x_range);
 		spdlog::debug("Moved window context with UUID: {}", this->getUUID());
 	}
 
@@ -75,12 +115,29 @@ public:
 			this->global_x_link = other.global_x_link;
 
 			std::swap(this->implot_context, other.implot_context);
-			std::swap(this->finished_files, other.finished_files);
-			std::swap(this->stop_loading, other.stop_loading);
+			std::swap(this->dataset, other.dataset);
 			std::swap(this->data_dict_f, other.data_dict_f);
-			std::swap(this->required_files, other.required_files);
+			std::swap(this->peak_load_memory, other.peak_load_memory);
 			std::swap(this->window_title, other.window_title);
 			std::swap(this->uuid, other.uuid);
+			std::swap(this->plot_id, other.plot_id);
+			std::swap(this->window_id, other.window_id);
+			std::swap(this->column_filter, other.column_filter);
+			std::swap(this->data_generation, other.data_generation);
+			std::swap(this->view_state, other.view_state);
+			std::swap(this->export_dialog_state, other.export_dialog_state);
+			std::swap(this->derived_column_dialog_state, other.derived_column_dialog_state);
+			std::swap(this->rolling_overlays, other.rolling_overlays);
+			std::swap(this->spectrum_panel_state, other.spectrum_panel_state);
+			std::swap(this->correlation_panel_state, other.correlation_panel_state);
+			std::swap(this->histogram_panel_state, other.histogram_panel_state);
+			std::swap(this->event_search_panel_state, other.event_search_panel_state);
+			std::swap(this->requested_x_range, other.requested_x_range);
+			std::swap(this->xy_plot_panel_state, other.xy_plot_panel_state);
+			std::swap(this->statistics_panel_state, other.statistics_panel_state);
+			std::swap(this->catalog_state, other.catalog_state);
+			std::swap(this->derived_column_jobs, other.derived_column_jobs);
+			std::swap(this->visible_x_range, other.visible_x_range);
 			spdlog::debug("Moved window context with UUID: {}", this->getUUID());
 		}
 
@@ -89,6 +146,7 @@ public:
 
 	auto clear() -> void {
 		data.clear();
+		this->invalidateViewState();
 	}
 
 	[[nodiscard]] auto getData() const -> const std::vector<data_dict_t> & {
@@ -101,6 +159,155 @@ public:
 
 	auto setData(std::vector<data_dict_t> new_data) -> void {
 		this->data = std::move(new_data);
+		this->invalidateViewState();
+	}
+
+	// needs to be called after modifying the columns returned by getData(), e.g. their visibility
+	auto invalidateViewState() -> void {
+		++this->data_generation;
+	}
+
+	/**
+	 * Needs to be called for columns whose samples were replaced while keeping their uuid. The panels drop everything
+	 * they built from the previous samples and their running jobs, which would otherwise be used with the new ones.
+	 */
+	auto forgetColumns(const std::vector<std::string> &uuids) -> void {
+		if (uuids.empty()) {
+			return;
+		}
+
+		const auto replaced = [&uuids](const std::string &e) { return std::ranges::find(uuids, e) != uuids.end(); };
+
+		for (const auto &e : uuids) {
+			if (const auto it = this->rolling_overlays.find(e); it != this->rolling_overlays.end()) {
+				it->second.reset();
+			}
+
+			this->statistics_panel_state.threshold_indexes.erase(e);
+		}
+
+		// the jobs of these panels may cover several columns, searches and correlations need to be started again
+		this->statistics_panel_state.job = {};
+		this->event_search_panel_state.job = {};
+		this->correlation_panel_state.job = {};
+
+		if (replaced(this->histogram_panel_state.job_uuid)) {
+			this->histogram_panel_state.job = {};
+			this->histogram_panel_state.job_data.reset();
+		}
+
+		if (replaced(this->histogram_panel_state.result_uuid)) {
+			this->histogram_panel_state.result_uuid.clear();
+			this->histogram_panel_state.result_sketches.reset();
+		}
+
+		if (replaced(this->spectrum_panel_state.column_uuid)) {
+			this->spectrum_panel_state.jobs.clear();
+		}
+
+		auto &correlation = this->correlation_panel_state;
+		if (correlation.result != nullptr && std::ranges::any_of(correlation.result->uuids, replaced)) {
+			correlation.result.reset();
+			correlation.heatmap.clear();
+		}
+
+		auto &xy = this->xy_plot_panel_state;
+		if (replaced(xy.x_uuid) || std::ranges::any_of(xy.y_uuids, replaced)) {
+			xy.jobs.clear();
+			xy.shown.reset();
+		}
+	}
+
+	// starts evaluating visible derived columns and installs the finished ones, every frame
+	auto updateDerivedColumns() -> void {
+		if (this->derived_column_jobs.update(this->data)) {
+			this->invalidateViewState();
+		}
+	}
+
+	[[nodiscard]] auto getViewState() -> const view_state_t & {
+		const auto settings_generation = AppState::getInstance().settings_generation;
+
+		if (this->view_state.data_generation != this->data_generation ||
+			this->view_state.settings_generation != settings_generation) {
+			computeViewState(this->data, this->view_state);
+			this->view_state.data_generation = this->data_generation;
+			this->view_state.settings_generation = settings_generation;
+		}
+
+		return this->view_state;
+	}
+
+	// the index of the filter is brought up to date with the columns like the view state
+	auto getColumnFilterRef() -> ColumnFilter & {
+		this->column_filter.ensureIndex(this->data, this->data_generation);
+		return this->column_filter;
+	}
+
+	auto getExportDialogStateRef() -> export_dialog_state_t & {
+		return this->export_dialog_state;
+	}
+
+	auto getDerivedColumnDialogStateRef() -> derived_column_dialog_state_t & {
+		return this->derived_column_dialog_state;
+	}
+
+	auto getRollingOverlaysRef() -> rolling_overlays_t & {
+		return this->rolling_overlays;
+	}
+
+	auto getSpectrumPanelStateRef() -> spectrum_panel_state_t & {
+		return this->spectrum_panel_state;
+	}
+
+	auto getCorrelationPanelStateRef() -> correlation_panel_state_t & {
+		return this->correlation_panel_state;
+	}
+
+	auto getHistogramPanelStateRef() -> histogram_panel_state_t & {
+		return this->histogram_panel_state;
+	}
+
+	auto getEventSearchPanelStateRef() -> event_search_panel_state_t & {
+		return this->event_search_panel_state;
+	}
+
+	auto getXYPlotPanelStateRef() -> xy_plot_panel_state_t & {
+		return this->xy_plot_panel_state;
+	}
+
+	auto getStatisticsPanelStateRef() -> statistics_panel_state_t & {
+		return this->statistics_panel_state;
+	}
+
+	auto getCatalogStateRef() -> catalog_state_t & {
+		return this->catalog_state;
+	}
+
+	// x range of the plot in the last frame, the extent of the visible columns before anything was plotted
+	[[nodiscard]] auto getVisibleXRange() -> std::pair<double, double> {
+		if (std::isnan(this->visible_x_range.first) || std::isnan(this->visible_x_range.second)) {
+			return this->getViewState().x_lims;
+		}
+
+		return this->visible_x_range;
+	}
+
+	auto setVisibleXRange(double min, double max) -> void {
+		this->visible_x_range = {min, max};
+	}
+
+	// zooms all plots of the window to the range in the next frame
+	auto requestXRange(double min, double max) -> void {
+		this->requested_x_range = {min, max};
+	}
+
+	[[nodiscard]] auto getRequestedXRange() const -> const std::optional<std::pair<double, double>> & {
+		return this->requested_x_range;
+	}
+
+	auto clearRequestedXRange() -> void {
+		this->requested_x_range.reset();
 	}
 
 	auto getWindowOpenRef() -> bool & {
@@ -128,11 +335,13 @@ public:
 	}
 
 	auto scheduleForDeletion() -> void {
-		*this->stop_loading = true;
+		this->dataset.reset();
 		this->scheduled_for_deletion = true;
 	}
 
-	auto loadFiles(const std::vector<std::filesystem::path> &paths, const function_signature &fn) -> void {
+	// rows outside the window are not loaded at all
+	auto loadFiles(const std::vector<std::filesystem::path> &paths, const function_signature &fn,
+				   const time_window_t &window = {}) -> void {
 		if (paths.empty()) {
 			return;
 		}
@@ -143,28 +352,26 @@ public:
 			this->window_title = paths.front().filename().string();
 		}
 
-		this->required_files = paths.size();
-		this->data_dict_f = std::async(std::launch::async, [this, fn, paths]() -> std::vector<data_dict_t> {
-			try {
-				auto &temp_finished_files = *this->finished_files;
-				const auto &temp_stop_loading = *this->stop_loading;
-				return fn(paths, temp_finished_files, temp_stop_loading);
-			} catch (const std::exception &e) {
-				spdlog::error("error loading files for {}: {}", this->window_title, e.what());
-			}
+		this->updateWindowID();
 
-			return {};
-		});
+		this->dataset = DatasetRegistry::getInstance().acquire(paths, window, fn);
+		this->data_dict_f = this->dataset->result;
 	}
 
 	auto checkForFinishedLoading() -> void {
 		if (data_dict_f.valid() && data_dict_f.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-			const auto temp_data_dict = data_dict_f.get();
+			// the columns of the load stay with the registry for other windows opening the same files
+			const auto &result = this->data_dict_f.get();
+			this->peak_load_memory = result.peak_memory;
 
-			if (!temp_data_dict.empty()) {
-				this->data = temp_data_dict;
+			if (!result.data.empty()) {
+				this->data = result.data;
 				this->data.front().visible = true;
 			}
+
+			this->data_dict_f = {};
+
+			this->invalidateViewState();
 		}
 	}
 
@@ -175,18 +382,60 @@ public:
 	};
 
 	auto getLoadingStatus() -> loading_status_t {
+		// catalogs only block the window while indexing, their files are loaded while it is shown
+		if (this->catalog_state.isIndexing()) {
+			return {.is_loading = true,
+					.finished_files = this->catalog_state.control->finished.load(),
+					.required_files = this->catalog_state.paths.size()};
+		}
+
 		const auto is_loading = this->data_dict_f.valid() &&
 								this->data_dict_f.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
-		return {
-			.is_loading = is_loading, .finished_files = *this->finished_files, .required_files = this->required_files};
+		if (this->dataset == nullptr) {
+			return {.is_loading = is_loading, .finished_files = 0, .required_files = 0};
+		}
+
+		return {.is_loading = is_loading,
+				.finished_files = this->dataset->control->finished.load(),
+				.required_files = this->dataset->required_files};
+	}
+
+	// results kept by the overlays and panels, not counting the samples of the columns
+	[[nodiscard]] auto getCacheMemoryUsage() const -> size_t {
+		size_t sum{0};
+
+		for (const auto &[uuid, overlay] : this->rolling_overlays) {
+			sum += overlay.getMemoryUsage();
+		}
+
+		sum += this->spectrum_panel_state.jobs.getMemoryUsage();
+		sum += this->xy_plot_panel_state.jobs.getMemoryUsage();
+		sum += this->xy_plot_panel_state.density_jobs.getMemoryUsage();
+		sum += this->correlation_panel_state.getMemoryUsage();
+		sum += this->catalog_state.getMemoryUsage();
+
+		return sum;
+	}
+
+	[[nodiscard]] auto getPeakLoadMemory() const -> size_t {
+		return this->peak_load_memory;
 	}
 
 	[[nodiscard]] auto getWindowTitle() const -> std::string {
 		return this->window_title;
 	}
 
-	[[nodiscard]] auto getWindowID() const -> std::string {
-		return window_title + "##" + this->getUUID();
+	auto setWindowTitle(const std::string &title) -> void {
+		this->window_title = title;
+		this->updateWindowID();
+	}
+
+	[[nodiscard]] auto getWindowID() const -> const std::string & {
+		return this->window_id;
+	}
+
+	[[nodiscard]] auto getPlotID() const -> const std::string & {
+		return this->plot_id;
 	}
 
 	[[nodiscard]] auto getUUID() const -> std::string {
@@ -219,20 +468,42 @@ public:
 		}
 	}
 private:
+	auto updateWindowID() -> void {
+		this->window_id = this->window_title + "##" + this->getUUID();
+	}
+
 	ImPlotContext *implot_context{nullptr};
 	std::vector<data_dict_t> data{};
 	bool window_open{true};
 	bool scheduled_for_deletion{false};
 	bool global_x_link{false};
 	bool force_subplot{false};
-	std::future<std::vector<data_dict_t>> data_dict_f{};
-
-	// should be fine to use these without locking as they are only written on one thread
-	std::unique_ptr<bool> stop_loading{std::make_unique<bool>(false)};
-	std::unique_ptr<size_t> finished_files{std::make_unique<size_t>(0)};
-	size_t required_files{0};
+	std::shared_ptr<dataset_load_t> dataset{};
+	std::shared_future<load_result_t> data_dict_f{};	// reset once the columns were taken over
+	size_t peak_load_memory{0};
 	std::string window_title;
 	uuids::uuid uuid{UUIDGenerator::getInstance().generate()};
+	std::string plot_id{"##" + uuids::to_string(uuid)};
+	std::string window_id{window_title + "##" + uuids::to_string(uuid)};
 
 	std::vector<std::string> assigned_plot_ids{};
+	ColumnFilter column_filter{};
+
+	uint64_t data_generation{0};
+	view_state_t view_state{};
+
+	export_dialog_state_t export_dialog_state{};
+	derived_column_dialog_state_t derived_column_dialog_state{};
+	rolling_overlays_t rolling_overlays{};
+	spectrum_panel_state_t spectrum_panel_state{};
+	correlation_panel_state_t correlation_panel_state{};
+	histogram_panel_state_t histogram_panel_state{};
+	event_search_panel_state_t event_search_panel_state{};
+	xy_plot_panel_state_t xy_plot_panel_state{};
+	statistics_panel_state_t statistics_panel_state{};
+	DerivedColumnJobs derived_column_jobs{};
+	catalog_state_t catalog_state{};
+	std::pair<double, double> visible_x_range{std::numeric_limits<double>::quiet_NaN(),
+											  std::numeric_limits<double>::quiet_NaN()};
+	std::optional<std::pair<double, double>> requested_x_range{};
 };
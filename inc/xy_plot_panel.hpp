@@ -0,0 +1,90 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <ctime>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "density_grid.hpp"
+#include "dicts.hpp"
+#include "time_join.hpp"
+
+class WindowContext;
+
+struct xy_key_t {
+	std::vector<std::string> uuids;	 // x column first
+	time_t from;
+	time_t to;
+	join_method_t method;
+	time_t tolerance;
+
+	auto operator<=>(const xy_key_t &) const = default;
+};
+
+// Joins the columns on a background thread and keeps the last results, so returning to a previous range is instant.
+class XYJoinJobs {
+public:
+	// the joined columns for key, or the most recent ones while they are being joined
+	auto get(std::span<const data_dict_t *const> columns, const xy_key_t &key)
+		-> std::shared_ptr<const joined_columns_t>;
+	[[nodiscard]] auto isBusy() const -> bool;
+	// drops all joined columns and the running job, once the samples of a column were replaced
+	auto clear() -> void;
+	[[nodiscard]] auto getMemoryUsage() const -> size_t;
+
+private:
+	static constexpr size_t cache_size = 8;
+
+	std::map<xy_key_t, std::shared_ptr<const joined_columns_t>> cache{};
+	std::deque<xy_key_t> insertion_order{};
+	std::future<std::shared_ptr<const joined_columns_t>> job{};
+	xy_key_t job_key{};
+	std::shared_ptr<const joined_columns_t> latest{};
+};
+
+struct density_job_result_t {
+	std::shared_ptr<const std::vector<xy_point_t>> points{};
+	std::shared_ptr<const density_grid_t> grid{};
+};
+
+// Bins the joined points for the current view on a background thread. The points are sorted by x once per joined
+// result, so zooming in only re-bins the points within the new x range.
+class DensityJobs {
+public:
+	// the grid for bounds, or the most recent one of the same points while binning
+	auto get(const std::shared_ptr<const joined_columns_t> &joined, const density_bounds_t &bounds)
+		-> std::shared_ptr<const density_grid_t>;
+	[[nodiscard]] auto isBusy() const -> bool;
+	// the sorted points and the grids, the joined columns belong to XYJoinJobs
+	[[nodiscard]] auto getMemoryUsage() const -> size_t;
+
+private:
+	std::shared_ptr<const joined_columns_t> source{};
+	std::shared_ptr<const std::vector<xy_point_t>> points{};
+
+	std::future<density_job_result_t> job{};
+	std::shared_ptr<const joined_columns_t> job_source{};
+	std::shared_ptr<const density_grid_t> latest{};
+	std::shared_ptr<const joined_columns_t> latest_source{};
+};
+
+struct xy_plot_panel_state_t {
+	bool open{false};
+	std::string x_uuid{};
+	std::vector<std::string> y_uuids{};
+	join_options_t join{};
+	bool density{false};
+	XYJoinJobs jobs{};
+	DensityJobs density_jobs{};
+	std::shared_ptr<const joined_columns_t> shown{};  // the axes are fitted whenever another result is shown
+};
+
+auto openXYPlotWindow(WindowContext &window_context) -> void;
+// draws the selected columns against each other for the visible range as separate window while it is open
+auto drawXYPlotWindow(WindowContext &window_context) -> void;
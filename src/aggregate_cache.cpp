@@ -0,0 +1,162 @@
+#include "aggregate_cache.hpp"
+
+#include <cstddef>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "aggregation.hpp"
+#include "dicts.hpp"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+	auto isExpired(const auto &entry) -> bool {
+		return entry.timestamps.expired() || entry.values.expired();
+	}
+}  // namespace
+
+AggregateCache::AggregateCache() {
+	// prefetch tasks use the cache, the pool needs to be destroyed first to wait for them
+	ThreadPool::getInstance();
+}
+
+auto AggregateCache::getEntry(const data_dict_t &dict) -> column_entry_t & {
+	const auto key = std::pair<const void *, const void *>{dict.timestamp.get(), dict.data.get()};
+	auto it = this->columns.find(key);
+
+	if (it != this->columns.end() && isExpired(it->second)) {
+		this->columns.erase(it);
+		it = this->columns.end();
+	}
+
+	if (it == this->columns.end()) {
+		std::erase_if(this->columns, [](const auto &e) { return isExpired(e.second); });
+		it = this->columns.emplace(key, column_entry_t{.timestamps = dict.timestamp, .values = dict.data}).first;
+	}
+
+	return it->second;
+}
+
+auto AggregateCache::getLevel(const data_dict_t &dict, size_t reduction_factor)
+	-> std::shared_ptr<const aggregate_level_t> {
+	{
+		const std::lock_guard lock{this->mutex};
+		auto &entry = this->getEntry(dict);
+
+		if (const auto it = entry.levels.find(reduction_factor); it != entry.levels.end()) {
+			if (auto level = it->second.lock(); level != nullptr) {
+				return level;
+			}
+		}
+	}
+
+	return this->buildLevel(dict, reduction_factor, task_priority_t::visible);
+}
+
+auto AggregateCache::prefetchLevels(const data_dict_t &dict, const std::vector<size_t> &reduction_factors) -> void {
+	std::vector<size_t> missing{};
+
+	{
+		const std::lock_guard lock{this->mutex};
+		auto &entry = this->getEntry(dict);
+
+		const auto unwanted = [&](size_t reduction_factor) {
+			return std::ranges::find(reduction_factors, reduction_factor) == reduction_factors.end();
+		};
+
+		// levels still being built for other factors are dropped once done
+		std::erase_if(entry.prefetched, [&](const auto &e) { return unwanted(e.first); });
+		std::erase_if(entry.prefetching, unwanted);
+
+		for (const auto &reduction_factor : reduction_factors) {
+			if (entry.prefetched.contains(reduction_factor) || entry.prefetching.contains(reduction_factor)) {
+				continue;
+			}
+
+			if (const auto it = entry.levels.find(reduction_factor); it != entry.levels.end()) {
+				if (auto level = it->second.lock(); level != nullptr) {
+					entry.prefetched[reduction_factor] = std::move(level);
+					continue;
+				}
+			}
+
+			entry.prefetching.insert(reduction_factor);
+			missing.push_back(reduction_factor);
+		}
+	}
+
+	for (const auto &reduction_factor : missing) {
+		// only the sample buffers are shared with the task
+		data_dict_t source{};
+		source.name = dict.name;
+		source.timestamp = dict.timestamp;
+		source.data = dict.data;
+		source.delta_t = dict.delta_t;
+
+		ThreadPool::getInstance().submit(task_priority_t::prefetch, [source = std::move(source), reduction_factor]() {
+			auto &cache = AggregateCache::getInstance();
+			auto level = cache.buildLevel(source, reduction_factor, task_priority_t::prefetch);
+
+			const std::lock_guard lock{cache.mutex};
+			auto &entry = cache.getEntry(source);
+			if (entry.prefetching.erase(reduction_factor) > 0) {
+				entry.prefetched[reduction_factor] = std::move(level);
+			}
+		});
+	}
+}
+
+auto AggregateCache::buildLevel(const data_dict_t &dict, size_t reduction_factor, task_priority_t priority)
+	-> std::shared_ptr<const aggregate_level_t> {
+	std::shared_ptr<const segments_t> segments{};
+
+	{
+		const std::lock_guard lock{this->mutex};
+		segments = this->getEntry(dict).segments;
+	}
+
+	// built outside the lock, at worst two callers build the same level and one of them is dropped
+	if (segments == nullptr) {
+		segments = std::make_shared<const segments_t>(createSegments(std::span{*dict.timestamp}, dict.delta_t * 10));
+	}
+
+	auto level = std::make_shared<aggregate_level_t>();
+	level->reduction_factor = reduction_factor;
+
+	{
+		const profiler::ScopedTimer timer{profiler::stage::calculate_aggregates, dict.name};
+		level->values = calculateAggregates(dict, *segments, reduction_factor, priority);
+	}
+
+	const std::lock_guard lock{this->mutex};
+	auto &entry = this->getEntry(dict);
+
+	std::erase_if(entry.levels, [](const auto &e) { return e.second.expired(); });
+	entry.segments = segments;
+	entry.levels[reduction_factor] = level;
+
+	return level;
+}
+
+auto AggregateCache::getFitRange(const data_dict_t &dict, size_t reduction_factor) -> std::pair<double, double> {
+	{
+		const std::lock_guard lock{this->mutex};
+		const auto &entry = this->getEntry(dict);
+
+		if (const auto it = entry.fit_ranges.find(reduction_factor); it != entry.fit_ranges.end()) {
+			return it->second;
+		}
+	}
+
+	const auto range = getValueRangeAggregated(dict, reduction_factor);
+
+	const std::lock_guard lock{this->mutex};
+	this->getEntry(dict).fit_ranges[reduction_factor] = range;
+
+	return range;
+}
@@ -0,0 +1,167 @@
+#include "aggregation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "dicts.hpp"
+#include "thread_pool.hpp"
+#include "utility.hpp"
+
+auto calcMax(std::span<const double> data) -> double {
+	return *std::ranges::max_element(data);
+}
+
+auto calcMin(std::span<const double> data) -> double {
+	return *std::ranges::min_element(data);
+}
+
+auto calcMean(std::span<const double> data) -> double {
+	return std::accumulate(data.begin(), data.end(), 0.0) / static_cast<double>(data.size());
+}
+
+auto calcStd(std::span<const double> data, double mean) -> double {
+	return std::sqrt(std::accumulate(data.begin(), data.end(), 0.0,
+									 [mean](const auto &a, const auto &b) { return a + (b - mean) * (b - mean); }) /
+					 static_cast<double>(data.size()));
+}
+
+auto aggregateBlock(std::span<const double> values, time_t date) -> data_aggregate_t {
+	if (values.size() >= 3) {
+		const auto mean = calcMean(values);
+		const auto stdev = calcStd(values, mean);
+		const auto min = calcMin(values);
+		const auto max = calcMax(values);
+
+		return {.date = date, .min = min, .max = max, .mean = mean, .std = stdev, .first = values.front()};
+	}
+
+	return {.date = date,
+			.min = values.front(),
+			.max = values.front(),
+			.mean = values.front(),
+			.std = 0,
+			.first = values.front()};
+}
+
+auto createSegments(std::span<const time_t> timestamps, time_t gap_threshold)
+	-> std::vector<std::pair<size_t, size_t>> {
+	std::vector<std::pair<size_t, size_t>> segments;
+	size_t segment_start = 0;
+
+	for (size_t j = 1; j < timestamps.size(); ++j) {
+		const auto ts_diff = timestamps[j] - timestamps[j - 1];
+		if (ts_diff > gap_threshold) {
+			segments.emplace_back(segment_start, j - 1);
+			segment_start = j;
+		}
+	}
+
+	if (segment_start < timestamps.size()) {
+		segments.emplace_back(segment_start, timestamps.size() - 1);
+	}
+
+	if (segments.empty()) {
+		segments.emplace_back(0, timestamps.size() - 1);
+	}
+
+	return segments;
+}
+
+auto calculateAggregates(const data_dict_t &dict, size_t reduction_factor) -> std::vector<data_aggregate_t> {
+	const auto segments = createSegments(std::span{*dict.timestamp}, dict.delta_t * 10);
+	return calculateAggregates(dict, segments, reduction_factor);
+}
+
+auto calculateAggregates(const data_dict_t &dict, std::span<const std::pair<size_t, size_t>> segments,
+						 size_t reduction_factor, task_priority_t priority) -> std::vector<data_aggregate_t> {
+	// blocks of one segment are split into chunks of this many for the pool
+	constexpr auto blocks_per_chunk = 4'096uz;
+
+	struct chunk_t {
+		std::span<const double> values;
+		std::span<const time_t> dates;
+		size_t first_block;
+		size_t last_block;
+		size_t offset;	// of the first block in the aggregates
+	};
+
+	if (dict.data->empty()) {
+		return {};
+	}
+
+	// every segment yields its blocks followed by a NaN aggregate, so the position of every block is known up front
+	std::vector<chunk_t> chunks{};
+	std::vector<data_aggregate_t> aggregates{};
+	aggregates.reserve((dict.data->size() / reduction_factor) + (2 * segments.size()) + 1);
+
+	for (const auto &segment : segments) {
+		const auto length = segment.second - segment.first + 1;
+		const auto values = std::span{*dict.data}.subspan(segment.first, length);
+		const auto dates = std::span{*dict.timestamp}.subspan(segment.first, length);
+		const auto blocks = fastCeil(length, reduction_factor);
+
+		for (size_t block = 0; block < blocks; block += blocks_per_chunk) {
+			chunks.push_back({.values = values,
+							  .dates = dates,
+							  .first_block = block,
+							  .last_block = std::min(blocks, block + blocks_per_chunk),
+							  .offset = aggregates.size() + block});
+		}
+
+		aggregates.resize(aggregates.size() + blocks);
+		aggregates.push_back({.date = dates.back(),
+							  .min = std::numeric_limits<double>::quiet_NaN(),
+							  .max = std::numeric_limits<double>::quiet_NaN(),
+							  .mean = std::numeric_limits<double>::quiet_NaN(),
+							  .std = std::numeric_limits<double>::quiet_NaN(),
+							  .first = std::numeric_limits<double>::quiet_NaN()});
+	}
+
+	ThreadPool::getInstance().parallelFor(priority, chunks.size(), [&](size_t c) {
+		const auto &chunk = chunks[c];
+
+		for (size_t block = chunk.first_block; block < chunk.last_block; ++block) {
+			const auto i = block * reduction_factor;
+			const auto count = std::min(reduction_factor, chunk.values.size() - i);
+			aggregates[chunk.offset + block - chunk.first_block] =
+				aggregateBlock(chunk.values.subspan(i, count), chunk.dates[i]);
+		}
+	});
+
+	return aggregates;
+}
+
+auto getValueRangeAggregated(const data_dict_t &dict, size_t reduction_factor) -> std::pair<double, double> {
+	auto max_val = std::numeric_limits<double>::lowest();
+	auto min_val = std::numeric_limits<double>::max();
+
+	for (size_t i = 0; i < dict.data->size(); i += reduction_factor) {
+		const auto count = std::min(reduction_factor, dict.data->size() - i);
+
+		if (reduction_factor == 1) {
+			max_val = std::max(max_val, dict.data->at(i));
+			min_val = std::min(min_val, dict.data->at(i));
+		} else if (reduction_factor <= 100) {
+			const auto min = calcMin(std::span{*dict.data}.subspan(i, count));
+			const auto max = calcMax(std::span{*dict.data}.subspan(i, count));
+			
+			max_val = std::max(max_val, max);
+			min_val = std::min(min_val, min);
+		} else {
+			const auto mean = calcMean(std::span{*dict.data}.subspan(i, count));
+			const auto stdev = calcStd(std::span{*dict.data}.subspan(i, count), mean);
+			
+			max_val = std::max(max_val, mean + stdev);
+			min_val = std::min(min_val, mean - stdev);
+		}
+	}
+
+	return {min_val, max_val};
+}
@@ -0,0 +1,166 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#include "imgui.h"
+
+namespace allocation_counter {
+	namespace {
+		// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+		thread_local size_t heap_allocations{0};
+		thread_local size_t imgui_allocations{0};
+		std::atomic<size_t> process_heap_allocations{0};
+		// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+		auto imguiAlloc(size_t size, void * /*user_data*/) -> void * {
+			++imgui_allocations;
+			return std::malloc(size);  // NOLINT(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+		}
+
+		auto imguiFree(void *ptr, void * /*user_data*/) -> void {
+			std::free(ptr);	 // NOLINT(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+		}
+	}  // namespace
+
+	auto countHeapAllocation() -> void {
+		++heap_allocations;
+		process_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	auto getThreadCounts() -> counts_t {
+		return {.heap = heap_allocations, .imgui = imgui_allocations};
+	}
+
+	auto getProcessHeapAllocations() -> size_t {
+		return process_heap_allocations.load(std::memory_order_relaxed);
+	}
+
+	auto installImGuiHooks() -> void {
+		ImGui::SetAllocatorFunctions(imguiAlloc, imguiFree);
+	}
+}  // namespace allocation_counter
+
+// NOLINTBEGIN(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+namespace {
+	auto allocate(size_t size) -> void * {
+		allocation_counter::countHeapAllocation();
+		return std::malloc(size == 0 ? 1 : size);
+	}
+
+	auto allocateAligned(size_t size, std::align_val_t alignment) -> void * {
+		allocation_counter::countHeapAllocation();
+		const auto align = static_cast<size_t>(alignment);
+		const auto rounded_size = ((size + align - 1) / align) * align;
+#ifdef _WIN32
+		return _aligned_malloc(rounded_size == 0 ? align : rounded_size, align);
+#else
+		return std::aligned_alloc(align, rounded_size == 0 ? align : rounded_size);
+#endif
+	}
+
+	auto deallocateAligned(void *ptr) -> void {
+#ifdef _WIN32
+		_aligned_free(ptr);
+#else
+		std::free(ptr);
+#endif
+	}
+}  // namespace
+
+auto operator new(size_t size) -> void * {
+	auto *ptr = allocate(size);
+	if (ptr == nullptr) {
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+auto operator new[](size_t size) -> void * {
+	return operator new(size);
+}
+
+auto operator new(size_t size, const std::nothrow_t & /*tag*/) noexcept -> void * {
+	return allocate(size);
+}
+
+auto operator new[](size_t size, const std::nothrow_t & /*tag*/) noexcept -> void * {
+	return allocate(size);
+}
+
+auto operator new(size_t size, std::align_val_t alignment) -> void * {
+	auto *ptr = allocateAligned(size, alignment);
+	if (ptr == nullptr) {
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+auto operator new[](size_t size, std::align_val_t alignment) -> void * {
+	return operator new(size, alignment);
+}
+
+auto operator new(size_t size, std::align_val_t alignment, const std::nothrow_t & /*tag*/) noexcept -> void * {
+	return allocateAligned(size, alignment);
+}
+
+auto operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t & /*tag*/) noexcept -> void * {
+	return allocateAligned(size, alignment);
+}
+
+auto operator delete(void *ptr) noexcept -> void {
+	std::free(ptr);
+}
+
+auto operator delete[](void *ptr) noexcept -> void {
+	std::free(ptr);
+}
+
+auto operator delete(void *ptr, size_t /*size*/) noexcept -> void {
+	std::free(ptr);
+}
+
+auto operator delete[](void *ptr, size_t /*size*/) noexcept -> void {
+	std::free(ptr);
+}
+
+auto operator delete(void *ptr, const std::nothrow_t & /*tag*/) noexcept -> void {
+	std::free(ptr);
+}
+
+auto operator delete[](void *ptr, const std::nothrow_t & /*tag*/) noexcept -> void {
+	std::free(ptr);
+}
+
+auto operator delete(void *ptr, std::align_val_t /*alignment*/) noexcept -> void {
+	deallocateAligned(ptr);
+}
+
+auto operator delete[](void *ptr, std::align_val_t /*alignment*/) noexcept -> void {
+	deallocateAligned(ptr);
+}
+
+auto operator delete(void *ptr, size_t /*size*/, std::align_val_t /*alignment*/) noexcept -> void {
+	deallocateAligned(ptr);
+}
+
+auto operator delete[](void *ptr, size_t /*size*/, std::align_val_t /*alignment*/) noexcept -> void {
+	deallocateAligned(ptr);
+}
+
+auto operator delete(void *ptr, std::align_val_t /*alignment*/, const std::nothrow_t & /*tag*/) noexcept -> void {
+	deallocateAligned(ptr);
+}
+
+auto operator delete[](void *ptr, std::align_val_t /*alignment*/, const std::nothrow_t & /*tag*/) noexcept -> void {
+	deallocateAligned(ptr);
+}
+// NOLINTEND(cppcoreguidelines-no-malloc, hicpp-no-malloc)
@@ -0,0 +1,284 @@
+#include "catalog.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "csv_handling.hpp"
+#include "dicts.hpp"
+#include "profiler.hpp"
+#include "spdlog/spdlog.h"
+#include "thread_pool.hpp"
+#include "utility.hpp"
+#include "uuid_generator.hpp"
+
+namespace {
+	struct file_index_t {
+		std::optional<catalog_file_t> file{};
+		std::vector<csv_column_t> header{};
+	};
+
+	auto indexFile(const std::filesystem::path &path) -> file_index_t {
+		const auto range = readTimeRange(path);
+		auto header = readCSVHeader(path);
+
+		if (!range.has_value() || header.empty()) {
+			spdlog::warn("Skipping file without header or dates: {}", path.filename().string());
+			return {};
+		}
+
+		std::error_code ec{};
+		const auto size = std::filesystem::file_size(path, ec);
+
+		// files out of order are not supported, their range is at least kept valid
+		return {.file = catalog_file_t{.path = path,
+									   .size = ec ? 0 : size,
+									   .first = std::min(range->first, range->second),
+									   .last = std::max(range->first, range->second)},
+				.header = std::move(header)};
+	}
+
+	// files which could not be read have no columns at all
+	auto appendSamples(std::vector<time_t> &timestamps, std::vector<double> &values, const catalog_samples_t &samples,
+					   size_t col) -> void {
+		if (col >= samples.columns.size()) {
+			return;
+		}
+
+		for (const auto &[date, value] : samples.columns[col]) {
+			if (timestamps.empty() || date > timestamps.back()) {
+				timestamps.push_back(date);
+				values.push_back(value);
+			}
+		}
+	}
+
+	auto finalizeColumn(data_dict_t &dict) -> void {
+		const auto &timestamps = *dict.timestamp;
+
+		const auto is_boolean = !dict.data->empty() &&
+								std::ranges::all_of(*dict.data, [](double v) { return v == 0 || v == 1; });
+		dict.data_type = is_boolean ? data_type_t::BOOLEAN : data_type_t::FLOAT;
+
+		std::vector<time_t> time_deltas{};
+		time_deltas.reserve(timestamps.size());
+
+		for (size_t i = 1; i < timestamps.size(); ++i) {
+			time_deltas.push_back(timestamps[i] - timestamps[i - 1]);
+		}
+
+		dict.delta_t = calculateMedian(time_deltas);
+	}
+}  // namespace
+
+auto catalog_t::getOverlapping(time_t from, time_t to) const -> std::vector<size_t> {
+	std::vector<size_t> overlapping{};
+
+	// files are sorted by their first date only, any earlier one may still reach into the range
+	for (size_t i = 0; i < this->files.size() && this->files[i].first <= to; ++i) {
+		if (this->files[i].last >= from) {
+			overlapping.push_back(i);
+		}
+	}
+
+	return overlapping;
+}
+
+auto buildCatalog(const std::vector<std::filesystem::path> &paths, progress_counter_t &finished,
+				  const cancellation_token_t &stop_loading) -> catalog_t {
+	const profiler::ScopedTimer timer{profiler::stage::catalog};
+	std::vector<file_index_t> indexes(paths.size());
+
+	ThreadPool::getInstance().parallelFor(task_priority_t::loading, paths.size(), [&](size_t i) {
+		if (stop_loading) {
+			return;
+		}
+
+		try {
+			indexes[i] = indexFile(paths[i]);
+		} catch (const std::exception &e) {
+			spdlog::error("error indexing {}: {}", paths[i].string(), e.what());
+		}
+
+		finished.fetch_add(1, std::memory_order_relaxed);
+	});
+
+	catalog_t catalog{};
+
+	if (stop_loading) {
+		return catalog;
+	}
+
+	std::erase_if(indexes, [](const auto &e) { return !e.file.has_value(); });
+	std::ranges::stable_sort(indexes, {}, [](const auto &e) { return e.file->first; });
+
+	std::unordered_map<std::string, size_t> column_indexes{};
+
+	for (auto &index : indexes) {
+		auto &file = catalog.files.emplace_back(std::move(*index.file));
+
+		for (const auto &col : index.header) {
+			const auto [it, inserted] = column_indexes.try_emplace(col.header, catalog.columns.size());
+			if (inserted) {
+				catalog.columns.push_back(col);
+				catalog.uuids.push_back(uuids::to_string(UUIDGenerator::getInstance().generate()));
+			}
+
+			file.columns.push_back(it->second);
+		}
+	}
+
+	spdlog::info("Indexed {} files with {} columns", catalog.files.size(), catalog.columns.size());
+
+	return catalog;
+}
+
+auto catalog_samples_t::getMemoryUsage() const -> size_t {
+	size_t total = this->columns.capacity() * sizeof(this->columns.front());
+
+	for (const auto &col : this->columns) {
+		total += col.capacity() * sizeof(col.front());
+	}
+
+	return total;
+}
+
+auto readCatalogFile(const catalog_t &catalog, size_t file, bool keep_rows, const cancellation_token_t &stop_loading)
+	-> catalog_file_read_t {
+	const auto &entry = catalog.files[file];
+	const auto column_count = catalog.columns.size();
+	const auto interval = std::max<time_t>(1, fastCeil<time_t>(entry.last - entry.first + 1,
+															   static_cast<time_t>(catalog_summary_points)));
+
+	struct bucket_t {
+		double sum{0.0};
+		size_t count{0};
+	};
+
+	catalog_file_read_t read{};
+	read.rows.columns.resize(keep_rows ? column_count : 0);
+	read.summary.columns.resize(column_count);
+
+	std::vector<size_t> columns{};
+	std::vector<std::vector<bucket_t>> buckets(column_count);
+
+	// the header is read again, the file may have been changed since it was indexed
+	const auto on_header = [&catalog, &columns](const std::vector<csv_column_t> &header) {
+		for (const auto &col : header) {
+			const auto it = std::ranges::find(catalog.columns, col.header, &csv_column_t::header);
+			columns.push_back(static_cast<size_t>(it - catalog.columns.begin()));
+		}
+	};
+
+	const auto on_row = [&](time_t date, std::span<const double> row) {
+		const auto bucket = static_cast<size_t>(std::clamp<time_t>(
+			(date - entry.first) / interval, 0, static_cast<time_t>(catalog_summary_points) - 1));
+
+		for (size_t i = 0; i < row.size(); ++i) {
+			if (std::isnan(row[i]) || columns[i] >= column_count) {
+				continue;
+			}
+
+			if (keep_rows) {
+				read.rows.columns[columns[i]].emplace_back(date, row[i]);
+			}
+
+			auto &column_buckets = buckets[columns[i]];
+			if (column_buckets.empty()) {
+				column_buckets.resize(catalog_summary_points);
+			}
+
+			column_buckets[bucket].sum += row[i];
+			++column_buckets[bucket].count;
+		}
+	};
+
+	{
+		const profiler::ScopedTimer timer{profiler::stage::load_csv, entry.path.filename().string()};
+		readCSV(entry.path, stop_loading, on_header, on_row);
+	}
+
+	for (auto &rows : read.rows.columns) {
+		if (!std::ranges::is_sorted(rows, {}, &std::pair<time_t, double>::first)) {
+			std::ranges::stable_sort(rows, {}, &std::pair<time_t, double>::first);
+		}
+	}
+
+	for (size_t col = 0; col < column_count; ++col) {
+		for (size_t i = 0; i < buckets[col].size(); ++i) {
+			if (buckets[col][i].count > 0) {
+				const auto date = entry.first + (static_cast<time_t>(i) * interval) + (interval / 2);
+				read.summary.columns[col].emplace_back(
+					date, buckets[col][i].sum / static_cast<double>(buckets[col][i].count));
+			}
+		}
+	}
+
+	return read;
+}
+
+auto assembleCatalog(const catalog_t &catalog, const catalog_sources_t &sources, task_priority_t priority)
+	-> std::pair<std::vector<data_dict_t>, catalog_layout_t> {
+	const auto column_count = catalog.columns.size();
+	const auto file_count = catalog.files.size();
+
+	std::vector<data_dict_t> columns(column_count);
+	catalog_layout_t layout(column_count, std::vector<catalog_slice_t>(file_count));
+
+	ThreadPool::getInstance().parallelFor(priority, column_count, [&](size_t col) {
+		auto &dict = columns[col];
+		dict.name = catalog.columns[col].name;
+		dict.unit = catalog.columns[col].unit;
+		dict.uuid = catalog.uuids[col];
+		dict.updateIDs();
+
+		auto &timestamps = *dict.timestamp;
+		auto &values = *dict.data;
+
+		for (size_t file = 0; file < file_count; ++file) {
+			auto &slice = layout[col][file];
+			slice.offset = timestamps.size();
+
+			if (const auto it = sources.new_rows.find(file); it != sources.new_rows.end()) {
+				appendSamples(timestamps, values, it->second, col);
+				slice.loaded = true;
+			} else if (file < sources.keep_loaded.size() && sources.keep_loaded[file] &&
+					   col < sources.layout.size() && col < sources.previous.size() &&
+					   sources.layout[col][file].loaded) {
+				const auto &previous = sources.previous[col];
+				const auto &old = sources.layout[col][file];
+
+				for (size_t i = old.offset; i < old.offset + old.count; ++i) {
+					if (timestamps.empty() || (*previous.timestamp)[i] > timestamps.back()) {
+						timestamps.push_back((*previous.timestamp)[i]);
+						values.push_back((*previous.data)[i]);
+					}
+				}
+
+				slice.loaded = true;
+			} else if (file < sources.summaries.size() && sources.summaries[file] != nullptr) {
+				appendSamples(timestamps, values, *sources.summaries[file], col);
+			}
+
+			slice.count = timestamps.size() - slice.offset;
+		}
+
+		timestamps.shrink_to_fit();
+		values.shrink_to_fit();
+		finalizeColumn(dict);
+	});
+
+	return {std::move(columns), std::move(layout)};
+}
@@ -0,0 +1,475 @@
+#include "catalog_panel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "catalog.hpp"
+#include "derived_columns.hpp"
+#include "dicts.hpp"
+#include "fmt/chrono.h"
+#include "fmt/format.h"
+#include "global_state.hpp"
+#include "imgui.h"
+#include "imgui_extensions.hpp"
+#include "memory_usage.hpp"
+#include "spdlog/spdlog.h"
+#include "thread_pool.hpp"
+#include "window_context.hpp"
+
+namespace {
+	// files summarized per job while nothing needs to be loaded
+	constexpr auto summary_batch_size = 16uz;
+
+	auto formatDate(time_t timestamp) -> std::string {
+		return fmt::format("{:%Y-%m-%d %H:%M:%S}", std::chrono::sys_seconds{std::chrono::seconds{timestamp}});
+	}
+
+	auto isBusy(const catalog_state_t &state) -> bool {
+		return state.job.valid() && state.job.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+	}
+
+	auto getLoadedBytes(const catalog_state_t &state) -> size_t {
+		return std::transform_reduce(state.tiles.begin(), state.tiles.end(), 0uz, std::plus{},
+									 [](const auto &e) { return e.second.bytes; });
+	}
+
+	auto getSummarizedCount(const catalog_state_t &state) -> size_t {
+		return static_cast<size_t>(std::ranges::count_if(state.summaries, [](const auto &e) { return e != nullptr; }));
+	}
+
+	/**
+	 * The catalog columns with samples replace all columns of the window, visibility and derived columns are kept.
+	 * Columns keep their uuid while their samples change with every loaded or evicted file, so the panels are told to
+	 * drop what they built from the previous samples.
+	 */
+	auto installColumns(WindowContext &window_context, const catalog_state_t &state) -> void {
+		const auto &previous = window_context.getData();
+		std::vector<data_dict_t> data{};
+		std::vector<std::string> replaced{};
+
+		for (const auto &col : state.columns) {
+			if (col.data->empty()) {
+				continue;
+			}
+
+			auto &copy = data.emplace_back(col);
+			const auto it = std::ranges::find(previous, col.uuid, &data_dict_t::uuid);
+			copy.visible = it != previous.end() && it->visible;
+
+			if (it != previous.end() && it->data != col.data) {
+				replaced.push_back(col.uuid);
+			}
+		}
+
+		for (const auto &col : previous) {
+			if (col.derived != nullptr) {
+				invalidateDerivedColumn(data.emplace_back(col));
+				replaced.push_back(col.uuid);
+			}
+		}
+
+		if (previous.empty() && !data.empty()) {
+			data.front().visible = true;
+		}
+
+		window_context.forgetColumns(replaced);
+		window_context.setData(std::move(data));
+	}
+
+	auto checkForFinishedIndex(catalog_state_t &state) -> void {
+		if (!state.index_job.valid() || state.isIndexing()) {
+			return;
+		}
+
+		auto catalog = std::make_shared<const catalog_t>(state.index_job.get());
+		state.summaries.assign(catalog->files.size(), nullptr);
+
+		if (catalog->files.empty()) {
+			spdlog::warn("No files with a header and dates found in the catalog");
+		}
+
+		state.catalog = std::move(catalog);
+	}
+
+	auto checkForFinishedJob(WindowContext &window_context, catalog_state_t &state) -> void {
+		if (!state.job.valid() || isBusy(state)) {
+			return;
+		}
+
+		auto result = state.job.get();
+
+		for (size_t i = 0; i < result.summarized.size(); ++i) {
+			state.summaries[result.summarized[i]] = std::move(result.summaries[i]);
+		}
+
+		for (const auto &file : result.evicted) {
+			state.tiles.erase(file);
+		}
+
+		for (const auto &file : result.loaded) {
+			state.tiles[file].last_used = state.frame;
+		}
+
+		state.columns = std::move(result.columns);
+		state.layout = std::move(result.layout);
+
+		// overlapping rows are dropped while assembling, the tiles are accounted with what was actually kept
+		for (auto &[file, tile] : state.tiles) {
+			tile.bytes = 0;
+			for (const auto &slices : state.layout) {
+				tile.bytes += slices[file].count * (sizeof(time_t) + sizeof(double));
+			}
+		}
+
+		installColumns(window_context, state);
+	}
+
+	struct catalog_work_t {
+		std::vector<size_t> load{};
+		std::vector<size_t> summarize{};
+		std::vector<size_t> evict{};
+
+		[[nodiscard]] auto empty() const -> bool {
+			return this->load.empty() && this->summarize.empty() && this->evict.empty();
+		}
+	};
+
+	auto planWork(WindowContext &window_context, catalog_state_t &state) -> catalog_work_t {
+		const auto &catalog = *state.catalog;
+		const auto budget = static_cast<size_t>(std::max(state.memory_budget_mib, 0)) * 1024 * 1024;
+		catalog_work_t work{};
+
+		std::vector<size_t> visible{};
+		if (!window_context.getData().empty()) {
+			const auto [x_min, x_max] = window_context.getVisibleXRange();
+			visible = catalog.getOverlapping(static_cast<time_t>(std::floor(x_min)),
+											 static_cast<time_t>(std::ceil(x_max)));
+		}
+
+		// files not loaded yet are estimated by their size, the text of a sample takes about as much as its value
+		size_t visible_bytes{0};
+		for (const auto &file : visible) {
+			if (const auto it = state.tiles.find(file); it != state.tiles.end()) {
+				it->second.last_used = state.frame;
+				visible_bytes += it->second.bytes;
+			} else {
+				visible_bytes += catalog.files[file].size;
+				work.load.push_back(file);
+			}
+		}
+
+		state.over_budget = visible_bytes > budget;
+		if (state.over_budget) {
+			work.load.clear();
+		}
+
+		size_t required_bytes = getLoadedBytes(state);
+		for (const auto &file : work.load) {
+			required_bytes += catalog.files[file].size;
+		}
+
+		std::vector<std::pair<uint64_t, size_t>> candidates{};
+		for (const auto &[file, tile] : state.tiles) {
+			if (tile.last_used != state.frame) {
+				candidates.emplace_back(tile.last_used, file);
+			}
+		}
+
+		std::ranges::sort(candidates);
+
+		for (const auto &[last_used, file] : candidates) {
+			if (required_bytes <= budget) {
+				break;
+			}
+
+			required_bytes -= std::min(required_bytes, state.tiles[file].bytes);
+			work.evict.push_back(file);
+		}
+
+		if (work.load.empty() && work.evict.empty()) {
+			for (size_t file = 0; file < state.summaries.size() && work.summarize.size() < summary_batch_size; ++file) {
+				if (state.summaries[file] == nullptr) {
+					work.summarize.push_back(file);
+				}
+			}
+		}
+
+		return work;
+	}
+
+	auto startJob(const catalog_state_t &state, catalog_work_t work) -> std::future<catalog_job_result_t> {
+		std::vector<bool> keep_loaded(state.catalog->files.size(), false);
+		for (const auto &[file, tile] : state.tiles) {
+			keep_loaded[file] = std::ranges::find(work.evict, file) == work.evict.end();
+		}
+
+		// only summarizing is done ahead of time, loads are waited for
+		const auto priority = work.load.empty() ? task_priority_t::prefetch : task_priority_t::loading;
+
+		// the columns only share their sample buffers with the window, which never modifies them
+		auto task = [catalog = state.catalog, control = state.control, summaries = state.summaries,
+					 previous = state.columns, layout = state.layout, keep_loaded = std::move(keep_loaded),
+					 work = std::move(work), priority]() mutable {
+			catalog_job_result_t result{};
+			result.evicted = std::move(work.evict);
+
+			std::vector<std::pair<size_t, bool>> reads{};
+			std::ranges::transform(work.load, std::back_inserter(reads), [](size_t f) { return std::pair{f, true}; });
+			std::ranges::transform(work.summarize, std::back_inserter(reads),
+								   [](size_t f) { return std::pair{f, false}; });
+
+			std::vector<catalog_file_read_t> read(reads.size());
+			ThreadPool::getInstance().parallelFor(priority, reads.size(), [&](size_t i) {
+				const auto [file, keep_rows] = reads[i];
+
+				try {
+					read[i] = readCatalogFile(*catalog, file, keep_rows, control->cancelled);
+				} catch (const std::exception &e) {
+					spdlog::error("error reading {}: {}", catalog->files[file].path.string(), e.what());
+				}
+			});
+
+			std::map<size_t, catalog_samples_t> new_rows{};
+
+			for (size_t i = 0; i < reads.size(); ++i) {
+				const auto file = reads[i].first;
+				auto summary = std::make_shared<const catalog_samples_t>(std::move(read[i].summary));
+
+				summaries[file] = summary;
+				result.summarized.push_back(file);
+				result.summaries.push_back(std::move(summary));
+
+				if (reads[i].second) {
+					new_rows.emplace(file, std::move(read[i].rows));
+					result.loaded.push_back(file);
+				}
+			}
+
+			if (!control->cancelled) {
+				std::tie(result.columns, result.layout) = assembleCatalog(
+					*catalog, {.previous = previous,
+							   .layout = layout,
+							   .keep_loaded = keep_loaded,
+							   .new_rows = new_rows,
+							   .summaries = summaries},
+					priority);
+			}
+
+			AppState::getInstance().wakeMainLoop();
+			return result;
+		};
+
+		return ThreadPool::getInstance().submit(priority, std::move(task));
+	}
+
+	auto zoomToFile(WindowContext &window_context, const catalog_file_t &file) -> void {
+		const auto x_min = static_cast<double>(file.first);
+		const auto x_max = static_cast<double>(file.last);
+
+		if (window_context.getGlobalXLink()) {
+			AppState::getInstance().global_link = {x_min, x_max};
+		}
+
+		window_context.requestXRange(x_min, x_max);
+	}
+
+	auto drawFiles(WindowContext &window_context, const catalog_state_t &state) -> void {
+		const auto &catalog = *state.catalog;
+
+		static constexpr auto table_flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY |
+											ImGuiTableFlags_Resizable;
+
+		if (!ImGui::BeginTable("##files", 5, table_flags)) {
+			return;
+		}
+
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("File");
+		ImGui::TableSetupColumn("First");
+		ImGui::TableSetupColumn("Last");
+		ImGui::TableSetupColumn("Size");
+		ImGui::TableSetupColumn("State");
+		ImGui::TableHeadersRow();
+
+		ImGuiListClipper clipper;
+		clipper.Begin(static_cast<int>(catalog.files.size()));
+
+		while (clipper.Step()) {
+			for (auto i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+				const auto index = static_cast<size_t>(i);
+				const auto &file = catalog.files[index];
+				const auto tile = state.tiles.find(index);
+
+				ImGui::PushID(i);
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+
+				if (ImGui::Selectable(file.path.filename().string().c_str(), tile != state.tiles.end(),
+									  ImGuiSelectableFlags_SpanAllColumns)) {
+					zoomToFile(window_context, file);
+				}
+
+				ImGui::TableNextColumn();
+				ImGuiExt::TextUnformatted(formatDate(file.first));
+				ImGui::TableNextColumn();
+				ImGuiExt::TextUnformatted(formatDate(file.last));
+				ImGui::TableNextColumn();
+				ImGuiExt::TextUnformatted(formatBytes(file.size));
+				ImGui::TableNextColumn();
+
+				if (tile != state.tiles.end()) {
+					ImGuiExt::TextFormatted("loaded, {}", formatBytes(tile->second.bytes));
+				} else if (state.summaries[index] != nullptr) {
+					ImGuiExt::TextFormattedDisabled("summary");
+				} else {
+					ImGuiExt::TextFormattedDisabled("indexed");
+				}
+
+				ImGui::PopID();
+			}
+		}
+
+		ImGui::EndTable();
+	}
+}  // namespace
+
+auto catalog_state_t::getMemoryUsage() const -> size_t {
+	using tile_node_t = std::pair<const size_t, catalog_tile_t>;
+
+	auto sum = (this->summaries.capacity() * sizeof(this->summaries.front())) +
+			   (this->layout.capacity() * sizeof(this->layout.front())) +
+			   (this->tiles.size() * (sizeof(tile_node_t) + (3 * sizeof(void *))));
+
+	for (const auto &summary : this->summaries) {
+		if (summary != nullptr) {
+			sum += sizeof(catalog_samples_t) + summary->getMemoryUsage();
+		}
+	}
+
+	for (const auto &slices : this->layout) {
+		sum += slices.capacity() * sizeof(catalog_slice_t);
+	}
+
+	if (this->catalog != nullptr) {
+		sum += sizeof(catalog_t) + (this->catalog->files.capacity() * sizeof(catalog_file_t));
+
+		for (const auto &file : this->catalog->files) {
+			sum += file.columns.capacity() * sizeof(size_t);
+		}
+	}
+
+	return sum;
+}
+
+auto openCatalog(WindowContext &window_context, const std::vector<std::filesystem::path> &paths) -> void {
+	auto &state = window_context.getCatalogStateRef();
+
+	if (paths.empty()) {
+		return;
+	}
+
+	window_context.setWindowTitle(paths.size() > 1 ? paths.front().parent_path().filename().string()
+												   : paths.front().filename().string());
+
+	state.paths = paths;
+	state.control = std::make_shared<task_control_t>();
+	state.index_job = ThreadPool::getInstance().submit(task_priority_t::loading, [paths, control = state.control]() {
+		catalog_t catalog{};
+		try {
+			catalog = buildCatalog(paths, control->finished, control->cancelled);
+		} catch (const std::exception &e) {
+			spdlog::error("error indexing {}: {}", paths.front().string(), e.what());
+		}
+
+		AppState::getInstance().wakeMainLoop();
+		return catalog;
+	});
+}
+
+auto updateCatalog(WindowContext &window_context) -> void {
+	auto &state = window_context.getCatalogStateRef();
+
+	if (!state.isCatalog()) {
+		return;
+	}
+
+	checkForFinishedIndex(state);
+
+	if (state.catalog == nullptr) {
+		return;
+	}
+
+	checkForFinishedJob(window_context, state);
+
+	if (state.job.valid()) {
+		return;
+	}
+
+	++state.frame;
+
+	if (auto work = planWork(window_context, state); !work.empty()) {
+		state.job = startJob(state, std::move(work));
+	}
+}
+
+auto openCatalogWindow(WindowContext &window_context) -> void {
+	window_context.getCatalogStateRef().open = true;
+}
+
+auto drawCatalogWindow(WindowContext &window_context) -> void {
+	auto &state = window_context.getCatalogStateRef();
+
+	if (!state.open || state.catalog == nullptr) {
+		return;
+	}
+
+	const auto title = fmt::format("Catalog - {}##catalog{}", window_context.getWindowTitle(),
+								   window_context.getUUID());
+
+	ImGui::SetNextWindowSize(ImVec2(800, 400), ImGuiCond_FirstUseEver);
+	if (!ImGui::Begin(title.c_str(), &state.open)) {
+		ImGui::End();
+		return;
+	}
+
+	const auto file_count = state.catalog->files.size();
+	const auto summarized = getSummarizedCount(state);
+
+	ImGuiExt::TextFormatted("{} files, {} columns, {} loaded ({})", file_count, state.catalog->columns.size(),
+							state.tiles.size(), formatBytes(getLoadedBytes(state)));
+
+	if (summarized < file_count) {
+		const auto progress = static_cast<float>(summarized) / static_cast<float>(file_count);
+		const auto label = fmt::format("Overview {}/{}", summarized, file_count);
+		ImGui::ProgressBar(progress, ImVec2(-1.0f, 0.0f), label.c_str());
+	}
+
+	ImGui::SetNextItemWidth(120.0f);
+	if (ImGui::InputInt("Memory budget [MiB]", &state.memory_budget_mib, 256, 1024)) {
+		state.memory_budget_mib = std::max(state.memory_budget_mib, 64);
+	}
+
+	if (state.over_budget) {
+		ImGui::SameLine();
+		ImGuiExt::TextFormattedDisabled("zoom in to load the visible files");
+	}
+
+	drawFiles(window_context, state);
+
+	ImGui::End();
+}
@@ -0,0 +1,327 @@
+#include "cli_commands.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "column_statistics.hpp"
+#include "csv_handling.hpp"
+#include "cxxopts.hpp"
+#include "data_export.hpp"
+#include "dicts.hpp"
+#include "fmt/chrono.h"
+#include "fmt/format.h"
+#include "profiler.hpp"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "spdlog/spdlog.h"
+#include "string_helpers.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+	enum class output_format_t : uint8_t {
+		CSV,
+		JSON
+	};
+
+	auto formatTimestamp(time_t timestamp) -> std::string {
+		return fmt::format("{:%Y-%m-%d %H:%M:%S}", std::chrono::sys_seconds{std::chrono::seconds{timestamp}});
+	}
+
+	auto getTypeName(data_type_t type) -> std::string_view {
+		return type == data_type_t::BOOLEAN ? "boolean" : "float";
+	}
+
+	auto writeStatisticsCSV(std::ostream &out, const std::vector<column_statistics_t> &statistics) -> void {
+		out << "name,unit,type,count,min,max,mean,std,delta_t,gaps,first,last\n";
+
+		for (const auto &s : statistics) {
+			out << fmt::format("{},{},{},{},{},{},{},{},{},{},{},{}\n", escapeCSV(s.name), escapeCSV(s.unit),
+							   getTypeName(s.getDataType()), s.count, s.min, s.max, s.mean, s.getStd(), s.getDeltaT(),
+							   s.getGapCount(), formatTimestamp(s.first_timestamp),
+							   formatTimestamp(s.last_timestamp));
+		}
+	}
+
+	auto writeStatisticsJSON(std::ostream &out, const std::vector<column_statistics_t> &statistics) -> void {
+		out << "[";
+
+		for (bool first = true; const auto &s : statistics) {
+			out << fmt::format(
+				"{}\n  {{\"name\": \"{}\", \"unit\": \"{}\", \"type\": \"{}\", \"count\": {}, \"min\": {}, \"max\": {}, "
+				"\"mean\": {}, \"std\": {}, \"delta_t\": {}, \"gaps\": {}, \"first\": \"{}\", \"last\": \"{}\"}}",
+				first ? "" : ",", escapeJSON(s.name), escapeJSON(s.unit), getTypeName(s.getDataType()), s.count, s.min,
+				s.max, s.mean, s.getStd(), s.getDeltaT(), s.getGapCount(), formatTimestamp(s.first_timestamp),
+				formatTimestamp(s.last_timestamp));
+			first = false;
+		}
+
+		out << "\n]\n";
+	}
+
+	auto parseOutputFormat(const std::string &format) -> output_format_t {
+		if (format == "csv") {
+			return output_format_t::CSV;
+		}
+
+		if (format == "json") {
+			return output_format_t::JSON;
+		}
+
+		throw std::runtime_error(fmt::format("Unknown output format \"{}\", expected csv or json", format));
+	}
+
+	auto getPaths(const cxxopts::ParseResult &result) -> std::vector<std::filesystem::path> {
+		std::vector<std::filesystem::path> paths{};
+
+		if (result.count("path") != 0u) {
+			for (const auto &path : result["path"].as<std::vector<std::string>>()) {
+				paths.emplace_back(path);
+			}
+		}
+
+		return preparePaths(paths);
+	}
+
+	auto parseTimestamp(const std::string &str) -> time_t {
+		size_t prefered_fmt{0};
+		return parseDate(str, prefered_fmt);
+	}
+
+	auto runStatsCommand(int argc, char **argv) -> int {
+		cxxopts::Options options("spreadsheet_analyzer stats",
+								 "Print statistics for every column of the given CSV files or folders");
+
+		options.add_options()
+			("h,help", "Print usage")
+			("path", "CSV files or folders to read", cxxopts::value<std::vector<std::string>>(), "PATH")
+			("f,format", "output format, csv or json", cxxopts::value<std::string>()->default_value("csv"), "FORMAT")
+			("o,output", "write to FILE instead of stdout", cxxopts::value<std::string>(), "FILE")
+			("v,verbose", "verbose output")
+			("trace", "write a Chrome/Perfetto trace to FILE", cxxopts::value<std::string>(), "FILE")
+			;
+
+		options.parse_positional({"path"});
+		options.positional_help("PATH...");
+		const auto result = options.parse(argc, argv);
+
+		if (result.count("help") != 0u) {
+			std::cout << options.help() << '\n';
+			return EXIT_SUCCESS;
+		}
+
+		if (result.count("verbose") != 0u) {
+			spdlog::set_level(spdlog::level::debug);
+		}
+
+		const auto format = parseOutputFormat(result["format"].as<std::string>());
+
+		const auto files = getPaths(result);
+
+		if (files.empty()) {
+			spdlog::error("No files given");
+			return EXIT_FAILURE;
+		}
+
+		if (result.count("trace") != 0u) {
+			profiler::setThreadName("main");
+			profiler::startTrace(result["trace"].as<std::string>());
+		}
+
+		spdlog::debug("Reading {} files...", files.size());
+		const auto statistics = calculateColumnStatistics(files);
+
+		std::ofstream file{};
+		if (result.count("output") != 0u) {
+			file.open(result["output"].as<std::string>());
+
+			if (!file) {
+				spdlog::error("Failed to open {}", result["output"].as<std::string>());
+				profiler::stopTrace();
+				return EXIT_FAILURE;
+			}
+		}
+
+		auto &out = file.is_open() ? static_cast<std::ostream &>(file) : std::cout;
+
+		switch (format) {
+		case output_format_t::CSV:
+			writeStatisticsCSV(out, statistics);
+			break;
+		case output_format_t::JSON:
+			writeStatisticsJSON(out, statistics);
+			break;
+		}
+
+		profiler::stopTrace();
+
+		return out ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	auto runExportCommand(int argc, char **argv) -> int {
+		cxxopts::Options options("spreadsheet_analyzer export",
+								 "Resample columns of the given CSV files or folders onto a common time grid");
+
+		options.add_options()
+			("h,help", "Print usage")
+			("path", "CSV files or folders to read", cxxopts::value<std::vector<std::string>>(), "PATH")
+			("c,columns", "comma separated column names, all columns if omitted",
+				cxxopts::value<std::vector<std::string>>(), "NAMES")
+			("from", "first grid timestamp, e.g. \"2025-01-01 00:00:00\"", cxxopts::value<std::string>(), "DATE")
+			("to", "last grid timestamp", cxxopts::value<std::string>(), "DATE")
+			("i,interval", "grid interval in seconds", cxxopts::value<time_t>()->default_value("60"), "SECONDS")
+			("s,statistic", "mean, min, max or first", cxxopts::value<std::string>()->default_value("mean"), "STAT")
+			("f,format", "output format, csv or binary", cxxopts::value<std::string>()->default_value("csv"),
+				"FORMAT")
+			("o,output", "file to write", cxxopts::value<std::string>(), "FILE")
+			("v,verbose", "verbose output")
+			;
+
+		options.parse_positional({"path"});
+		options.positional_help("PATH...");
+		const auto result = options.parse(argc, argv);
+
+		if (result.count("help") != 0u) {
+			std::cout << options.help() << '\n';
+			return EXIT_SUCCESS;
+		}
+
+		if (result.count("verbose") != 0u) {
+			spdlog::set_level(spdlog::level::debug);
+		}
+
+		if (result.count("output") == 0u) {
+			spdlog::error("No output file given");
+			return EXIT_FAILURE;
+		}
+
+		export_settings_t settings{.interval = result["interval"].as<time_t>()};
+
+		const auto statistic = parseStatistic(result["statistic"].as<std::string>());
+		if (!statistic) {
+			spdlog::error("Unknown statistic \"{}\"", result["statistic"].as<std::string>());
+			return EXIT_FAILURE;
+		}
+		settings.statistic = *statistic;
+
+		const auto format = result["format"].as<std::string>();
+		if (format == "csv") {
+			settings.format = export_format_t::CSV;
+		} else if (format == "binary") {
+			settings.format = export_format_t::BINARY;
+		} else {
+			spdlog::error("Unknown output format \"{}\", expected csv or binary", format);
+			return EXIT_FAILURE;
+		}
+
+		const auto files = getPaths(result);
+
+		if (files.empty()) {
+			spdlog::error("No files given");
+			return EXIT_FAILURE;
+		}
+
+		// nothing outside the grid is needed, so those rows and files are not loaded at all
+		const time_window_t window{
+			.from = result.count("from") != 0u ? std::optional{parseTimestamp(result["from"].as<std::string>())}
+											   : std::nullopt,
+			.to = result.count("to") != 0u ? std::optional{parseTimestamp(result["to"].as<std::string>())}
+										   : std::nullopt};
+
+		progress_counter_t finished_files{0};
+		const cancellation_token_t stop_loading{false};
+		const auto loaded = loadCSVs(files, finished_files, stop_loading, window);
+
+		std::vector<const data_dict_t *> columns{};
+
+		if (result.count("columns") != 0u) {
+			for (const auto &name : result["columns"].as<std::vector<std::string>>()) {
+				const auto it = std::ranges::find_if(loaded.data, [&name](const auto &col) {
+					return col.name == name || fmt::format("{} ({})", col.name, col.unit) == name;
+				});
+
+				if (it == loaded.data.end()) {
+					spdlog::error("Column \"{}\" not found", name);
+					return EXIT_FAILURE;
+				}
+
+				columns.push_back(&*it);
+			}
+		} else {
+			for (const auto &col : loaded.data) {
+				columns.push_back(&col);
+			}
+
+			std::ranges::sort(columns, [](const auto *a, const auto *b) { return a->name < b->name; });
+		}
+
+		auto date_min = std::numeric_limits<time_t>::max();
+		auto date_max = std::numeric_limits<time_t>::lowest();
+
+		for (const auto *col : columns) {
+			if (!col->timestamp->empty()) {
+				date_min = std::min(date_min, col->timestamp->front());
+				date_max = std::max(date_max, col->timestamp->back());
+			}
+		}
+
+		settings.from = window.from.value_or(date_min);
+		settings.to = window.to.value_or(date_max);
+
+		return exportResampled(columns, settings, result["output"].as<std::string>()) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	struct cli_command_t {
+		std::string_view name;
+		int (*run)(int, char **);
+	};
+
+	const auto cli_commands = std::array{
+		cli_command_t{.name = "stats", .run = runStatsCommand},
+		cli_command_t{.name = "export", .run = runExportCommand}
+	};
+}  // namespace
+
+auto isCLICommand(int argc, char **argv) -> bool {
+	if (argc < 2) {
+		return false;
+	}
+
+	const std::string_view name{argv[1]};  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	return std::ranges::any_of(cli_commands, [&name](const auto &command) { return command.name == name; });
+}
+
+auto runCLICommand(int argc, char **argv) -> int {
+	// keep stdout free for the actual output
+	spdlog::set_default_logger(spdlog::stderr_color_mt("cli"));
+
+	const std::string_view name{argv[1]};  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+	for (const auto &command : cli_commands) {
+		if (command.name == name) {
+			try {
+				// the subcommand sees its own name as argv[0]
+				return command.run(argc - 1, argv + 1);  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			} catch (const std::exception &e) {
+				spdlog::critical(e.what());
+				profiler::stopTrace();
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	return EXIT_FAILURE;
+}
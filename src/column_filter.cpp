@@ -0,0 +1,95 @@
+#include "column_filter.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dicts.hpp"
+
+namespace {
+	auto toLower(std::string_view str) -> std::string {
+		std::string ret{str};
+		std::ranges::transform(ret, ret.begin(),
+							   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return ret;
+	}
+}  // namespace
+
+auto ColumnFilter::ensureIndex(const std::vector<data_dict_t> &data, uint64_t data_generation) -> void {
+	if (this->indexed_generation == data_generation) {
+		return;
+	}
+
+	this->indexed_generation = data_generation;
+	this->lowercase_names.clear();
+	this->lowercase_names.reserve(data.size());
+
+	for (const auto &e : data) {
+		this->lowercase_names.push_back(toLower(e.name));
+	}
+
+	this->sorted_indices.resize(data.size());
+	std::iota(this->sorted_indices.begin(), this->sorted_indices.end(), 0uz);
+	std::ranges::sort(this->sorted_indices, [this](size_t a, size_t b) {
+		return this->lowercase_names[a] < this->lowercase_names[b];
+	});
+
+	// the index has changed, so the previous matches can not be narrowed down
+	const auto current_query = this->query;
+	this->query.clear();
+	this->applyQuery(current_query);
+}
+
+auto ColumnFilter::setQuery(std::string_view new_query) -> void {
+	this->applyQuery(toLower(new_query));
+}
+
+auto ColumnFilter::applyQuery(const std::string &new_query) -> void {
+	if (new_query == this->query) {
+		return;
+	}
+
+	const auto is_narrowing = !this->query.empty() && new_query.starts_with(this->query);
+	this->query = new_query;
+
+	if (this->query.empty()) {
+		this->matches.clear();
+		return;
+	}
+
+	if (this->query.front() == '^') {
+		const auto prefix = std::string_view{this->query}.substr(1);
+		const auto first = std::ranges::lower_bound(this->sorted_indices, prefix, std::ranges::less{},
+													[this](size_t i) -> std::string_view {
+														return this->lowercase_names[i];
+													});
+		const auto last = std::find_if(first, this->sorted_indices.end(), [this, prefix](size_t i) {
+			return !this->lowercase_names[i].starts_with(prefix);
+		});
+
+		this->matches.assign(first, last);
+		std::ranges::sort(this->matches);
+		return;
+	}
+
+	const auto is_match = [this](size_t i) {
+		return this->lowercase_names[i].find(this->query) != std::string::npos;
+	};
+
+	if (is_narrowing) {
+		std::erase_if(this->matches, [&is_match](size_t i) { return !is_match(i); });
+		return;
+	}
+
+	this->matches.clear();
+	for (size_t i = 0; i < this->lowercase_names.size(); ++i) {
+		if (is_match(i)) {
+			this->matches.push_back(i);
+		}
+	}
+}
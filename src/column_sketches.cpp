@@ -0,0 +1,156 @@
+#include "column_sketches.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "profiler.hpp"
+#include "quantile_sketch.hpp"
+#include "thread_pool.hpp"
+#include "utility.hpp"
+
+namespace {
+	auto mergeBlocks(std::span<const sketch_block_t> blocks) -> sketch_block_t {
+		sketch_block_t result{};
+
+		for (const auto &block : blocks) {
+			result.digest.merge(block.digest);
+			std::ranges::transform(result.histogram, block.histogram, result.histogram.begin(), std::plus{});
+		}
+
+		result.digest.compress();
+		return result;
+	}
+
+	template <typename T>
+	auto addHistogram(std::array<uint64_t, histogram_bins> &target, const std::array<T, histogram_bins> &source)
+		-> void {
+		for (size_t i = 0; i < histogram_bins; ++i) {
+			target[i] += source[i];
+		}
+	}
+
+	auto addSamples(distribution_t &result, const column_sketches_t &sketches, std::span<const double> values)
+		-> void {
+		for (const auto &e : values) {
+			result.digest.add(e);
+			++result.histogram.at(sketches.getBin(e));
+		}
+	}
+}  // namespace
+
+auto column_sketches_t::getBin(double value) const -> size_t {
+	if (this->max <= this->min) {
+		return 0;
+	}
+
+	const auto position = (value - this->min) / (this->max - this->min) * static_cast<double>(histogram_bins);
+	return static_cast<size_t>(std::clamp(position, 0.0, static_cast<double>(histogram_bins - 1)));
+}
+
+auto column_sketches_t::getBinEdge(size_t bin) const -> double {
+	return this->min + ((this->max - this->min) * static_cast<double>(bin) / static_cast<double>(histogram_bins));
+}
+
+auto column_sketches_t::getMemoryUsage() const -> size_t {
+	const auto block_count = this->blocks.capacity() + this->groups.capacity();
+	auto sum = sizeof(column_sketches_t) + (block_count * sizeof(sketch_block_t));
+
+	for (const auto &block : this->blocks) {
+		sum += block.digest.getMemoryUsage() - sizeof(TDigest);
+	}
+
+	for (const auto &group : this->groups) {
+		sum += group.digest.getMemoryUsage() - sizeof(TDigest);
+	}
+
+	return sum;
+}
+
+auto buildColumnSketches(std::span<const double> values, task_priority_t priority) -> column_sketches_t {
+	const profiler::ScopedTimer timer{profiler::stage::column_sketches};
+
+	column_sketches_t sketches{};
+
+	if (values.empty()) {
+		return sketches;
+	}
+
+	const auto [min, max] = std::ranges::minmax(values);
+	sketches.min = min;
+	sketches.max = max;
+
+	sketches.blocks.resize(fastCeil(values.size(), column_sketches_t::block_size));
+
+	ThreadPool::getInstance().parallelFor(priority, sketches.blocks.size(), [&](size_t i) {
+		const auto first = i * column_sketches_t::block_size;
+		const auto samples = values.subspan(first, std::min(column_sketches_t::block_size, values.size() - first));
+		auto &block = sketches.blocks[i];
+
+		block.digest = TDigest::fromValues(samples);
+		for (const auto &e : samples) {
+			++block.histogram.at(sketches.getBin(e));
+		}
+	});
+
+	sketches.groups.resize(sketches.blocks.size() / column_sketches_t::blocks_per_group);
+
+	ThreadPool::getInstance().parallelFor(priority, sketches.groups.size(), [&](size_t i) {
+		const auto blocks = std::span{sketches.blocks}.subspan(i * column_sketches_t::blocks_per_group,
+																column_sketches_t::blocks_per_group);
+		sketches.groups[i] = mergeBlocks(blocks);
+	});
+
+	return sketches;
+}
+
+auto queryDistribution(std::span<const double> values, const column_sketches_t &sketches, size_t first, size_t last)
+	-> distribution_t {
+	distribution_t result{};
+	last = std::min(last, values.size());
+
+	if (first >= last) {
+		return result;
+	}
+
+	constexpr auto block_size = column_sketches_t::block_size;
+	constexpr auto group_size = column_sketches_t::group_size;
+
+	// raw samples up to the first block boundary, whole blocks up to the first group boundary and so on
+	const auto first_block = fastCeil(first, block_size) * block_size;
+	const auto last_block = (last / block_size) * block_size;
+
+	if (first_block >= last_block) {
+		addSamples(result, sketches, values.subspan(first, last - first));
+		result.digest.compress();
+		return result;
+	}
+
+	addSamples(result, sketches, values.subspan(first, first_block - first));
+	addSamples(result, sketches, values.subspan(last_block, last - last_block));
+
+	const auto first_group = std::min(fastCeil(first_block, group_size) * group_size, last_block);
+	const auto last_group = std::max((last_block / group_size) * group_size, first_group);
+
+	const auto addBlocks = [&](size_t from, size_t to) {
+		for (auto i = from / block_size; i < to / block_size; ++i) {
+			result.digest.merge(sketches.blocks[i].digest);
+			addHistogram(result.histogram, sketches.blocks[i].histogram);
+		}
+	};
+
+	addBlocks(first_block, first_group);
+	addBlocks(last_group, last_block);
+
+	for (auto i = first_group / group_size; i < last_group / group_size; ++i) {
+		result.digest.merge(sketches.groups[i].digest);
+		addHistogram(result.histogram, sketches.groups[i].histogram);
+	}
+
+	result.digest.compress();
+	return result;
+}
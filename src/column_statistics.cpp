@@ -0,0 +1,227 @@
+#include "column_statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "csv_handling.hpp"
+#include "dicts.hpp"
+#include "profiler.hpp"
+#include "spdlog/spdlog.h"
+#include "thread_pool.hpp"
+
+auto column_statistics_t::add(time_t timestamp, double value) -> void {
+	if (this->count == 0) {
+		this->first_timestamp = timestamp;
+		this->last_timestamp = timestamp;
+	} else if (timestamp >= this->last_timestamp) {
+		++this->delta_histogram[timestamp - this->last_timestamp];
+		this->last_timestamp = timestamp;
+	} else {
+		// the GUI sorts the samples, the intervals around this one are unknown without keeping them
+		this->ordered = false;
+		this->first_timestamp = std::min(this->first_timestamp, timestamp);
+	}
+
+	++this->count;
+	this->min = std::min(this->min, value);
+	this->max = std::max(this->max, value);
+
+	// Welford's online algorithm
+	const auto delta = value - this->mean;
+	this->mean += delta / static_cast<double>(this->count);
+	this->m2 += delta * (value - this->mean);
+
+	if (value != 0 && value != 1) {
+		this->is_boolean = false;
+	}
+}
+
+auto column_statistics_t::merge(const column_statistics_t &later) -> void {
+	if (later.count == 0) {
+		return;
+	}
+
+	if (this->count == 0) {
+		*this = later;
+		return;
+	}
+
+	if (later.first_timestamp >= this->last_timestamp) {
+		++this->delta_histogram[later.first_timestamp - this->last_timestamp];
+	} else {
+		// overlapping parts interleave once sorted, which changes the intervals within both of them
+		this->ordered = false;
+	}
+
+	for (const auto &[delta, n] : later.delta_histogram) {
+		this->delta_histogram[delta] += n;
+	}
+
+	// Chan et al. parallel variance update
+	const auto n_a = static_cast<double>(this->count);
+	const auto n_b = static_cast<double>(later.count);
+	const auto n = n_a + n_b;
+	const auto delta = later.mean - this->mean;
+
+	this->mean += delta * n_b / n;
+	this->m2 += later.m2 + (delta * delta * n_a * n_b / n);
+	this->count += later.count;
+
+	this->min = std::min(this->min, later.min);
+	this->max = std::max(this->max, later.max);
+	this->is_boolean = this->is_boolean && later.is_boolean;
+	this->ordered = this->ordered && later.ordered;
+	this->first_timestamp = std::min(this->first_timestamp, later.first_timestamp);
+	this->last_timestamp = std::max(this->last_timestamp, later.last_timestamp);
+}
+
+auto column_statistics_t::getStd() const -> double {
+	if (this->count == 0) {
+		return 0.0;
+	}
+
+	return std::sqrt(this->m2 / static_cast<double>(this->count));
+}
+
+auto column_statistics_t::getDataType() const -> data_type_t {
+	return this->is_boolean ? data_type_t::BOOLEAN : data_type_t::FLOAT;
+}
+
+auto column_statistics_t::getDeltaT() const -> time_t {
+	size_t total{0};
+	for (const auto &[delta, n] : this->delta_histogram) {
+		total += n;
+	}
+
+	if (total == 0) {
+		return 0;
+	}
+
+	// the two middle elements coincide for odd totals
+	const auto lower_rank = (total - 1) / 2;
+	const auto upper_rank = total / 2;
+	time_t lower{0};
+	size_t seen{0};
+
+	for (const auto &[delta, n] : this->delta_histogram) {
+		if (seen <= lower_rank && lower_rank < seen + n) {
+			lower = delta;
+		}
+
+		if (upper_rank < seen + n) {
+			return (lower + delta) / 2;
+		}
+
+		seen += n;
+	}
+
+	return lower;
+}
+
+auto column_statistics_t::getGapCount() const -> size_t {
+	const auto threshold = this->getDeltaT() * 10;
+	size_t gaps{0};
+
+	for (auto it = this->delta_histogram.upper_bound(threshold); it != this->delta_histogram.end(); ++it) {
+		gaps += it->second;
+	}
+
+	return gaps;
+}
+
+auto calculateColumnStatistics(const std::vector<std::filesystem::path> &paths) -> std::vector<column_statistics_t> {
+	struct context {
+		std::filesystem::path path;
+		std::unordered_map<std::string, column_statistics_t> columns{};
+	};
+
+	std::vector<context> contexts{};
+	contexts.reserve(paths.size());
+
+	for (const auto &path : paths) {
+		contexts.push_back({.path = path});
+	}
+
+	const cancellation_token_t stop_loading{false};
+
+	ThreadPool::getInstance().parallelFor(task_priority_t::loading, contexts.size(), [&](size_t i) {
+		auto &ctx = contexts[i];
+		std::vector<column_statistics_t *> columns{};
+
+		const auto on_header = [&ctx, &columns](const std::vector<csv_column_t> &header) {
+			for (const auto &col : header) {
+				auto &stats = ctx.columns[col.header];
+				stats.name = col.name;
+				stats.unit = col.unit;
+				columns.push_back(&stats);
+			}
+		};
+
+		const auto on_row = [&columns](time_t date, std::span<const double> row) {
+			for (size_t col = 0; col < row.size(); ++col) {
+				if (!std::isnan(row[col])) {
+					columns[col]->add(date, row[col]);
+				}
+			}
+		};
+
+		try {
+			const profiler::ScopedTimer timer{profiler::stage::load_csv, ctx.path.filename().string()};
+			readCSV(ctx.path, stop_loading, on_header, on_row);
+		} catch (const std::exception &e) {
+			spdlog::error("{}: {}", ctx.path.string(), e.what());
+		}
+	});
+
+	std::unordered_map<std::string, column_statistics_t> merged{};
+
+	{
+		const profiler::ScopedTimer timer{profiler::stage::merge};
+
+		std::unordered_map<std::string, std::vector<const column_statistics_t *>> parts{};
+		for (const auto &ctx : contexts) {
+			for (const auto &[key, stats] : ctx.columns) {
+				if (stats.count > 0) {
+					parts[key].push_back(&stats);
+				}
+			}
+		}
+
+		// the GUI sorts the merged samples, so the parts are joined in time order instead of the order of the files
+		for (auto &[key, column_parts] : parts) {
+			std::ranges::sort(column_parts, {}, [](const auto *part) {
+				return std::pair{part->first_timestamp, part->last_timestamp};
+			});
+
+			auto &stats = merged[key];
+			for (const auto *part : column_parts) {
+				stats.merge(*part);
+			}
+
+			if (!stats.ordered) {
+				spdlog::warn("samples of {} are not in order, its delta_t and gaps are approximate", stats.name);
+			}
+		}
+	}
+
+	std::vector<column_statistics_t> result{};
+	result.reserve(merged.size());
+
+	for (auto &&[key, stats] : merged) {
+		if (stats.count > 0) {
+			result.push_back(std::move(stats));
+		}
+	}
+
+	std::ranges::sort(result, [](const auto &a, const auto &b) { return a.name < b.name; });
+
+	return result;
+}
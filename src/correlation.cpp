@@ -0,0 +1,240 @@
+#include "correlation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "dicts.hpp"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
+#include "time_join.hpp"
+#include "utility.hpp"
+
+namespace {
+	// keeps the grid below 256 MiB regardless of the number of columns, columns with gaps add a mask of the same size
+	constexpr size_t max_grid_values = 1uz << 25u;
+	constexpr size_t min_samples = 1'024;
+
+	constexpr size_t column_block = 16;
+	constexpr size_t sample_block = 2'048;
+
+	// centered on the mean of the present samples, missing samples are 0 so they add nothing to any sum
+	struct grid_column_t {
+		std::vector<double> values{};
+		std::vector<double> present{};	// 1 for present samples, empty if all are present
+		size_t count{0};
+		double sum_squares{0.0};
+
+		[[nodiscard]] auto hasGaps() const -> bool {
+			return !this->present.empty();
+		}
+	};
+
+	auto prepareColumn(std::vector<double> values) -> grid_column_t {
+		grid_column_t col{};
+		double mean{0.0};
+
+		for (const auto &e : values) {
+			if (!std::isnan(e)) {
+				mean += e;
+				++col.count;
+			}
+		}
+
+		mean /= static_cast<double>(std::max(col.count, 1uz));
+
+		if (col.count < values.size()) {
+			col.present.resize(values.size(), 0.0);
+		}
+
+		for (size_t i = 0; i < values.size(); ++i) {
+			if (std::isnan(values[i])) {
+				values[i] = 0.0;
+				continue;
+			}
+
+			values[i] -= mean;
+			col.sum_squares += values[i] * values[i];
+
+			if (col.hasGaps()) {
+				col.present[i] = 1.0;
+			}
+		}
+
+		col.values = std::move(values);
+		return col;
+	}
+
+	// independent accumulators, the compiler may not reorder a single floating point sum without -ffast-math
+	constexpr size_t lanes = 4;
+
+	auto dot(std::span<const double> a, std::span<const double> b) -> double {
+		std::array<double, lanes> sums{};
+		size_t i = 0;
+
+		for (; i + lanes <= a.size(); i += lanes) {
+			for (size_t k = 0; k < lanes; ++k) {
+				sums[k] += a[i + k] * b[i + k];
+			}
+		}
+
+		for (; i < a.size(); ++i) {
+			sums[0] += a[i] * b[i];
+		}
+
+		return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+	}
+
+	// sum of the squares of a where mask is 1
+	auto maskedSquares(std::span<const double> a, std::span<const double> mask) -> double {
+		std::array<double, lanes> sums{};
+		size_t i = 0;
+
+		for (; i + lanes <= a.size(); i += lanes) {
+			for (size_t k = 0; k < lanes; ++k) {
+				sums[k] += a[i + k] * a[i + k] * mask[i + k];
+			}
+		}
+
+		for (; i < a.size(); ++i) {
+			sums[0] += a[i] * a[i] * mask[i];
+		}
+
+		return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+	}
+
+	// sums over the samples present in both columns, only those not known from the columns alone are accumulated
+	struct pair_sums_t {
+		double count{0.0};
+		double a{0.0};
+		double b{0.0};
+		double aa{0.0};
+		double bb{0.0};
+		double ab{0.0};
+	};
+
+	auto accumulate(const grid_column_t &x, const grid_column_t &y, size_t start, size_t length, pair_sums_t &sums)
+		-> void {
+		const auto chunk = [start, length](const std::vector<double> &e) {
+			return std::span{e}.subspan(start, length);
+		};
+
+		sums.ab += dot(chunk(x.values), chunk(y.values));
+
+		if (y.hasGaps()) {
+			sums.a += dot(chunk(x.values), chunk(y.present));
+			sums.aa += maskedSquares(chunk(x.values), chunk(y.present));
+		}
+
+		if (x.hasGaps()) {
+			sums.b += dot(chunk(y.values), chunk(x.present));
+			sums.bb += maskedSquares(chunk(y.values), chunk(x.present));
+		}
+
+		if (x.hasGaps() && y.hasGaps()) {
+			sums.count += dot(chunk(x.present), chunk(y.present));
+		}
+	}
+
+	// Pearson correlation over the samples present in both columns, NaN if either is constant over them
+	auto correlate(const grid_column_t &x, const grid_column_t &y, const pair_sums_t &sums) -> double {
+		auto count = static_cast<double>(x.values.size());
+		if (x.hasGaps() && y.hasGaps()) {
+			count = sums.count;
+		} else if (x.hasGaps() || y.hasGaps()) {
+			count = static_cast<double>(x.hasGaps() ? x.count : y.count);
+		}
+
+		// columns are centered on their own mean, over all of their samples they sum up to zero
+		const auto a = y.hasGaps() ? sums.a : 0.0;
+		const auto b = x.hasGaps() ? sums.b : 0.0;
+		const auto aa = y.hasGaps() ? sums.aa : x.sum_squares;
+		const auto bb = x.hasGaps() ? sums.bb : y.sum_squares;
+
+		const auto var_a = aa - (a * a / count);
+		const auto var_b = bb - (b * b / count);
+
+		if (count < 2.0 || var_a <= 0.0 || var_b <= 0.0) {
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+
+		return std::clamp((sums.ab - (a * b / count)) / std::sqrt(var_a * var_b), -1.0, 1.0);
+	}
+}  // namespace
+
+auto calculateCorrelationMatrix(std::span<const data_dict_t *const> columns, time_t from, time_t to,
+								task_priority_t priority) -> correlation_matrix_t {
+	const profiler::ScopedTimer timer{profiler::stage::correlation};
+
+	correlation_matrix_t result{};
+	const auto n = columns.size();
+
+	for (const auto *col : columns) {
+		result.uuids.push_back(col->uuid);
+		result.names.push_back(col->name);
+	}
+
+	if (n == 0 || to <= from) {
+		return result;
+	}
+
+	const auto coarsest = std::ranges::max(columns, {}, &data_dict_t::delta_t)->delta_t;
+	const auto max_samples = std::max(max_grid_values / n, min_samples);
+	const auto range = static_cast<size_t>(to - from);
+
+	result.from = from;
+	result.interval = std::max({coarsest, time_t{1}, static_cast<time_t>(fastCeil(range, max_samples))});
+	result.samples = (range / static_cast<size_t>(result.interval)) + 1;
+
+	std::vector<grid_column_t> grid(n);
+
+	ThreadPool::getInstance().parallelFor(priority, n, [&](size_t i) {
+		grid[i] = prepareColumn(sampleOnGrid(*columns[i], from, result.interval, result.samples));
+	});
+
+	// upper triangle of blocks, each block accumulates over the samples in chunks which stay in the cache
+	const auto blocks = fastCeil(n, column_block);
+	std::vector<std::pair<size_t, size_t>> block_pairs{};
+	for (size_t bi = 0; bi < blocks; ++bi) {
+		for (size_t bj = bi; bj < blocks; ++bj) {
+			block_pairs.emplace_back(bi, bj);
+		}
+	}
+
+	result.values.assign(n * n, std::numeric_limits<double>::quiet_NaN());
+
+	ThreadPool::getInstance().parallelFor(priority, block_pairs.size(), [&](size_t b) {
+		const auto [bi, bj] = block_pairs[b];
+		const auto i_end = std::min((bi + 1) * column_block, n);
+		const auto j_end = std::min((bj + 1) * column_block, n);
+
+		std::array<pair_sums_t, column_block * column_block> sums{};
+		const auto slot = [](size_t i, size_t j) { return ((i % column_block) * column_block) + (j % column_block); };
+
+		for (size_t start = 0; start < result.samples; start += sample_block) {
+			const auto length = std::min(sample_block, result.samples - start);
+
+			for (auto i = bi * column_block; i < i_end; ++i) {
+				for (auto j = std::max(bj * column_block, i); j < j_end; ++j) {
+					accumulate(grid[i], grid[j], start, length, sums.at(slot(i, j)));
+				}
+			}
+		}
+
+		for (auto i = bi * column_block; i < i_end; ++i) {
+			for (auto j = std::max(bj * column_block, i); j < j_end; ++j) {
+				const auto r = correlate(grid[i], grid[j], sums.at(slot(i, j)));
+				result.values[(i * n) + j] = r;
+				result.values[(j * n) + i] = r;
+			}
+		}
+	});
+
+	return result;
+}
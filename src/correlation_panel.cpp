@@ -0,0 +1,248 @@
+#include "correlation_panel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "correlation.hpp"
+#include "dicts.hpp"
+#include "fmt/format.h"
+#include "global_state.hpp"
+#include "imgui.h"
+#include "imgui_extensions.hpp"
+#include "implot.h"
+#include "memory_usage.hpp"
+#include "thread_pool.hpp"
+#include "window_context.hpp"
+
+namespace {
+	// tick labels become unreadable beyond this, the tooltip still names every cell
+	constexpr size_t max_labeled_columns = 32;
+	constexpr size_t max_annotated_columns = 12;
+
+	auto isBusy(const correlation_panel_state_t &state) -> bool {
+		return state.job.valid() && state.job.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+	}
+
+	auto calculateInBackground(const std::vector<data_dict_t> &columns, time_t from, time_t to)
+		-> std::shared_ptr<const correlation_matrix_t> {
+		std::vector<const data_dict_t *> pointers{};
+		for (const auto &col : columns) {
+			pointers.push_back(&col);
+		}
+
+		auto result = std::make_shared<const correlation_matrix_t>(calculateCorrelationMatrix(pointers, from, to));
+		AppState::getInstance().wakeMainLoop();
+		return result;
+	}
+
+	auto startCalculation(WindowContext &window_context) -> void {
+		auto &state = window_context.getCorrelationPanelStateRef();
+		if (isBusy(state)) {
+			return;
+		}
+
+		const auto &data = window_context.getData();
+		std::vector<size_t> indices{};
+
+		if (state.all_columns) {
+			for (size_t i = 0; i < data.size(); ++i) {
+				indices.push_back(i);
+			}
+		} else {
+			indices = window_context.getViewState().visible_columns;
+		}
+
+		// only the vectors are shared with the job, the columns themselves may be moved or aggregated meanwhile
+		std::vector<data_dict_t> columns{};
+		for (const auto &i : indices) {
+			const auto &col = data[i];
+			if (col.data_type != data_type_t::FLOAT || col.data->empty()) {
+				continue;
+			}
+
+			auto &copy = columns.emplace_back();
+			copy.name = col.name;
+			copy.uuid = col.uuid;
+			copy.timestamp = col.timestamp;
+			copy.data = col.data;
+			copy.delta_t = col.delta_t;
+		}
+
+		const auto [x_min, x_max] = window_context.getVisibleXRange();
+		const auto from = static_cast<time_t>(std::floor(x_min));
+		const auto to = static_cast<time_t>(std::ceil(x_max));
+
+		state.job = ThreadPool::getInstance().submit(
+			task_priority_t::visible,
+			[columns = std::move(columns), from, to]() { return calculateInBackground(columns, from, to); });
+	}
+
+	auto checkForFinishedCalculation(correlation_panel_state_t &state) -> void {
+		if (!state.job.valid() || isBusy(state)) {
+			return;
+		}
+
+		state.result = state.job.get();
+		state.heatmap = state.result->values;
+		std::ranges::replace_if(state.heatmap, [](double e) { return std::isnan(e); }, 0.0);
+	}
+
+	auto showPair(WindowContext &window_context, const std::string &a, const std::string &b) -> void {
+		for (auto &col : window_context.getData()) {
+			col.visible = col.uuid == a || col.uuid == b;
+		}
+
+		window_context.invalidateViewState();
+	}
+
+	auto drawHeatmap(WindowContext &window_context, const correlation_matrix_t &matrix,
+					 const std::vector<double> &heatmap) -> void {
+		const auto n = matrix.names.size();
+		const auto size = static_cast<double>(n);
+
+		ImPlot::PushColormap(ImPlotColormap_RdBu);
+
+		const auto scale_width = 80.0f;
+		const auto plot_size = ImVec2(ImGui::GetContentRegionAvail().x - scale_width, -1);
+
+		if (ImPlot::BeginPlot("##correlation", plot_size, ImPlotFlags_NoLegend | ImPlotFlags_NoMouseText)) {
+			const auto axis_flags = ImPlotAxisFlags_NoGridLines | ImPlotAxisFlags_NoTickMarks | ImPlotAxisFlags_Lock |
+									(n > max_labeled_columns ? ImPlotAxisFlags_NoTickLabels : 0);
+			ImPlot::SetupAxes(nullptr, nullptr, axis_flags, axis_flags);
+			ImPlot::SetupAxesLimits(0.0, size, 0.0, size, ImGuiCond_Always);
+
+			if (n <= max_labeled_columns) {
+				std::vector<const char *> x_labels{};
+				std::vector<const char *> y_labels{};
+
+				for (size_t i = 0; i < n; ++i) {
+					x_labels.push_back(matrix.names[i].c_str());
+					y_labels.push_back(matrix.names[n - 1 - i].c_str());
+				}
+
+				ImPlot::SetupAxisTicks(ImAxis_X1, 0.5, size - 0.5, static_cast<int>(n), x_labels.data());
+				ImPlot::SetupAxisTicks(ImAxis_Y1, 0.5, size - 0.5, static_cast<int>(n), y_labels.data());
+			}
+
+			// rows are drawn from the top, so row i covers y in [n - i - 1, n - i]
+			const auto *label_format = n <= max_annotated_columns ? "%.2f" : nullptr;
+			const auto count = static_cast<int>(n);
+			ImPlot::PlotHeatmap("##r", heatmap.data(), count, count, -1.0, 1.0, label_format, ImPlotPoint(0, 0),
+								ImPlotPoint(size, size));
+
+			if (ImPlot::IsPlotHovered()) {
+				const auto mouse = ImPlot::GetPlotMousePos();
+
+				if (mouse.x >= 0.0 && mouse.y >= 0.0 && mouse.x < size && mouse.y < size) {
+					const auto col = static_cast<size_t>(mouse.x);
+					const auto row = n - 1 - static_cast<size_t>(mouse.y);
+					const auto r = matrix.at(row, col);
+
+					ImGui::BeginTooltip();
+					ImGuiExt::TextFormatted("{}", matrix.names[row]);
+					ImGuiExt::TextFormatted("{}", matrix.names[col]);
+					if (std::isnan(r)) {
+						ImGui::TextUnformatted("r = n/a (constant)");
+					} else {
+						ImGuiExt::TextFormatted("r = {:.3f}", r);
+					}
+					ImGui::EndTooltip();
+
+					if (ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
+						showPair(window_context, matrix.uuids[row], matrix.uuids[col]);
+					}
+				}
+			}
+
+			ImPlot::EndPlot();
+		}
+
+		ImGui::SameLine();
+		ImPlot::ColormapScale("##scale", -1.0, 1.0, ImVec2(scale_width - ImGui::GetStyle().ItemSpacing.x, -1));
+
+		ImPlot::PopColormap();
+	}
+}  // namespace
+
+auto correlation_panel_state_t::getMemoryUsage() const -> size_t {
+	auto sum = this->heatmap.capacity() * sizeof(double);
+
+	if (this->result != nullptr) {
+		sum += sizeof(correlation_matrix_t) + (this->result->values.capacity() * sizeof(double)) +
+			   ((this->result->uuids.capacity() + this->result->names.capacity()) * sizeof(std::string));
+
+		for (const auto &e : this->result->uuids) {
+			sum += ::getMemoryUsage(e);
+		}
+
+		for (const auto &e : this->result->names) {
+			sum += ::getMemoryUsage(e);
+		}
+	}
+
+	return sum;
+}
+
+auto openCorrelationWindow(WindowContext &window_context) -> void {
+	auto &state = window_context.getCorrelationPanelStateRef();
+	state.open = true;
+
+	if (state.result == nullptr) {
+		startCalculation(window_context);
+	}
+}
+
+auto drawCorrelationWindow(WindowContext &window_context) -> void {
+	auto &state = window_context.getCorrelationPanelStateRef();
+	if (!state.open) {
+		return;
+	}
+
+	checkForFinishedCalculation(state);
+
+	const auto title = fmt::format("Correlation - {}##correlation{}", window_context.getWindowTitle(),
+								   window_context.getUUID());
+
+	ImGui::SetNextWindowSize(ImVec2(600, 600), ImGuiCond_FirstUseEver);
+	if (!ImGui::Begin(title.c_str(), &state.open)) {
+		ImGui::End();
+		return;
+	}
+
+	const auto busy = isBusy(state);
+
+	ImGui::Checkbox("All float columns", &state.all_columns);
+	ImGui::SameLine();
+
+	ImGui::BeginDisabled(busy);
+	if (ImGui::Button("Calculate for visible range")) {
+		startCalculation(window_context);
+	}
+	ImGui::EndDisabled();
+
+	if (busy) {
+		ImGui::SameLine();
+		ImGui::TextDisabled("calculating...");	// NOLINT(hicpp-vararg)
+	}
+
+	if (state.result == nullptr || state.result->names.empty()) {
+		ImGui::End();
+		return;
+	}
+
+	const auto &matrix = *state.result;
+	ImGuiExt::TextFormattedDisabled("{} columns, {} samples every {} s", matrix.names.size(), matrix.samples,
+									matrix.interval);
+
+	window_context.switchToImPlotContext();
+	drawHeatmap(window_context, matrix, state.heatmap);
+
+	ImGui::End();
+}
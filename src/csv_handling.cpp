@@ -3,10 +3,14 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cmath>
 #include <execution>
 #include <filesystem>
+#include <fstream>
 #include <iomanip>
-#include <ranges>
+#include <limits>
+#include <optional>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -18,8 +22,11 @@
 #include "csv.hpp"
 #include "dicts.hpp"
 #include "fast_float/fast_float.h"
+#include "memory_usage.hpp"
+#include "profiler.hpp"
 #include "spdlog/spdlog.h"
 #include "string_helpers.hpp"
+#include "thread_pool.hpp"
 #include "utility.hpp"
 #include "uuid_generator.hpp"
 
@@ -29,126 +36,263 @@ namespace {
 		"%Y-%m-%d %H:%M:%S"
 	};
 
-	auto parseDate(const std::string &str, size_t &prefered_fmt) -> time_t {
-		std::istringstream ss{};
-
-		std::chrono::sys_seconds tp{};
-		bool success = false;
+	auto loadCSV(const std::filesystem::path &path, const cancellation_token_t &stop_loading,
+				 const time_window_t &window) -> std::unordered_map<std::string, immediate_dict> {
+		std::vector<immediate_dict *> columns{};
+		std::unordered_map<std::string, immediate_dict> values{};
 
-		for (size_t i = 0; i < date_formats.size(); ++i) {
-			const auto index = (i + prefered_fmt) % date_formats.size();
-			const auto &fmt = date_formats.at(index);
-			ss.clear();
-			ss.str(str);
-			
-			ss >> std::chrono::parse(fmt, tp);
+		const auto on_header = [&columns, &values](const std::vector<csv_column_t> &header) {
+			for (const auto &col : header) {
+				auto &dict = values[col.header];
+				dict = {.name = col.name, .unit = col.unit, .data = {}};
+				columns.push_back(&dict);
+			}
+		};
 
-			if (!ss.fail()) {
-				success = true;
-				prefered_fmt = index;
-				break;
+		const auto on_row = [&columns](time_t date, std::span<const double> row) {
+			for (size_t col = 0; col < row.size(); ++col) {
+				if (!std::isnan(row[col])) {
+					columns[col]->data.emplace_back(date, row[col]);
+				}
 			}
+		};
+
+		readCSV(path, stop_loading, on_header, on_row, window);
+
+		return values;
+	}
+
+	// enough to hold the last few rows of even very wide files
+	constexpr std::streamoff tail_size = 64 * 1024;
+	constexpr size_t max_leading_lines = 100;
+
+	auto trimField(std::string_view field) -> std::string_view {
+		while (!field.empty() && (field.front() == '"' || field.front() == ' ')) {
+			field.remove_prefix(1);
 		}
 
-		if (!success) {
-			prefered_fmt = 0;
-			throw std::runtime_error(fmt::format("Failed to parse date: \"{}\"", str));
+		while (!field.empty() && (field.back() == '"' || field.back() == ' ' || field.back() == '\r' ||
+								  field.back() == '\n')) {
+			field.remove_suffix(1);
 		}
 
-		return std::chrono::system_clock::to_time_t(tp);
+		return field;
 	}
 
-	auto loadCSV(const std::filesystem::path &path, const std::atomic<bool> &stop_loading)
-		-> std::unordered_map<std::string, immediate_dict> {
-		using namespace csv;
+	// date in the first field of a raw CSV line, empty if there is none
+	auto parseLineDate(std::string_view line, size_t &prefered_fmt) -> std::optional<time_t> {
+		const auto field = trimField(line.substr(0, line.find_first_of(",;\t")));
 
-		std::vector<std::string> col_names{};
-		std::unordered_map<std::string, immediate_dict> values{};
+		if (field.empty()) {
+			return std::nullopt;
+		}
 
-		CSVReader reader(path.string());
+		try {
+			return parseDate(std::string(field), prefered_fmt);
+		} catch (const std::exception &) {
+			return std::nullopt;
+		}
+	}
+}  // namespace
 
-		for (const auto &header_string : reader.get_col_names() | std::ranges::views::drop(1)) {
-			if (header_string.empty()) {
-				continue;
-			}
+auto parseDate(const std::string &str, size_t &prefered_fmt) -> time_t {
+	std::istringstream ss{};
+
+	std::chrono::sys_seconds tp{};
+	bool success = false;
 
-			const auto [name, unit] = stripUnit(header_string);
+	for (size_t i = 0; i < date_formats.size(); ++i) {
+		const auto index = (i + prefered_fmt) % date_formats.size();
+		const auto &fmt = date_formats.at(index);
+		ss.clear();
+		ss.str(str);
+		
+		ss >> std::chrono::parse(fmt, tp);
 
-			values[header_string] = {.name = name, .unit = unit, .data = {}};
-			col_names.push_back(header_string);
+		if (!ss.fail()) {
+			success = true;
+			prefered_fmt = index;
+			break;
 		}
+	}
 
-		bool line_error_shown{false};
-		std::vector<bool> col_error_shown(col_names.size(), false);
-		size_t prefered_date_fmt = 0;
+	if (!success) {
+		prefered_fmt = 0;
+		throw std::runtime_error(fmt::format("Failed to parse date: \"{}\"", str));
+	}
 
-		for (size_t line = 0; auto &row : reader) {
-			try {
-				const auto date_str = row[0].get<std::string>();
-				const auto date = parseDate(date_str, prefered_date_fmt);
+	return std::chrono::system_clock::to_time_t(tp);
+}
+
+auto parseValue(std::string_view str) -> double {
+	static constexpr fast_float::parse_options options{fast_float::chars_format::general, ','};
+
+	double value{std::numeric_limits<double>::quiet_NaN()};
+	const auto result = fast_float::from_chars_advanced(str.data(), str.data() + str.size(), value, options);
+
+	if (result.ec != std::errc() || !std::isfinite(value)) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	return value;
+}
+
+auto readCSV(const std::filesystem::path &path, const cancellation_token_t &stop_loading,
+			 const csv_header_callback_t &on_header, const csv_row_callback_t &on_row,
+			 const time_window_t &window) -> void {
+	using namespace csv;
+
+	CSVReader reader(path.string());
+
+	std::vector<csv_column_t> header{};
+	std::vector<size_t> col_indices{};
+
+	for (size_t index = 0; const auto &header_string : reader.get_col_names()) {
+		if (index++ == 0 || header_string.empty()) {
+			continue;
+		}
+
+		const auto [name, unit] = stripUnit(header_string);
+
+		header.push_back({.header = header_string, .name = name, .unit = unit});
+		col_indices.push_back(index - 1);
+	}
+
+	on_header(header);
+
+	bool line_error_shown{false};
+	std::vector<bool> col_error_shown(col_indices.size(), false);
+	std::vector<double> row_values(col_indices.size());
+	size_t prefered_date_fmt = 0;
+	profiler::Accumulator parse_date_timer{profiler::stage::parse_date, 10'000};
+
+	for (size_t line = 0; auto &row : reader) {
+		try {
+			const auto date_str = row[0].get<std::string_view>();
+			parse_date_timer.start();
+			const auto date = parseDate(std::string(date_str), prefered_date_fmt);
+			parse_date_timer.stop();
+
+			if (window.contains(date)) {
+				for (size_t col = 0; col < col_indices.size(); ++col) {
+					row_values[col] = std::numeric_limits<double>::quiet_NaN();
 
-				for (size_t col = 0; const auto &col_name : col_names) {
 					try {
-						const auto val = row[col_name].get<std::string>();
-						double dbl_val{std::numeric_limits<double>::quiet_NaN()};
-
-						static constexpr fast_float::parse_options options{fast_float::chars_format::general, ','};
-						const auto result =
-							fast_float::from_chars_advanced(val.data(), val.data() + val.size(), dbl_val, options);
-						if (result.ec == std::errc() && std::isfinite(dbl_val)) {
-							values[col_name].data.emplace_back(date, dbl_val);
+						if (col_indices[col] < row.size()) {
+							row_values[col] = parseValue(row[col_indices[col]].get<std::string_view>());
 						}
-					} catch (const std::exception & e) {
+					} catch (const std::exception &e) {
 						if (!col_error_shown[col]) {
-							spdlog::warn("Error parsing column {} in file {}:{}: {}", col + 2, path.filename().string(),
-										 line + 1, e.what());
+							spdlog::warn("Error parsing column {} in file {}:{}: {}", col + 2,
+										 path.filename().string(), line + 1, e.what());
 							col_error_shown[col] = true;
 						}
 					}
-
-					if (stop_loading) {
-						break;
-					}
-
-					++col;
 				}
-			} catch (const std::exception &e) {
-				if (!line_error_shown) {
-					spdlog::warn("Error parsing line {}:{}: {}", path.filename().string(), line + 1, e.what());
-					line_error_shown = true;
-				}
-			}
 
-			if (stop_loading) {
-				break;
+				on_row(date, row_values);
 			}
+		} catch (const std::exception &e) {
+			if (!line_error_shown) {
+				spdlog::warn("Error parsing line {}:{}: {}", path.filename().string(), line + 1, e.what());
+				line_error_shown = true;
+			}
+		}
 
-			++line;
+		if (stop_loading) {
+			break;
 		}
 
-		return values;
+		++line;
 	}
+}
+
+auto readCSVHeader(const std::filesystem::path &path) -> std::vector<csv_column_t> {
+	std::ifstream file{path, std::ios::binary};
+	std::string line{};
+
+	if (!file || !std::getline(file, line)) {
+		return {};
+	}
+
+	// the delimiter occurring most often, the reader guesses it the same way from the first rows
+	const auto delimiter = *std::ranges::max_element(std::string_view{",;\t"}, {}, [&line](char c) {
+		return std::ranges::count(line, c);
+	});
+
+	std::vector<csv_column_t> header{};
+	std::string_view rest{line};
+
+	// the first column holds the dates
+	for (size_t index = 0; !rest.empty(); ++index) {
+		const auto pos = rest.find(delimiter);
+		const auto field = trimField(rest.substr(0, pos));
+		rest = pos != std::string_view::npos ? rest.substr(pos + 1) : std::string_view{};
 
-	template <typename T>
-	auto calculateMedian(std::vector<T> data) -> T {
-		if (data.empty()) {
-			return 0;
+		if (index == 0 || field.empty()) {
+			continue;
 		}
 
-		const auto n = data.size() / 2;
-		std::nth_element(std::execution::par_unseq, data.begin(), data.begin() + static_cast<long>(n), data.end());
+		const auto [name, unit] = stripUnit(std::string{field});
+		header.push_back({.header = std::string{field}, .name = name, .unit = unit});
+	}
+
+	return header;
+}
+
+auto readTimeRange(const std::filesystem::path &path) -> std::optional<std::pair<time_t, time_t>> {
+	std::ifstream file{path, std::ios::binary};
+	if (!file) {
+		return std::nullopt;
+	}
+
+	size_t prefered_fmt{0};
+	std::optional<time_t> first{};
+	std::string line{};
+
+	// the first line is the header
+	std::getline(file, line);
+	for (size_t i = 0; i < max_leading_lines && !first.has_value() && std::getline(file, line); ++i) {
+		first = parseLineDate(line, prefered_fmt);
+	}
+
+	if (!first.has_value()) {
+		return std::nullopt;
+	}
+
+	file.clear();
+	file.seekg(0, std::ios::end);
+	const auto size = static_cast<std::streamoff>(file.tellg());
+	const auto offset = std::max(size - tail_size, std::streamoff{0});
+
+	std::string tail(static_cast<size_t>(size - offset), '\0');
+	file.seekg(offset);
+	file.read(tail.data(), static_cast<std::streamsize>(tail.size()));
+
+	// walks the lines of the tail backwards, the first one may be cut off unless the tail is the whole file
+	std::string_view rest{tail};
+	while (!rest.empty()) {
+		const auto pos = rest.find_last_of('\n', rest.size() - 2);
+		const auto is_complete = pos != std::string_view::npos || offset == 0;
+		const auto last_line = pos != std::string_view::npos ? rest.substr(pos + 1) : rest;
+
+		if (!is_complete) {
+			break;
+		}
 
-		if (n % 2 != 0) {
-			return data.at(n);
+		if (const auto last = parseLineDate(last_line, prefered_fmt); last.has_value()) {
+			return std::pair{*first, *last};
 		}
 
-		const auto val1 = data.at(n);
-		const auto val2 =
-			*std::max_element(std::execution::par_unseq, data.cbegin(), data.cbegin() + static_cast<long>(n));
+		if (pos == std::string_view::npos) {
+			break;
+		}
 
-		return (val1 + val2) / T{2};
+		rest = rest.substr(0, pos + 1);
 	}
-}  // namespace
+
+	return std::nullopt;
+}
 
 auto preparePaths(std::vector<std::filesystem::path> paths) -> std::vector<std::filesystem::path> {
 	std::vector<std::filesystem::path> files{};
@@ -173,8 +317,9 @@ auto preparePaths(std::vector<std::filesystem::path> paths) -> std::vector<std::
 	return files;
 }
 
-auto loadCSVs(const std::vector<std::filesystem::path> &paths, size_t &finished, const bool &stop_loading)
-	-> std::vector<data_dict_t> {
+auto loadCSVs(const std::vector<std::filesystem::path> &paths, progress_counter_t &finished,
+			  const cancellation_token_t &stop_loading,
+			  const time_window_t &window) -> load_result_t {
 	if (paths.empty()) {
 		return {};
 	}
@@ -195,11 +340,25 @@ auto loadCSVs(const std::vector<std::filesystem::path> &paths, size_t &finished,
 		contexts.push_back({.index = ++i, .path = path});
 	}
 
-	auto fn = [&contexts, &stop_loading, &finished](auto &ctx) {
+	auto fn = [&contexts, &stop_loading, &finished, &window](auto &ctx) {
 		if (!stop_loading) {
+			// only whole files are skipped by their range, one whose last row predates its first row is always read
+			if (window.isSet()) {
+				const auto range = readTimeRange(ctx.path);
+				const auto ordered = range.has_value() && range->first <= range->second;
+
+				if (ordered && !window.overlaps(range->first, range->second)) {
+					spdlog::info("Skipping file outside the time window: {} ({}/{})", ctx.path.filename().string(),
+								 ctx.index, contexts.size());
+					++finished;
+					return;
+				}
+			}
+
 			spdlog::info("Loading file: {} ({}/{})...", ctx.path.filename().string(), ctx.index, contexts.size());
 			try {
-				ctx.values = loadCSV(ctx.path, stop_loading);
+				const profiler::ScopedTimer timer{profiler::stage::load_csv, ctx.path.filename().string()};
+				ctx.values = loadCSV(ctx.path, stop_loading, window);
 			} catch (const std::exception &e) {
 				spdlog::error("{}", e.what());
 			}
@@ -213,32 +372,57 @@ auto loadCSVs(const std::vector<std::filesystem::path> &paths, size_t &finished,
 		return {};
 	}
 
+	size_t loaded_memory{0};
+	for (const auto &ctx : contexts) {
+		loaded_memory += getMemoryUsage(ctx.values);
+	}
+
 	spdlog::debug("Merging data...");
 
-	for (const auto &ctx : contexts) {
-		for (const auto &[key, value] : ctx.values) {
-			if (value.data.empty()) {
-				continue;
-			}
+	{
+		const profiler::ScopedTimer timer{profiler::stage::merge};
 
-			if (values_temp.find(key) == values_temp.end()) {
-				values_temp[key] = value;
-			} else {
-				values_temp[key].data.insert(values_temp[key].data.end(), value.data.begin(), value.data.end());
+		for (const auto &ctx : contexts) {
+			for (const auto &[key, value] : ctx.values) {
+				if (value.data.empty()) {
+					continue;
+				}
+
+				if (values_temp.find(key) == values_temp.end()) {
+					values_temp[key] = value;
+				} else {
+					values_temp[key].data.insert(values_temp[key].data.end(), value.data.begin(), value.data.end());
+				}
 			}
 		}
 	}
 
-	values.reserve(values_temp.size());
+	const auto merged_memory = getMemoryUsage(values_temp);
+
+	std::vector<std::pair<const std::string, immediate_dict> *> merged{};
+	merged.reserve(values_temp.size());
+	values.resize(values_temp.size());
+
+	// the generator is not thread safe, so the uuids are assigned before finalizing the columns in parallel
+	for (auto &entry : values_temp) {
+		values[merged.size()].uuid = uuids::to_string(UUIDGenerator::getInstance().generate());
+		merged.push_back(&entry);
+	}
+
+	std::atomic<size_t> finalized_memory{0};
+	std::vector<size_t> time_deltas_memory(merged.size());
+
+	// this already runs as a loading task, so the columns are spread over the pool instead of nesting parallel sorts
+	ThreadPool::getInstance().parallelFor(task_priority_t::loading, merged.size(), [&](size_t i) {
+		auto &[key, value] = *merged[i];
+		const profiler::ScopedTimer timer{profiler::stage::finalize, key};
 
-	for (auto &&[key, value] : values_temp) {
-		std::sort(std::execution::par, value.data.begin(), value.data.end(),
-				  [](const auto &a, const auto &b) { return a.first < b.first; });
+		std::ranges::sort(value.data, [](const auto &a, const auto &b) { return a.first < b.first; });
 
-		data_dict_t dd{};
+		auto &dd = values[i];
 		dd.name = value.name;
-		dd.uuid = uuids::to_string(UUIDGenerator::getInstance().generate());
 		dd.unit = value.unit;
+		dd.updateIDs();
 
 		bool is_boolean = true;
 
@@ -256,14 +440,21 @@ auto loadCSVs(const std::vector<std::filesystem::path> &paths, size_t &finished,
 		std::vector<time_t> time_deltas{};
 		time_deltas.reserve(dd.timestamp->size() - 1);
 
-		for (size_t i = 1; i < dd.timestamp->size(); ++i) {
-			time_deltas.push_back(dd.timestamp->at(i) - dd.timestamp->at(i - 1));
+		for (size_t j = 1; j < dd.timestamp->size(); ++j) {
+			time_deltas.push_back(dd.timestamp->at(j) - dd.timestamp->at(j - 1));
 		}
 
 		dd.delta_t = calculateMedian(time_deltas);
 
-		values.push_back(dd);
-	}
+		finalized_memory += getColumnMemoryUsage(dd).total();
+		time_deltas_memory[i] = time_deltas.capacity() * sizeof(time_t);
+	});
+
+	// the intervals are only alive while finalizing their column
+	const auto largest_time_deltas = time_deltas_memory.empty() ? 0uz : std::ranges::max(time_deltas_memory);
+	const auto peak_memory = loaded_memory + merged_memory + finalized_memory + largest_time_deltas;
+
+	spdlog::debug("Peak memory while loading: {}", formatBytes(peak_memory));
 
-	return values;
+	return {.data = values, .peak_memory = peak_memory};
 }
\ No newline at end of file
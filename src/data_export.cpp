@@ -0,0 +1,224 @@
+#include "data_export.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "aggregation.hpp"
+#include "dicts.hpp"
+#include "fmt/chrono.h"
+#include "fmt/format.h"
+#include "profiler.hpp"
+#include "spdlog/spdlog.h"
+#include "string_helpers.hpp"
+
+namespace {
+	constexpr auto statistic_names = std::array<std::string_view, 4>{"mean", "min", "max", "first"};
+	constexpr auto binary_magic = std::string_view{"SAEXPORT"};
+	constexpr uint32_t binary_version = 1;
+
+	static_assert(std::endian::native == std::endian::little, "binary export assumes a little endian host");
+
+	// walks the grid cells of one column, only keeping the index of the next unread sample
+	class ColumnResampler {
+	public:
+		ColumnResampler(const data_dict_t &dict, export_statistic_t cell_statistic, time_t from)
+			: timestamps{*dict.timestamp}, values{*dict.data}, statistic{cell_statistic} {
+			this->index = static_cast<size_t>(std::ranges::lower_bound(this->timestamps, from) -
+											  this->timestamps.begin());
+		}
+
+		// returns the statistic over all samples before cell_end, NaN if there are none
+		auto next(time_t cell_end) -> double {
+			const auto begin = this->index;
+
+			while (this->index < this->timestamps.size() && this->timestamps[this->index] < cell_end) {
+				++this->index;
+			}
+
+			if (begin == this->index) {
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+
+			const auto cell = this->values.subspan(begin, this->index - begin);
+
+			switch (this->statistic) {
+			case export_statistic_t::MIN:
+				return calcMin(cell);
+			case export_statistic_t::MAX:
+				return calcMax(cell);
+			case export_statistic_t::FIRST:
+				return cell.front();
+			case export_statistic_t::MEAN:
+				break;
+			}
+
+			return calcMean(cell);
+		}
+
+	private:
+		std::span<const time_t> timestamps;
+		std::span<const double> values;
+		export_statistic_t statistic;
+		size_t index{0};
+	};
+
+	auto getRowCount(const export_settings_t &settings) -> uint64_t {
+		if (settings.to < settings.from) {
+			return 0;
+		}
+
+		return static_cast<uint64_t>((settings.to - settings.from) / settings.interval) + 1;
+	}
+
+	template <typename T>
+	auto writeBinary(std::ofstream &out, const T &value) -> void {
+		out.write(reinterpret_cast<const char *>(&value), sizeof(T));  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+	}
+
+	auto writeBinaryString(std::ofstream &out, std::string_view str) -> void {
+		writeBinary(out, static_cast<uint32_t>(str.size()));
+		out.write(str.data(), static_cast<std::streamsize>(str.size()));
+	}
+
+	auto exportCSV(std::ofstream &out, const std::vector<const data_dict_t *> &columns,
+				   const export_settings_t &settings) -> void {
+		out << "Date";
+		for (const auto *col : columns) {
+			out << ',' << escapeCSV(col->unit.empty() ? col->name : fmt::format("{} ({})", col->name, col->unit));
+		}
+		out << '\n';
+
+		std::vector<ColumnResampler> resamplers{};
+		resamplers.reserve(columns.size());
+		for (const auto *col : columns) {
+			resamplers.emplace_back(*col, settings.statistic, settings.from);
+		}
+
+		fmt::memory_buffer row{};
+		const auto rows = getRowCount(settings);
+
+		for (uint64_t i = 0; i < rows; ++i) {
+			const auto cell_start = settings.from + static_cast<time_t>(i) * settings.interval;
+
+			row.clear();
+			fmt::format_to(std::back_inserter(row), "{:%Y-%m-%d %H:%M:%S}",
+						   std::chrono::sys_seconds{std::chrono::seconds{cell_start}});
+
+			for (auto &resampler : resamplers) {
+				const auto value = resampler.next(cell_start + settings.interval);
+
+				if (std::isnan(value)) {
+					row.push_back(',');
+				} else {
+					fmt::format_to(std::back_inserter(row), ",{}", value);
+				}
+			}
+
+			row.push_back('\n');
+			out.write(row.data(), static_cast<std::streamsize>(row.size()));
+		}
+	}
+
+	auto exportBinary(std::ofstream &out, const std::vector<const data_dict_t *> &columns,
+					  const export_settings_t &settings) -> void {
+		const auto rows = getRowCount(settings);
+
+		out.write(binary_magic.data(), static_cast<std::streamsize>(binary_magic.size()));
+		writeBinary(out, binary_version);
+		writeBinary(out, static_cast<uint32_t>(columns.size()));
+		writeBinary(out, rows);
+		writeBinary(out, static_cast<int64_t>(settings.from));
+		writeBinary(out, static_cast<int64_t>(settings.interval));
+
+		for (const auto *col : columns) {
+			writeBinaryString(out, col->name);
+			writeBinaryString(out, col->unit);
+		}
+
+		static constexpr size_t chunk_size = 4'096;
+		std::vector<double> chunk{};
+		chunk.reserve(chunk_size);
+
+		for (const auto *col : columns) {
+			ColumnResampler resampler{*col, settings.statistic, settings.from};
+
+			for (uint64_t i = 0; i < rows; ++i) {
+				const auto cell_end = settings.from + static_cast<time_t>(i + 1) * settings.interval;
+				chunk.push_back(resampler.next(cell_end));
+
+				if (chunk.size() == chunk_size || i + 1 == rows) {
+					out.write(reinterpret_cast<const char *>(chunk.data()),  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+							  static_cast<std::streamsize>(chunk.size() * sizeof(double)));
+					chunk.clear();
+				}
+			}
+		}
+	}
+}  // namespace
+
+auto getStatisticName(export_statistic_t statistic) -> std::string_view {
+	return statistic_names.at(static_cast<size_t>(statistic));
+}
+
+auto parseStatistic(std::string_view name) -> std::optional<export_statistic_t> {
+	const auto it = std::ranges::find(statistic_names, name);
+
+	if (it == statistic_names.end()) {
+		return std::nullopt;
+	}
+
+	return static_cast<export_statistic_t>(it - statistic_names.begin());
+}
+
+auto exportResampled(const std::vector<const data_dict_t *> &columns, const export_settings_t &settings,
+					 const std::filesystem::path &path) -> bool {
+	if (settings.interval <= 0) {
+		spdlog::error("Export interval has to be positive");
+		return false;
+	}
+
+	std::ofstream out{path, std::ios::binary};
+
+	if (!out) {
+		spdlog::error("Failed to open {} for export", path.string());
+		return false;
+	}
+
+	spdlog::debug("Exporting {} columns with {} rows to {}", columns.size(), getRowCount(settings), path.string());
+
+	{
+		const profiler::ScopedTimer timer{profiler::stage::export_data, path.filename().string()};
+
+		switch (settings.format) {
+		case export_format_t::CSV:
+			exportCSV(out, columns, settings);
+			break;
+		case export_format_t::BINARY:
+			exportBinary(out, columns, settings);
+			break;
+		}
+	}
+
+	out.close();
+
+	if (!out) {
+		spdlog::error("Failed to write {}", path.string());
+		return false;
+	}
+
+	return true;
+}
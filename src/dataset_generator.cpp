@@ -0,0 +1,245 @@
+#include "dataset_generator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fmt/chrono.h"
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+#include "thread_pool.hpp"
+
+namespace {
+	enum class channel_type_t : uint8_t {
+		FLOAT,
+		BOOLEAN,
+		ENUM
+	};
+
+	struct channel_t {
+		std::string header;
+		channel_type_t type;
+		double offset;
+		double amplitude;
+		double period;	   // in samples
+		double noise;
+		double toggle_probability;
+	};
+
+	constexpr auto units = std::array<std::string_view, 7>{"V", "A", "°C", "bar", "%", "rpm", "m/s"};
+
+	auto deriveSeed(uint64_t seed, uint64_t index) -> uint64_t {
+		// splitmix64
+		auto z = seed + (index + 1) * 0x9e3779b97f4a7c15ull;
+		z = (z ^ (z >> 30u)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27u)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31u);
+	}
+
+	auto createChannels(const dataset_options_t &options) -> std::vector<channel_t> {
+		std::mt19937_64 rng{deriveSeed(options.seed, 0)};
+		std::vector<channel_t> channels{};
+		channels.reserve(options.columns);
+
+		const auto columns = static_cast<double>(options.columns);
+		const auto booleans = std::min(static_cast<size_t>(std::round(options.boolean_fraction * columns)),
+									   options.columns);
+		const auto enums = std::min(static_cast<size_t>(std::round(options.enum_fraction * columns)),
+									options.columns - booleans);
+
+		for (size_t i = 0; i < options.columns; ++i) {
+			channel_t channel{.header = {},
+							  .type = channel_type_t::FLOAT,
+							  .offset = (randomUniform(rng) - 0.5) * 200.0,
+							  .amplitude = randomUniform(rng) * 50.0,
+							  .period = 100.0 + (randomUniform(rng) * 10'000.0),
+							  .noise = randomUniform(rng) * 2.0,
+							  .toggle_probability = 0.0001 + (randomUniform(rng) * 0.01)};
+
+			if (i < booleans) {
+				channel.type = channel_type_t::BOOLEAN;
+				channel.header = fmt::format("Switch {}", i + 1);
+			} else if (i < booleans + enums) {
+				channel.type = channel_type_t::ENUM;
+				channel.header = fmt::format("State {}", i + 1);
+			} else {
+				const auto unit = units.at(randomIndex(rng, units.size()));
+				channel.header = fmt::format("Channel {} ({})", i + 1, unit);
+			}
+
+			channels.push_back(channel);
+		}
+
+		return channels;
+	}
+
+	auto writeMalformedLine(fmt::memory_buffer &line, std::mt19937_64 &rng, std::string_view date, size_t columns)
+		-> void {
+		switch (randomIndex(rng, 3)) {
+		case 0:
+			fmt::format_to(std::back_inserter(line), "not a date{}", std::string(columns, ','));
+			break;
+		case 1:
+			// truncated row
+			fmt::format_to(std::back_inserter(line), "{},1.0", date);
+			break;
+		default:
+			fmt::format_to(std::back_inserter(line), "{}", date);
+			for (size_t col = 0; col < columns; ++col) {
+				line.append(std::string_view{",n/a"});
+			}
+			break;
+		}
+	}
+
+	auto writeFile(const dataset_options_t &options, const std::vector<channel_t> &channels, size_t file_index,
+				   const std::filesystem::path &path) -> void {
+		std::mt19937_64 rng{deriveSeed(options.seed, file_index + 1)};
+		std::ofstream out{path, std::ios::binary};
+
+		if (!out) {
+			throw std::runtime_error(fmt::format("Failed to open {}", path.string()));
+		}
+
+		out << "Date";
+		for (const auto &channel : channels) {
+			out << ',' << channel.header;
+		}
+		out << '\n';
+
+		const auto first_row = file_index * (options.rows - std::min(options.overlap, options.rows));
+		const auto date_format = options.slash_dates ? std::string_view{"{:%Y/%m/%d %H:%M:%S}"}
+													 : std::string_view{"{:%Y-%m-%d %H:%M:%S}"};
+
+		std::vector<double> states(channels.size(), 0.0);
+		fmt::memory_buffer line{};
+		fmt::memory_buffer date{};
+		size_t gap_remaining{0};
+
+		for (size_t row = 0; row < options.rows; ++row) {
+			const auto sample = first_row + row;
+
+			if (gap_remaining > 0) {
+				--gap_remaining;
+				continue;
+			}
+
+			if (randomUniform(rng) < options.gap_probability) {
+				gap_remaining = options.gap_length;
+			}
+
+			auto timestamp = options.start + (static_cast<time_t>(sample) * options.interval);
+			if (options.jitter > 0) {
+				timestamp += static_cast<time_t>(randomIndex(rng, static_cast<size_t>((2 * options.jitter) + 1))) -
+							 options.jitter;
+			}
+
+			const auto time_point = std::chrono::sys_seconds{std::chrono::seconds{timestamp}};
+			date.clear();
+			fmt::vformat_to(std::back_inserter(date), date_format, fmt::make_format_args(time_point));
+			const auto date_str = std::string_view{date.data(), date.size()};
+
+			line.clear();
+
+			if (randomUniform(rng) < options.malformed_line_probability) {
+				writeMalformedLine(line, rng, date_str, channels.size());
+			} else {
+				line.append(date_str);
+
+				for (size_t col = 0; col < channels.size(); ++col) {
+					const auto &channel = channels[col];
+					auto &state = states[col];
+
+					if (channel.type != channel_type_t::FLOAT && randomUniform(rng) < channel.toggle_probability) {
+						state = channel.type == channel_type_t::BOOLEAN
+									? 1.0 - state
+									: static_cast<double>(randomIndex(rng, std::max(options.enum_levels, 1uz)));
+					}
+
+					if (randomUniform(rng) < options.empty_cell_probability) {
+						line.push_back(',');
+						continue;
+					}
+
+					switch (channel.type) {
+					case channel_type_t::FLOAT: {
+						const auto phase = 2.0 * std::numbers::pi * static_cast<double>(sample) / channel.period;
+						const auto value = channel.offset + (channel.amplitude * std::sin(phase)) +
+										   (channel.noise * (randomUniform(rng) - 0.5));
+						fmt::format_to(std::back_inserter(line), ",{:.4f}", value);
+						break;
+					}
+					case channel_type_t::BOOLEAN:
+					case channel_type_t::ENUM:
+						fmt::format_to(std::back_inserter(line), ",{}", static_cast<int>(state));
+						break;
+					}
+				}
+			}
+
+			line.push_back('\n');
+			out.write(line.data(), static_cast<std::streamsize>(line.size()));
+		}
+
+		// the last buffered rows are only written here, a full disk shows up as failure of the close
+		out.close();
+
+		if (!out) {
+			throw std::runtime_error(fmt::format("Failed to write {}", path.string()));
+		}
+	}
+}  // namespace
+
+auto randomUniform(std::mt19937_64 &rng) -> double {
+	return static_cast<double>(rng() >> 11u) * 0x1.0p-53;
+}
+
+auto randomIndex(std::mt19937_64 &rng, size_t count) -> size_t {
+	return static_cast<size_t>(randomUniform(rng) * static_cast<double>(count));
+}
+
+auto generateDataset(const dataset_options_t &options, const std::filesystem::path &directory)
+	-> std::vector<std::filesystem::path> {
+	std::filesystem::create_directories(directory);
+
+	const auto channels = createChannels(options);
+
+	std::vector<std::filesystem::path> paths{};
+	paths.reserve(options.files);
+
+	for (size_t i = 0; i < options.files; ++i) {
+		paths.push_back(directory / fmt::format("{}_{:04}.csv", options.prefix, i));
+	}
+
+	std::atomic<size_t> failed{0};
+
+	ThreadPool::getInstance().parallelFor(task_priority_t::loading, options.files, [&](size_t i) {
+		try {
+			writeFile(options, channels, i, paths[i]);
+		} catch (const std::exception &e) {
+			spdlog::error("{}", e.what());
+			++failed;
+		}
+	});
+
+	if (failed > 0) {
+		throw std::runtime_error(fmt::format("Failed to write {} of {} files", failed.load(), options.files));
+	}
+
+	return paths;
+}
@@ -0,0 +1,91 @@
+#include "dataset_registry.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "dicts.hpp"
+#include "global_state.hpp"
+#include "spdlog/spdlog.h"
+#include "thread_pool.hpp"
+
+namespace {
+	// a load that failed or was stopped should not keep other windows from trying again
+	auto isFailed(const dataset_load_t &load) -> bool {
+		return load.result.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+			   load.result.get().data.empty();
+	}
+}  // namespace
+
+auto getFileIdentity(const std::filesystem::path &path) -> file_identity_t {
+	std::error_code ec{};
+	file_identity_t identity{};
+
+	identity.path = std::filesystem::weakly_canonical(path, ec);
+	if (ec) {
+		identity.path = path;
+	}
+
+	identity.size = std::filesystem::file_size(path, ec);
+	if (ec) {
+		identity.size = 0;
+	}
+
+	identity.modified = std::filesystem::last_write_time(path, ec);
+	if (ec) {
+		identity.modified = {};
+	}
+
+	return identity;
+}
+
+auto DatasetRegistry::acquire(const std::vector<std::filesystem::path> &paths, const time_window_t &window,
+							  const load_function_t &fn) -> std::shared_ptr<dataset_load_t> {
+	std::pair<std::vector<file_identity_t>, time_window_t> key{{}, window};
+	key.first.reserve(paths.size());
+	std::ranges::transform(paths, std::back_inserter(key.first), getFileIdentity);
+	std::ranges::sort(key.first);
+
+	const std::lock_guard lock{this->mutex};
+	std::erase_if(this->loads, [](const auto &e) { return e.second.expired(); });
+
+	if (const auto it = this->loads.find(key); it != this->loads.end()) {
+		if (auto load = it->second.lock(); load != nullptr && !isFailed(*load)) {
+			spdlog::info("Reusing {} already loaded files", paths.size());
+			return load;
+		}
+	}
+
+	auto load = std::make_shared<dataset_load_t>();
+	load->required_files = paths.size();
+
+	// only the control is shared with the task, so a dropped load doesn't need to be waited for
+	auto task = [control = load->control, fn, paths, window]() -> load_result_t {
+		if (control->cancelled) {
+			return {};
+		}
+
+		try {
+			auto ret = fn(paths, control->finished, control->cancelled, window);
+			AppState::getInstance().wakeMainLoop();
+			return ret;
+		} catch (const std::exception &e) {
+			spdlog::error("error loading {}: {}", paths.front().string(), e.what());
+		}
+
+		AppState::getInstance().wakeMainLoop();
+		return {};
+	};
+
+	load->result = ThreadPool::getInstance().submit(task_priority_t::loading, std::move(task)).share();
+	this->loads[key] = load;
+	return load;
+}
@@ -0,0 +1,256 @@
+#include "debug_menu.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "fmt/format.h"
+#include "imgui.h"
+#include "imgui_extensions.hpp"
+#include "memory_usage.hpp"
+#include "profiler.hpp"
+#include "window_context.hpp"
+
+namespace {
+	constexpr size_t histogram_bins = 24;
+
+	auto calculateHistogram(const std::vector<float> &samples, float max_value)
+		-> std::array<float, histogram_bins> {
+		std::array<float, histogram_bins> bins{};
+
+		if (samples.empty() || max_value <= 0.0f) {
+			return bins;
+		}
+
+		for (const auto &e : samples) {
+			const auto bin = static_cast<size_t>(e / max_value * static_cast<float>(histogram_bins));
+			bins.at(std::min(bin, histogram_bins - 1)) += 1.0f;
+		}
+
+		return bins;
+	}
+
+	auto drawStageDetails(profiler::stage stage, const profiler::stage_statistics_t &stats) -> void {
+		if (stats.samples_ms.empty()) {
+			ImGui::TextDisabled("no samples recorded");	 // NOLINT(hicpp-vararg)
+			return;
+		}
+
+		const auto max_value = static_cast<float>(stats.max_ms);
+		const auto overlay = fmt::format("last {:.3f} ms", stats.last_ms);
+		const auto width = ImGui::GetContentRegionAvail().x;
+
+		ImGui::PushID(static_cast<int>(stage));
+		ImGui::PlotLines("##timeline", stats.samples_ms.data(), static_cast<int>(stats.samples_ms.size()), 0,
+						 overlay.c_str(), 0.0f, max_value, ImVec2(width, 60.0f));
+
+		const auto bins = calculateHistogram(stats.samples_ms, max_value);
+		const auto histogram_overlay = fmt::format("0 - {:.3f} ms", stats.max_ms);
+		ImGui::PlotHistogram("##histogram", bins.data(), static_cast<int>(bins.size()), 0, histogram_overlay.c_str(),
+							 0.0f, FLT_MAX, ImVec2(width, 60.0f));
+		ImGui::PopID();
+	}
+
+	struct memory_row_t {
+		const std::string *window_title;
+		column_memory_t column;
+	};
+
+	enum memory_column_id : uint8_t {
+		memory_column_window,
+		memory_column_name,
+		memory_column_timestamps,
+		memory_column_values,
+		memory_column_aggregates,
+		memory_column_caches,
+		memory_column_total
+	};
+
+	auto sortMemoryRows(std::vector<memory_row_t> &rows, const ImGuiTableColumnSortSpecs &spec) -> void {
+		const auto key = [&spec](const memory_row_t &row) -> size_t {
+			switch (spec.ColumnUserID) {
+			case memory_column_timestamps:
+				return row.column.timestamps;
+			case memory_column_values:
+				return row.column.values;
+			case memory_column_aggregates:
+				return row.column.aggregates;
+			case memory_column_caches:
+				return row.column.caches;
+			default:
+				return row.column.total();
+			}
+		};
+
+		const auto ascending = spec.SortDirection == ImGuiSortDirection_Ascending;
+
+		std::ranges::stable_sort(rows, [&](const memory_row_t &a, const memory_row_t &b) {
+			if (spec.ColumnUserID == memory_column_window) {
+				return ascending ? *a.window_title < *b.window_title : *a.window_title > *b.window_title;
+			}
+
+			if (spec.ColumnUserID == memory_column_name) {
+				return ascending ? a.column.name < b.column.name : a.column.name > b.column.name;
+			}
+
+			return ascending ? key(a) < key(b) : key(a) > key(b);
+		});
+	}
+}  // namespace
+
+auto showProfilerWindow(bool *open) -> void {
+	if (!*open) {
+		return;
+	}
+
+	ImGui::SetNextWindowSize(ImVec2(520, 600), ImGuiCond_FirstUseEver);
+	if (!ImGui::Begin("Profiler", open)) {
+		ImGui::End();
+		return;
+	}
+
+	if constexpr (!profiler::isEnabled()) {
+		ImGuiExt::TextFormattedWrapped("Profiling has been disabled at compile time (ENABLE_PROFILING=OFF).");
+		ImGui::End();
+		return;
+	}
+
+	if (ImGui::Button("Reset")) {
+		profiler::reset();
+	}
+
+	std::array<profiler::stage_statistics_t, profiler::stage_count> stats{};
+	for (size_t i = 0; i < profiler::stage_count; ++i) {
+		stats.at(i) = profiler::getStageStatistics(static_cast<profiler::stage>(i));
+	}
+
+	if (ImGui::BeginTable("##stages", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+		ImGui::TableSetupColumn("Stage");
+		ImGui::TableSetupColumn("Last [ms]");
+		ImGui::TableSetupColumn("Mean [ms]");
+		ImGui::TableSetupColumn("Max [ms]");
+		ImGui::TableSetupColumn("Samples");
+		ImGui::TableHeadersRow();
+
+		for (size_t i = 0; i < profiler::stage_count; ++i) {
+			const auto &e = stats.at(i);
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGuiExt::TextUnformatted(profiler::getStageName(static_cast<profiler::stage>(i)));
+			ImGui::TableNextColumn();
+			ImGuiExt::TextFormatted("{:.3f}", e.last_ms);
+			ImGui::TableNextColumn();
+			ImGuiExt::TextFormatted("{:.3f}", e.mean_ms);
+			ImGui::TableNextColumn();
+			ImGuiExt::TextFormatted("{:.3f}", e.max_ms);
+			ImGui::TableNextColumn();
+			ImGuiExt::TextFormatted("{}", e.total_count);
+		}
+
+		ImGui::EndTable();
+	}
+
+	for (size_t i = 0; i < profiler::stage_count; ++i) {
+		const auto stage = static_cast<profiler::stage>(i);
+		const auto name = std::string(profiler::getStageName(stage));
+
+		if (ImGui::CollapsingHeader(name.c_str(), stage == profiler::stage::frame ? ImGuiTreeNodeFlags_DefaultOpen : 0)) {
+			drawStageDetails(stage, stats.at(i));
+		}
+	}
+
+	ImGui::End();
+}
+
+auto showMemoryWindow(bool *open, const std::list<WindowContext> &window_contexts) -> void {
+	if (!*open) {
+		return;
+	}
+
+	ImGui::SetNextWindowSize(ImVec2(800, 500), ImGuiCond_FirstUseEver);
+	if (!ImGui::Begin("Memory", open)) {
+		ImGui::End();
+		return;
+	}
+
+	const auto process = getProcessMemoryUsage();
+	ImGuiExt::TextFormatted("Process: {} resident, {} peak", formatBytes(process.resident),
+							formatBytes(process.peak_resident));
+	ImGuiExt::TextFormatted("Accounted data: {}", formatBytes(getTotalMemoryUsage(window_contexts)));
+
+	const auto owners = countBufferOwners(window_contexts);
+
+	std::vector<window_memory_t> windows{};
+	for (const auto &ctx : window_contexts) {
+		windows.push_back(getWindowMemoryUsage(ctx, owners));
+	}
+
+	for (const auto &window : windows) {
+		ImGuiExt::TextFormatted("{}: {} (peak while loading: {})", window.title, formatBytes(window.total()),
+								formatBytes(window.peak_load));
+	}
+
+	std::vector<memory_row_t> rows{};
+	for (const auto &window : windows) {
+		for (const auto &col : window.columns) {
+			rows.push_back({.window_title = &window.title, .column = col});
+		}
+
+		rows.push_back({.window_title = &window.title, .column = {.name = "(window caches)", .caches = window.caches}});
+	}
+
+	static constexpr auto table_flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Sortable |
+										ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+
+	if (ImGui::BeginTable("##memory", 7, table_flags)) {
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Window", ImGuiTableColumnFlags_None, 0.0f, memory_column_window);
+		ImGui::TableSetupColumn("Column", ImGuiTableColumnFlags_None, 0.0f, memory_column_name);
+		ImGui::TableSetupColumn("Timestamps", ImGuiTableColumnFlags_None, 0.0f, memory_column_timestamps);
+		ImGui::TableSetupColumn("Values", ImGuiTableColumnFlags_None, 0.0f, memory_column_values);
+		ImGui::TableSetupColumn("Aggregates", ImGuiTableColumnFlags_None, 0.0f, memory_column_aggregates);
+		ImGui::TableSetupColumn("Caches", ImGuiTableColumnFlags_None, 0.0f, memory_column_caches);
+		ImGui::TableSetupColumn("Total", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending,
+								0.0f, memory_column_total);
+		ImGui::TableHeadersRow();
+
+		if (auto *sort_specs = ImGui::TableGetSortSpecs(); sort_specs != nullptr && sort_specs->SpecsCount > 0) {
+			sortMemoryRows(rows, sort_specs->Specs[0]);
+		}
+
+		ImGuiListClipper clipper;
+		clipper.Begin(static_cast<int>(rows.size()));
+
+		while (clipper.Step()) {
+			for (auto i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+				const auto &row = rows.at(static_cast<size_t>(i));
+
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGuiExt::TextUnformatted(*row.window_title);
+				ImGui::TableNextColumn();
+				ImGuiExt::TextFormatted("{}{}", row.column.name, row.column.shared ? " (shared)" : "");
+				ImGui::TableNextColumn();
+				ImGuiExt::TextUnformatted(formatBytes(row.column.timestamps));
+				ImGui::TableNextColumn();
+				ImGuiExt::TextUnformatted(formatBytes(row.column.values));
+				ImGui::TableNextColumn();
+				ImGuiExt::TextUnformatted(formatBytes(row.column.aggregates));
+				ImGui::TableNextColumn();
+				ImGuiExt::TextUnformatted(formatBytes(row.column.caches));
+				ImGui::TableNextColumn();
+				ImGuiExt::TextUnformatted(formatBytes(row.column.total()));
+			}
+		}
+
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
@@ -0,0 +1,104 @@
+#include "density_grid.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "profiler.hpp"
+#include "thread_pool.hpp"
+#include "time_join.hpp"
+#include "utility.hpp"
+
+namespace {
+	constexpr size_t points_per_chunk = 65'536;
+
+	// sorts chunks of the points on the pool, then merges neighbouring runs pairwise, each round in parallel as well
+	auto sortByX(std::vector<xy_point_t> &points, task_priority_t priority) -> void {
+		const auto by_x = [](const xy_point_t &a, const xy_point_t &b) { return a.x < b.x; };
+		const auto chunk_count = fastCeil(points.size(), points_per_chunk);
+		const auto bound = [&points](size_t chunk) {
+			return points.begin() + static_cast<std::ptrdiff_t>(std::min(chunk * points_per_chunk, points.size()));
+		};
+
+		ThreadPool::getInstance().parallelFor(priority, chunk_count,
+											  [&](size_t chunk) { std::sort(bound(chunk), bound(chunk + 1), by_x); });
+
+		for (size_t width = 1; width < chunk_count; width *= 2) {
+			ThreadPool::getInstance().parallelFor(priority, fastCeil(chunk_count, 2 * width), [&](size_t pair) {
+				const auto first = pair * 2 * width;
+				std::inplace_merge(bound(first), bound(first + width), bound(first + (2 * width)), by_x);
+			});
+		}
+	}
+}  // namespace
+
+auto sortPointsByX(const joined_columns_t &joined, task_priority_t priority) -> std::vector<xy_point_t> {
+	std::vector<xy_point_t> points{};
+
+	if (joined.values.size() < 2) {
+		return points;
+	}
+
+	const auto &xs = joined.values.front();
+	points.reserve(xs.size() * (joined.values.size() - 1));
+
+	for (size_t i = 1; i < joined.values.size(); ++i) {
+		for (size_t j = 0; j < xs.size(); ++j) {
+			points.push_back({.x = xs[j], .y = joined.values[i][j]});
+		}
+	}
+
+	sortByX(points, priority);
+
+	return points;
+}
+
+auto binDensity(const std::vector<xy_point_t> &points, const density_bounds_t &bounds, task_priority_t priority)
+	-> density_grid_t {
+	const profiler::ScopedTimer timer{profiler::stage::density_grid};
+
+	density_grid_t grid{.bounds = bounds, .counts = {}, .max_count = 0.0};
+	const auto x_range = bounds.x_max - bounds.x_min;
+	const auto y_range = bounds.y_max - bounds.y_min;
+
+	if (bounds.columns == 0 || bounds.rows == 0 || !(x_range > 0.0) || !(y_range > 0.0)) {
+		return grid;
+	}
+
+	const auto first = std::ranges::lower_bound(points, bounds.x_min, {}, &xy_point_t::x);
+	const auto last = std::ranges::upper_bound(points, bounds.x_max, {}, &xy_point_t::x);
+	const auto visible = std::span{first, last};
+
+	std::vector<uint32_t> counts(bounds.columns * bounds.rows);
+	const auto chunks = fastCeil(visible.size(), points_per_chunk);
+
+	const auto columns = static_cast<double>(bounds.columns);
+	const auto rows = static_cast<double>(bounds.rows);
+
+	// neighbouring points mostly land in different bins, so relaxed atomic increments hardly ever contend
+	ThreadPool::getInstance().parallelFor(priority, chunks, [&](size_t chunk) {
+		const auto begin = chunk * points_per_chunk;
+		const auto end = std::min(begin + points_per_chunk, visible.size());
+
+		for (const auto &point : visible.subspan(begin, end - begin)) {
+			if (point.y < bounds.y_min || point.y > bounds.y_max) {
+				continue;
+			}
+
+			const auto column = std::min(static_cast<size_t>((point.x - bounds.x_min) / x_range * columns),
+										 bounds.columns - 1);
+			const auto row = std::min(static_cast<size_t>((bounds.y_max - point.y) / y_range * rows), bounds.rows - 1);
+
+			std::atomic_ref{counts[(row * bounds.columns) + column]}.fetch_add(1, std::memory_order_relaxed);
+		}
+	});
+
+	grid.counts.assign(counts.begin(), counts.end());
+	grid.max_count = std::ranges::max(grid.counts);
+
+	return grid;
+}
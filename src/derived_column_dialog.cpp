@@ -0,0 +1,62 @@
+#include "derived_column_dialog.hpp"
+
+#include <utility>
+
+#include "derived_columns.hpp"
+#include "imgui.h"
+#include "imgui_stdlib.h"
+#include "window_context.hpp"
+
+namespace {
+	constexpr auto popup_id = "Add computed column##derived_column_popup";
+}  // namespace
+
+auto openDerivedColumnPopup(WindowContext &window_context) -> void {
+	window_context.getDerivedColumnDialogStateRef().error.clear();
+	ImGui::OpenPopup(popup_id);
+}
+
+auto drawDerivedColumnPopup(WindowContext &window_context) -> void {
+	if (!ImGui::BeginPopupModal(popup_id, nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+		return;
+	}
+
+	auto &state = window_context.getDerivedColumnDialogStateRef();
+
+	ImGui::InputText("Name", &state.name);
+	ImGui::InputText("Unit", &state.unit);
+	ImGui::InputTextWithHint("Expression", "[Voltage (V)] * [Current (A)]", &state.expression);
+
+	ImGui::TextDisabled("+ - * / ^, abs, sqrt, exp, log, log10, sin, cos, tan, min, max");	// NOLINT(hicpp-vararg)
+	ImGui::TextDisabled("columns with spaces or units in square brackets");	 // NOLINT(hicpp-vararg)
+
+	if (!state.error.empty()) {
+		ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", state.error.c_str());  // NOLINT(hicpp-vararg)
+	}
+
+	ImGui::Separator();
+
+	if (ImGui::Button("Add")) {
+		auto &data = window_context.getData();
+		auto result = createDerivedColumn(data, state.name, state.unit, state.expression);
+
+		if (result) {
+			result->visible = true;
+			data.push_back(std::move(*result));
+			window_context.invalidateViewState();
+
+			state = {};
+			ImGui::CloseCurrentPopup();
+		} else {
+			state.error = result.error();
+		}
+	}
+
+	ImGui::SameLine();
+
+	if (ImGui::Button("Cancel")) {
+		ImGui::CloseCurrentPopup();
+	}
+
+	ImGui::EndPopup();
+}
@@ -0,0 +1,247 @@
+#include "derived_columns.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "dicts.hpp"
+#include "expression.hpp"
+#include "fmt/format.h"
+#include "global_state.hpp"
+#include "profiler.hpp"
+#include "spdlog/spdlog.h"
+#include "thread_pool.hpp"
+#include "time_join.hpp"
+#include "tl/expected.hpp"
+#include "utility.hpp"
+#include "uuid_generator.hpp"
+
+namespace {
+	auto findColumn(const std::vector<data_dict_t> &data, const std::string &name) -> const data_dict_t * {
+		const auto it = std::ranges::find_if(data, [&name](const auto &col) {
+			return col.name == name || (!col.unit.empty() && fmt::format("{} ({})", col.name, col.unit) == name);
+		});
+
+		return it != data.end() ? &*it : nullptr;
+	}
+}  // namespace
+
+auto createDerivedColumn(const std::vector<data_dict_t> &data, const std::string &name, const std::string &unit,
+						 const std::string &text) -> tl::expected<data_dict_t, std::string> {
+	if (name.empty()) {
+		return tl::unexpected(std::string{"name must not be empty"});
+	}
+
+	auto parsed = expression::parse(text);
+	if (!parsed) {
+		return tl::unexpected(parsed.error());
+	}
+
+	if (parsed->inputs.empty()) {
+		return tl::unexpected(std::string{"expression has to reference at least one column"});
+	}
+
+	auto derived = std::make_shared<derived_column_t>();
+	derived->expression = text;
+	derived->program = std::move(parsed->program);
+
+	for (const auto &input : parsed->inputs) {
+		const auto *col = findColumn(data, input);
+		if (col == nullptr) {
+			return tl::unexpected(fmt::format("unknown column \"{}\"", input));
+		}
+
+		derived->input_uuids.push_back(col->uuid);
+	}
+
+	data_dict_t dict{};
+	dict.name = name;
+	dict.unit = unit;
+	dict.uuid = uuids::to_string(UUIDGenerator::getInstance().generate());
+	dict.derived = std::move(derived);
+	dict.updateIDs();
+
+	return dict;
+}
+
+auto invalidateDerivedColumn(data_dict_t &dict) -> void {
+	// new vectors, jobs and other windows may still hold the previous ones
+	dict.timestamp = std::make_shared<std::vector<time_t>>();
+	dict.data = std::make_shared<std::vector<double>>();
+	dict.aggregates.reset();
+	dict.fit_zoom_calculated_for_points = 0;
+	dict.sketches.reset();
+	dict.extrema.reset();
+	dict.range_index.reset();
+	dict.derived_evaluated = false;
+}
+
+auto evaluateDerivedColumn(const derived_column_t &derived, const std::vector<data_dict_t> &inputs)
+	-> derived_samples_t {
+	std::vector<const data_dict_t *> pointers{};
+	pointers.reserve(inputs.size());
+	for (const auto &input : inputs) {
+		pointers.push_back(&input);
+	}
+
+	const auto timestamps = mergeTimestamps(pointers);
+
+	std::vector<JoinCursor> cursors{};
+	cursors.reserve(inputs.size());
+	for (const auto &input : inputs) {
+		cursors.emplace_back(input);
+	}
+
+	std::vector<std::vector<double>> batches(inputs.size(), std::vector<double>(expression::batch_size));
+	std::vector<std::span<const double>> batch_spans(inputs.size());
+	expression::Evaluator evaluator{derived.program};
+
+	derived_samples_t result{.timestamp = std::make_shared<std::vector<time_t>>(),
+							 .data = std::make_shared<std::vector<double>>()};
+	result.timestamp->reserve(timestamps.size());
+	result.data->reserve(timestamps.size());
+
+	for (size_t start = 0; start < timestamps.size(); start += expression::batch_size) {
+		const auto count = std::min(expression::batch_size, timestamps.size() - start);
+		const auto batch_timestamps = std::span{timestamps}.subspan(start, count);
+
+		for (size_t i = 0; i < inputs.size(); ++i) {
+			for (size_t j = 0; j < count; ++j) {
+				batches[i][j] = cursors[i].previous(batch_timestamps[j]);
+			}
+
+			batch_spans[i] = std::span{batches[i]}.first(count);
+		}
+
+		const auto values = evaluator.evaluate(batch_spans);
+
+		for (size_t j = 0; j < count; ++j) {
+			if (std::isfinite(values[j])) {
+				result.timestamp->push_back(batch_timestamps[j]);
+				result.data->push_back(values[j]);
+			}
+		}
+	}
+
+	result.timestamp->shrink_to_fit();
+	result.data->shrink_to_fit();
+
+	std::vector<time_t> time_deltas{};
+	time_deltas.reserve(result.timestamp->size());
+	for (size_t i = 1; i < result.timestamp->size(); ++i) {
+		time_deltas.push_back(result.timestamp->at(i) - result.timestamp->at(i - 1));
+	}
+
+	const auto is_boolean = std::ranges::all_of(*result.data, [](double v) { return v == 0 || v == 1; });
+
+	result.delta_t = calculateMedian(std::move(time_deltas));
+	result.data_type = is_boolean ? data_type_t::BOOLEAN : data_type_t::FLOAT;
+
+	return result;
+}
+
+auto DerivedColumnJobs::update(std::vector<data_dict_t> &data) -> bool {
+	bool installed{false};
+
+	for (auto it = this->jobs.begin(); it != this->jobs.end();) {
+		auto &job = it->second;
+		if (job.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++it;
+			continue;
+		}
+
+		auto samples = job.result.get();
+		const auto col = std::ranges::find(data, it->first, &data_dict_t::uuid);
+
+		// inputs replaced meanwhile, e.g. by a catalog loading other files, need another evaluation
+		const auto is_current = [&data, &job](const data_dict_t &dict) {
+			const auto unchanged = [&data](const std::string &uuid, const auto &input) {
+				const auto e = std::ranges::find(data, uuid, &data_dict_t::uuid);
+				return e != data.end() && e->data == input;
+			};
+
+			return std::ranges::equal(dict.derived->input_uuids, job.inputs, unchanged);
+		};
+
+		if (col != data.end() && !col->derived_evaluated && is_current(*col)) {
+			col->timestamp = std::move(samples.timestamp);
+			col->data = std::move(samples.data);
+			col->delta_t = samples.delta_t;
+			col->data_type = samples.data_type;
+			col->aggregates.reset();
+			col->fit_zoom_calculated_for_points = 0;
+			col->sketches.reset();
+			col->extrema.reset();
+			col->range_index.reset();
+			col->derived_evaluated = true;
+			installed = true;
+		}
+
+		it = this->jobs.erase(it);
+	}
+
+	for (auto &col : data) {
+		if (col.visible && col.derived && !col.derived_evaluated) {
+			this->start(data, col);
+		}
+	}
+
+	return installed;
+}
+
+auto DerivedColumnJobs::start(std::vector<data_dict_t> &data, data_dict_t &dict) -> void {
+	if (this->jobs.contains(dict.uuid)) {
+		return;
+	}
+
+	const auto &derived = dict.derived;
+
+	// only the vectors are shared with the job, the columns themselves may be moved or aggregated meanwhile
+	std::vector<data_dict_t> inputs{};
+	inputs.reserve(derived->input_uuids.size());
+	bool inputs_ready{true};
+
+	for (const auto &uuid : derived->input_uuids) {
+		const auto it = std::ranges::find(data, uuid, &data_dict_t::uuid);
+		if (it == data.end()) {
+			spdlog::error("input of derived column {} not found", dict.name);
+			dict.derived_evaluated = true;
+			return;
+		}
+
+		// inputs always exist before the columns derived from them, so this can not recurse endlessly
+		if (it->derived && !it->derived_evaluated) {
+			this->start(data, *it);
+			inputs_ready = false;
+			continue;
+		}
+
+		auto &copy = inputs.emplace_back();
+		copy.timestamp = it->timestamp;
+		copy.data = it->data;
+		copy.delta_t = it->delta_t;
+	}
+
+	// started again once the derived inputs are done
+	if (!inputs_ready) {
+		return;
+	}
+
+	auto &job = this->jobs[dict.uuid];
+	std::ranges::transform(inputs, std::back_inserter(job.inputs), &data_dict_t::data);
+	job.result = ThreadPool::getInstance().submit(
+		task_priority_t::visible, [derived, inputs = std::move(inputs), name = dict.name]() {
+			const profiler::ScopedTimer timer{profiler::stage::derived_columns, name};
+			auto result = evaluateDerivedColumn(*derived, inputs);
+			AppState::getInstance().wakeMainLoop();
+			return result;
+		});
+}
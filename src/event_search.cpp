@@ -0,0 +1,259 @@
+#include "event_search.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "utility.hpp"
+
+namespace {
+	// BOOLEAN columns are stored as 0 and 1
+	constexpr double edge_threshold = 0.5;
+
+	enum class block_match_t : uint8_t {
+		NONE,
+		SOME,
+		ALL
+	};
+
+	auto classifyBlock(const block_extrema_t::block_t &block, const event_query_t &query) -> block_match_t {
+		// NaN never matches, so a block with NaN can't match as a whole
+		const auto classify = [&block](bool none, bool all) {
+			if (none) {
+				return block_match_t::NONE;
+			}
+
+			return all && !block.has_nan ? block_match_t::ALL : block_match_t::SOME;
+		};
+
+		switch (query.kind) {
+			using enum event_kind_t;
+		case ABOVE:
+			return classify(block.max <= query.lower, block.min > query.lower);
+		case BELOW:
+			return classify(block.min >= query.lower, block.max < query.lower);
+		case IN_RANGE:
+			return classify(block.max < query.lower || block.min > query.upper,
+							block.min >= query.lower && block.max <= query.upper);
+		case RISING_EDGE:
+		case FALLING_EDGE:
+			// an edge between two samples of the block needs both states within it
+			return classify(block.min >= edge_threshold || block.max < edge_threshold, false);
+		}
+
+		return block_match_t::SOME;
+	}
+
+	auto matches(double value, const event_query_t &query) -> bool {
+		switch (query.kind) {
+			using enum event_kind_t;
+		case ABOVE:
+			return value > query.lower;
+		case BELOW:
+			return value < query.lower;
+		case IN_RANGE:
+			return value >= query.lower && value <= query.upper;
+		case RISING_EDGE:
+		case FALLING_EDGE:
+			return false;
+		}
+
+		return false;
+	}
+
+	auto findIntervals(std::span<const time_t> timestamps, std::span<const double> values,
+					   const block_extrema_t &extrema, const event_query_t &query, size_t first, size_t last)
+		-> event_search_result_t {
+		constexpr auto block_size = block_extrema_t::block_size;
+
+		event_search_result_t result{};
+		std::optional<size_t> begin{};
+		size_t end{0};
+
+		// returns false once max_events is reached
+		const auto close = [&]() -> bool {
+			if (!begin.has_value()) {
+				return true;
+			}
+
+			if (result.events.size() >= query.max_events) {
+				result.truncated = true;
+				return false;
+			}
+
+			result.events.push_back({.begin = timestamps[*begin], .end = timestamps[end]});
+			begin.reset();
+			return true;
+		};
+
+		for (auto block = first / block_size; block * block_size < last; ++block) {
+			const auto from = std::max(first, block * block_size);
+			const auto to = std::min(last, (block + 1) * block_size);
+			const auto match = classifyBlock(extrema.blocks[block], query);
+
+			if (match == block_match_t::NONE) {
+				++result.skipped_blocks;
+
+				if (!close()) {
+					return result;
+				}
+
+				continue;
+			}
+
+			if (match == block_match_t::ALL) {
+				++result.skipped_blocks;
+				begin = begin.value_or(from);
+				end = to - 1;
+				continue;
+			}
+
+			++result.scanned_blocks;
+
+			for (auto i = from; i < to; ++i) {
+				if (matches(values[i], query)) {
+					begin = begin.value_or(i);
+					end = i;
+				} else if (!close()) {
+					return result;
+				}
+			}
+		}
+
+		close();
+		return result;
+	}
+
+	auto findEdges(std::span<const time_t> timestamps, std::span<const double> values, const block_extrema_t &extrema,
+				   const event_query_t &query, size_t first, size_t last) -> event_search_result_t {
+		constexpr auto block_size = block_extrema_t::block_size;
+
+		event_search_result_t result{};
+		const auto rising = query.kind == event_kind_t::RISING_EDGE;
+
+		// comparisons with NaN are false, so samples next to NaN never form an edge
+		const auto is_edge = [&](size_t i) {
+			return rising ? values[i - 1] < edge_threshold && values[i] >= edge_threshold
+						  : values[i - 1] >= edge_threshold && values[i] < edge_threshold;
+		};
+
+		const auto add = [&](size_t i) -> bool {
+			if (result.events.size() >= query.max_events) {
+				result.truncated = true;
+				return false;
+			}
+
+			result.events.push_back({.begin = timestamps[i], .end = timestamps[i]});
+			return true;
+		};
+
+		for (auto block = first / block_size; block * block_size < last; ++block) {
+			const auto block_start = block * block_size;
+			auto from = std::max(first + 1, block_start);
+			const auto to = std::min(last, block_start + block_size);
+
+			if (from >= to) {
+				continue;
+			}
+
+			// the edge into the block depends on the last sample of the previous one
+			if (from == block_start) {
+				if (is_edge(from) && !add(from)) {
+					return result;
+				}
+
+				++from;
+			}
+
+			if (classifyBlock(extrema.blocks[block], query) == block_match_t::NONE) {
+				++result.skipped_blocks;
+				continue;
+			}
+
+			++result.scanned_blocks;
+
+			for (auto i = from; i < to; ++i) {
+				if (is_edge(i) && !add(i)) {
+					return result;
+				}
+			}
+		}
+
+		return result;
+	}
+}  // namespace
+
+auto buildBlockExtrema(std::span<const double> values, task_priority_t priority) -> block_extrema_t {
+	constexpr auto block_size = block_extrema_t::block_size;
+
+	block_extrema_t extrema{};
+	extrema.blocks.resize(fastCeil(values.size(), block_size));
+
+	ThreadPool::getInstance().parallelFor(priority, extrema.blocks.size(), [&](size_t i) {
+		const auto first = i * block_size;
+		const auto samples = values.subspan(first, std::min(block_size, values.size() - first));
+
+		block_extrema_t::block_t block{.min = std::numeric_limits<double>::infinity(),
+									   .max = -std::numeric_limits<double>::infinity(),
+									   .has_nan = false};
+
+		for (const auto &e : samples) {
+			if (std::isnan(e)) {
+				block.has_nan = true;
+				continue;
+			}
+
+			block.min = std::min(block.min, e);
+			block.max = std::max(block.max, e);
+		}
+
+		extrema.blocks[i] = block;
+	});
+
+	return extrema;
+}
+
+auto getEventKindName(event_kind_t kind) -> std::string_view {
+	switch (kind) {
+		using enum event_kind_t;
+	case ABOVE:
+		return "above";
+	case BELOW:
+		return "below";
+	case IN_RANGE:
+		return "in range";
+	case RISING_EDGE:
+		return "rising edge";
+	case FALLING_EDGE:
+		return "falling edge";
+	}
+
+	return "";
+}
+
+auto isEdgeEvent(event_kind_t kind) -> bool {
+	return kind == event_kind_t::RISING_EDGE || kind == event_kind_t::FALLING_EDGE;
+}
+
+auto findEvents(std::span<const time_t> timestamps, std::span<const double> values, const block_extrema_t &extrema,
+				const event_query_t &query, size_t first, size_t last) -> event_search_result_t {
+	last = std::min({last, values.size(), timestamps.size()});
+
+	if (first >= last) {
+		return {};
+	}
+
+	if (isEdgeEvent(query.kind)) {
+		return findEdges(timestamps, values, extrema, query, first, last);
+	}
+
+	return findIntervals(timestamps, values, extrema, query, first, last);
+}
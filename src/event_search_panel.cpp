@@ -0,0 +1,301 @@
+#include "event_search_panel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <future>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dicts.hpp"
+#include "event_search.hpp"
+#include "fmt/chrono.h"
+#include "fmt/format.h"
+#include "global_state.hpp"
+#include "imgui.h"
+#include "imgui_extensions.hpp"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
+#include "window_context.hpp"
+
+namespace {
+	auto formatDate(time_t timestamp) -> std::string {
+		return fmt::format("{:%Y-%m-%d %H:%M:%S}", std::chrono::sys_seconds{std::chrono::seconds{timestamp}});
+	}
+
+	auto isBusy(const event_search_panel_state_t &state) -> bool {
+		return state.job.valid() && state.job.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+	}
+
+	auto searchInBackground(const std::vector<data_dict_t> &columns, const event_query_t &query, time_t from,
+							time_t to) -> std::shared_ptr<const event_search_results_t> {
+		std::vector<event_search_result_t> found(columns.size());
+		std::vector<std::shared_ptr<const block_extrema_t>> extrema(columns.size());
+		ThreadPool::getInstance().parallelFor(task_priority_t::visible, columns.size(), [&](size_t i) {
+			const auto &col = columns[i];
+			const profiler::ScopedTimer timer{profiler::stage::event_search, col.uuid};
+
+			extrema[i] = col.extrema != nullptr ? col.extrema
+												: std::make_shared<const block_extrema_t>(buildBlockExtrema(*col.data));
+
+			const auto &timestamps = *col.timestamp;
+			const auto first = std::ranges::lower_bound(timestamps, from) - timestamps.begin();
+			const auto last = std::ranges::upper_bound(timestamps, to) - timestamps.begin();
+
+			found[i] = findEvents(timestamps, *col.data, *extrema[i], query, static_cast<size_t>(first),
+								  static_cast<size_t>(last));
+		});
+
+		auto result = std::make_shared<event_search_results_t>();
+
+		for (size_t i = 0; i < columns.size(); ++i) {
+			result->names.push_back(columns[i].name);
+			result->uuids.push_back(columns[i].uuid);
+			result->extrema.push_back(extrema[i]);
+			result->sources.push_back(columns[i].data);
+
+			for (const auto &e : found[i].events) {
+				result->events.push_back({.column = i, .begin = e.begin, .end = e.end});
+			}
+
+			result->truncated_columns += found[i].truncated ? 1 : 0;
+			result->scanned_blocks += found[i].scanned_blocks;
+			result->skipped_blocks += found[i].skipped_blocks;
+		}
+
+		std::ranges::stable_sort(result->events, {}, &found_event_t::begin);
+
+		AppState::getInstance().wakeMainLoop();
+		return result;
+	}
+
+	auto startSearch(WindowContext &window_context) -> void {
+		auto &state = window_context.getEventSearchPanelStateRef();
+		if (isBusy(state)) {
+			return;
+		}
+
+		const auto &data = window_context.getData();
+		const auto data_type = isEdgeEvent(state.query.kind) ? data_type_t::BOOLEAN : data_type_t::FLOAT;
+		std::vector<size_t> indices{};
+
+		if (state.all_columns) {
+			indices.resize(data.size());
+			std::iota(indices.begin(), indices.end(), 0uz);
+		} else {
+			indices = window_context.getViewState().visible_columns;
+		}
+
+		// only the vectors are shared with the job, the columns themselves may be moved or aggregated meanwhile
+		std::vector<data_dict_t> columns{};
+		for (const auto &i : indices) {
+			const auto &col = data[i];
+			if (col.data_type != data_type || col.data->empty()) {
+				continue;
+			}
+
+			auto &copy = columns.emplace_back();
+			copy.name = col.name;
+			copy.uuid = col.uuid;
+			copy.timestamp = col.timestamp;
+			copy.data = col.data;
+			copy.extrema = col.extrema;
+		}
+
+		auto from = std::numeric_limits<time_t>::min();
+		auto to = std::numeric_limits<time_t>::max();
+
+		if (state.visible_range_only) {
+			const auto [x_min, x_max] = window_context.getVisibleXRange();
+			from = static_cast<time_t>(std::floor(x_min));
+			to = static_cast<time_t>(std::ceil(x_max));
+		}
+
+		state.selected.reset();
+		state.job = ThreadPool::getInstance().submit(
+			task_priority_t::visible, [columns = std::move(columns), query = state.query, from, to]() {
+				return searchInBackground(columns, query, from, to);
+			});
+	}
+
+	auto checkForFinishedSearch(std::vector<data_dict_t> &data, event_search_panel_state_t &state) -> void {
+		if (!state.job.valid() || isBusy(state)) {
+			return;
+		}
+
+		state.result = state.job.get();
+
+		// the samples of a column may have been replaced while searching, the summaries would not match them
+		for (size_t i = 0; i < state.result->uuids.size(); ++i) {
+			const auto it = std::ranges::find(data, state.result->uuids[i], &data_dict_t::uuid);
+			if (it != data.end() && it->extrema == nullptr && it->data == state.result->sources[i]) {
+				it->extrema = state.result->extrema[i];
+			}
+		}
+	}
+
+	auto zoomToEvent(WindowContext &window_context, const std::string &uuid, const found_event_t &event) -> void {
+		auto &data = window_context.getData();
+		const auto it = std::ranges::find(data, uuid, &data_dict_t::uuid);
+		if (it == data.end()) {
+			return;
+		}
+
+		if (!it->visible) {
+			it->visible = true;
+			window_context.invalidateViewState();
+		}
+
+		// some context around the event, edges and single samples would otherwise collapse the range
+		const auto duration = static_cast<double>(event.end - event.begin);
+		const auto padding = std::max(duration / 2.0, static_cast<double>(std::max(it->delta_t * 10, time_t{1})));
+		const auto x_min = static_cast<double>(event.begin) - padding;
+		const auto x_max = static_cast<double>(event.end) + padding;
+
+		if (window_context.getGlobalXLink()) {
+			AppState::getInstance().global_link = {x_min, x_max};
+		}
+
+		window_context.requestXRange(x_min, x_max);
+	}
+
+	auto drawQuery(event_search_panel_state_t &state) -> void {
+		auto &query = state.query;
+
+		ImGui::SetNextItemWidth(120.0f);
+		if (ImGui::BeginCombo("Event", getEventKindName(query.kind).data())) {
+			for (const auto &kind : event_kinds) {
+				if (ImGui::Selectable(getEventKindName(kind).data(), kind == query.kind)) {
+					query.kind = kind;
+				}
+			}
+
+			ImGui::EndCombo();
+		}
+
+		if (!isEdgeEvent(query.kind)) {
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(100.0f);
+			ImGui::InputDouble(query.kind == event_kind_t::IN_RANGE ? "to##lower" : "Threshold", &query.lower);
+
+			if (query.kind == event_kind_t::IN_RANGE) {
+				ImGui::SameLine();
+				ImGui::SetNextItemWidth(100.0f);
+				ImGui::InputDouble("##upper", &query.upper);
+			}
+		}
+
+		ImGui::Checkbox("All columns", &state.all_columns);
+		ImGui::SetItemTooltip("Searches all columns instead of the visible ones");
+		ImGui::SameLine();
+		ImGui::Checkbox("Visible range only", &state.visible_range_only);
+	}
+
+	auto drawResults(WindowContext &window_context, event_search_panel_state_t &state) -> void {
+		const auto &result = *state.result;
+
+		static constexpr auto table_flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY |
+											ImGuiTableFlags_Resizable;
+
+		if (!ImGui::BeginTable("##events", 4, table_flags)) {
+			return;
+		}
+
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Column");
+		ImGui::TableSetupColumn("Begin");
+		ImGui::TableSetupColumn("End");
+		ImGui::TableSetupColumn("Duration");
+		ImGui::TableHeadersRow();
+
+		ImGuiListClipper clipper;
+		clipper.Begin(static_cast<int>(result.events.size()));
+
+		while (clipper.Step()) {
+			for (auto i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+				const auto index = static_cast<size_t>(i);
+				const auto &event = result.events[index];
+				const auto &uuid = result.uuids[event.column];
+
+				ImGui::PushID(i);
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+
+				if (ImGui::Selectable(result.names[event.column].c_str(), state.selected == index,
+									  ImGuiSelectableFlags_SpanAllColumns)) {
+					state.selected = index;
+					zoomToEvent(window_context, uuid, event);
+				}
+
+				ImGui::TableNextColumn();
+				ImGuiExt::TextUnformatted(formatDate(event.begin));
+				ImGui::TableNextColumn();
+				ImGuiExt::TextUnformatted(formatDate(event.end));
+				ImGui::TableNextColumn();
+				ImGuiExt::TextFormatted("{} s", event.end - event.begin);
+				ImGui::PopID();
+			}
+		}
+
+		ImGui::EndTable();
+	}
+}  // namespace
+
+auto openEventSearchWindow(WindowContext &window_context) -> void {
+	window_context.getEventSearchPanelStateRef().open = true;
+}
+
+auto drawEventSearchWindow(WindowContext &window_context) -> void {
+	auto &state = window_context.getEventSearchPanelStateRef();
+
+	// the block summaries are handed to the columns even if the window gets closed meanwhile
+	checkForFinishedSearch(window_context.getData(), state);
+
+	if (!state.open) {
+		return;
+	}
+
+	const auto title = fmt::format("Event search - {}##event_search{}", window_context.getWindowTitle(),
+								   window_context.getUUID());
+
+	ImGui::SetNextWindowSize(ImVec2(600, 450), ImGuiCond_FirstUseEver);
+	if (!ImGui::Begin(title.c_str(), &state.open)) {
+		ImGui::End();
+		return;
+	}
+
+	drawQuery(state);
+
+	const auto busy = isBusy(state);
+
+	ImGui::BeginDisabled(busy);
+	if (ImGui::Button("Search")) {
+		startSearch(window_context);
+	}
+	ImGui::EndDisabled();
+
+	ImGui::SameLine();
+
+	if (busy) {
+		ImGuiExt::TextFormattedDisabled("searching...");
+	} else if (state.result != nullptr) {
+		const auto &result = *state.result;
+		const auto total_blocks = result.scanned_blocks + result.skipped_blocks;
+
+		ImGuiExt::TextFormattedDisabled("{} events in {} columns, {} of {} blocks skipped{}", result.events.size(),
+										result.names.size(), result.skipped_blocks, total_blocks,
+										result.truncated_columns > 0 ? ", limited per column" : "");
+	}
+
+	if (state.result != nullptr) {
+		drawResults(window_context, state);
+	}
+
+	ImGui::End();
+}
@@ -0,0 +1,173 @@
+#include "export_dialog.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "csv_handling.hpp"
+#include "data_export.hpp"
+#include "dicts.hpp"
+#include "file_dialog.hpp"
+#include "global_state.hpp"
+#include "fmt/chrono.h"
+#include "fmt/format.h"
+#include "imgui.h"
+#include "imgui_extensions.hpp"
+#include "imgui_stdlib.h"
+#include "spdlog/spdlog.h"
+#include "thread_pool.hpp"
+#include "window_context.hpp"
+
+namespace {
+	constexpr auto popup_id = "Export##export_popup";
+
+	auto formatDate(double timestamp) -> std::string {
+		return fmt::format("{:%Y-%m-%d %H:%M:%S}",
+						   std::chrono::sys_seconds{std::chrono::seconds{static_cast<time_t>(timestamp)}});
+	}
+
+	auto isBusy(const export_dialog_state_t &state) -> bool {
+		return state.job.valid() && state.job.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+	}
+
+	auto startExport(WindowContext &window_context, const std::filesystem::path &path) -> void {
+		auto &state = window_context.getExportDialogStateRef();
+		const auto &data = window_context.getData();
+
+		// only the vectors are shared with the job, the columns themselves may be moved or aggregated meanwhile
+		std::vector<data_dict_t> columns{};
+		for (const auto &i : window_context.getViewState().visible_columns) {
+			const auto &col = data[i];
+
+			auto &copy = columns.emplace_back();
+			copy.name = col.name;
+			copy.unit = col.unit;
+			copy.timestamp = col.timestamp;
+			copy.data = col.data;
+		}
+
+		state.job = ThreadPool::getInstance().submit(
+			task_priority_t::visible, [columns = std::move(columns), settings = state.settings, path]() {
+				std::vector<const data_dict_t *> pointers{};
+				for (const auto &col : columns) {
+					pointers.push_back(&col);
+				}
+
+				const auto written = exportResampled(pointers, settings, path);
+				AppState::getInstance().wakeMainLoop();
+				return written;
+			});
+	}
+
+	// returns true once the file was written
+	auto checkForFinishedExport(export_dialog_state_t &state) -> bool {
+		if (!state.job.valid() || isBusy(state)) {
+			return false;
+		}
+
+		try {
+			return state.job.get();
+		} catch (const std::exception &e) {
+			spdlog::error("{}", e.what());
+			return false;
+		}
+	}
+}  // namespace
+
+auto openExportPopup(WindowContext &window_context) -> void {
+	auto &state = window_context.getExportDialogStateRef();
+	if (window_context.getViewState().has_visible_data) {
+		const auto [x_min, x_max] = window_context.getVisibleXRange();
+		state.from = formatDate(x_min);
+		state.to = formatDate(x_max);
+	}
+
+	ImGui::OpenPopup(popup_id);
+}
+
+auto drawExportPopup(WindowContext &window_context) -> void {
+	if (!ImGui::BeginPopupModal(popup_id, nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+		return;
+	}
+
+	auto &state = window_context.getExportDialogStateRef();
+	auto &settings = state.settings;
+	const auto &view_state = window_context.getViewState();
+
+	if (checkForFinishedExport(state)) {
+		ImGui::CloseCurrentPopup();
+		ImGui::EndPopup();
+		return;
+	}
+
+	const auto busy = isBusy(state);
+
+	ImGuiExt::TextFormatted("{} visible columns", view_state.visible_columns.size());
+	ImGui::Separator();
+
+	ImGui::InputText("From", &state.from);
+	ImGui::InputText("To", &state.to);
+
+	auto interval = static_cast<int>(settings.interval);
+	if (ImGui::InputInt("Interval [s]", &interval, 1, 60)) {
+		settings.interval = std::max(1, interval);
+	}
+
+	static constexpr auto statistics = std::array{export_statistic_t::MEAN, export_statistic_t::MIN,
+												  export_statistic_t::MAX, export_statistic_t::FIRST};
+
+	if (ImGui::BeginCombo("Statistic", getStatisticName(settings.statistic).data())) {
+		for (const auto &statistic : statistics) {
+			if (ImGui::Selectable(getStatisticName(statistic).data(), statistic == settings.statistic)) {
+				settings.statistic = statistic;
+			}
+		}
+		ImGui::EndCombo();
+	}
+
+	auto format = static_cast<int>(settings.format);
+	ImGui::RadioButton("CSV", &format, static_cast<int>(export_format_t::CSV));
+	ImGui::SameLine();
+	ImGui::RadioButton("Binary", &format, static_cast<int>(export_format_t::BINARY));
+	settings.format = static_cast<export_format_t>(format);
+
+	ImGui::Separator();
+
+	ImGui::BeginDisabled(busy || view_state.visible_columns.empty());
+	if (ImGui::Button("Export...")) {
+		try {
+			size_t prefered_fmt{0};
+			settings.from = parseDate(state.from, prefered_fmt);
+			settings.to = parseDate(state.to, prefered_fmt);
+
+			const auto is_csv = settings.format == export_format_t::CSV;
+			const auto path = selectSaveFileFromDialog(is_csv ? "CSV" : "Binary", is_csv ? "csv" : "bin");
+
+			if (path) {
+				startExport(window_context, *path);
+			}
+		} catch (const std::exception &e) {
+			spdlog::error("{}", e.what());
+		}
+	}
+	ImGui::EndDisabled();
+
+	if (busy) {
+		ImGui::SameLine();
+		ImGui::TextDisabled("exporting...");  // NOLINT(hicpp-vararg)
+	}
+
+	ImGui::SameLine();
+
+	if (ImGui::Button("Cancel")) {
+		ImGui::CloseCurrentPopup();
+	}
+
+	ImGui::EndPopup();
+}
@@ -0,0 +1,358 @@
+#include "expression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "fmt/format.h"
+#include "tl/expected.hpp"
+
+namespace expression {
+	namespace {
+		struct function_t {
+			std::string_view name;
+			opcode_t op;
+			size_t arguments;
+		};
+
+		constexpr auto functions = std::array{
+			function_t{.name = "abs", .op = opcode_t::abs, .arguments = 1},
+			function_t{.name = "sqrt", .op = opcode_t::sqrt, .arguments = 1},
+			function_t{.name = "exp", .op = opcode_t::exp, .arguments = 1},
+			function_t{.name = "log", .op = opcode_t::log, .arguments = 1},
+			function_t{.name = "log10", .op = opcode_t::log10, .arguments = 1},
+			function_t{.name = "sin", .op = opcode_t::sin, .arguments = 1},
+			function_t{.name = "cos", .op = opcode_t::cos, .arguments = 1},
+			function_t{.name = "tan", .op = opcode_t::tan, .arguments = 1},
+			function_t{.name = "min", .op = opcode_t::min, .arguments = 2},
+			function_t{.name = "max", .op = opcode_t::max, .arguments = 2},
+		};
+
+		// recursive descent parser emitting postfix instructions while it goes
+		class Parser {
+		public:
+			explicit Parser(std::string_view input) : text{input} {}
+
+			auto run() -> tl::expected<parse_result_t, std::string> {
+				this->parseSum();
+
+				this->skipWhitespace();
+				if (this->error.empty() && this->pos < this->text.size()) {
+					this->fail(fmt::format("unexpected '{}'", this->text[this->pos]));
+				}
+
+				if (!this->error.empty()) {
+					return tl::unexpected(this->error);
+				}
+
+				this->result.program.input_count = this->result.inputs.size();
+				return std::move(this->result);
+			}
+
+		private:
+			auto fail(const std::string &message) -> void {
+				if (this->error.empty()) {
+					this->error = fmt::format("{} at position {}", message, this->pos + 1);
+				}
+			}
+
+			auto skipWhitespace() -> void {
+				while (this->pos < this->text.size() &&
+					   std::isspace(static_cast<unsigned char>(this->text[this->pos])) != 0) {
+					++this->pos;
+				}
+			}
+
+			auto accept(char c) -> bool {
+				this->skipWhitespace();
+				if (this->pos < this->text.size() && this->text[this->pos] == c) {
+					++this->pos;
+					return true;
+				}
+
+				return false;
+			}
+
+			auto emit(instruction_t instruction, int stack_change) -> void {
+				this->result.program.instructions.push_back(instruction);
+				this->depth = static_cast<size_t>(static_cast<int>(this->depth) + stack_change);
+				this->result.program.max_stack_depth = std::max(this->result.program.max_stack_depth, this->depth);
+			}
+
+			auto pushInput(const std::string &name) -> void {
+				const auto it = std::ranges::find(this->result.inputs, name);
+				const auto index = static_cast<size_t>(it - this->result.inputs.begin());
+
+				if (it == this->result.inputs.end()) {
+					this->result.inputs.push_back(name);
+				}
+
+				this->emit({.op = opcode_t::push_input, .input = index}, 1);
+			}
+
+			auto parseSum() -> void {
+				this->parseProduct();
+
+				while (this->error.empty()) {
+					if (this->accept('+')) {
+						this->parseProduct();
+						this->emit({.op = opcode_t::add}, -1);
+					} else if (this->accept('-')) {
+						this->parseProduct();
+						this->emit({.op = opcode_t::subtract}, -1);
+					} else {
+						break;
+					}
+				}
+			}
+
+			auto parseProduct() -> void {
+				this->parseUnary();
+
+				while (this->error.empty()) {
+					if (this->accept('*')) {
+						this->parseUnary();
+						this->emit({.op = opcode_t::multiply}, -1);
+					} else if (this->accept('/')) {
+						this->parseUnary();
+						this->emit({.op = opcode_t::divide}, -1);
+					} else {
+						break;
+					}
+				}
+			}
+
+			auto parseUnary() -> void {
+				if (this->accept('-')) {
+					this->parseUnary();
+					this->emit({.op = opcode_t::negate}, 0);
+				} else if (this->accept('+')) {
+					this->parseUnary();
+				} else {
+					this->parsePower();
+				}
+			}
+
+			auto parsePower() -> void {
+				this->parsePrimary();
+
+				// right associative, binds tighter than unary minus on its left: -2^2 = -4
+				if (this->error.empty() && this->accept('^')) {
+					this->parseUnary();
+					this->emit({.op = opcode_t::power}, -1);
+				}
+			}
+
+			auto parseFunction(std::string_view name) -> void {
+				const auto it = std::ranges::find(functions, name, &function_t::name);
+
+				if (it == functions.end()) {
+					this->fail(fmt::format("unknown function \"{}\"", name));
+					return;
+				}
+
+				for (size_t i = 0; i < it->arguments; ++i) {
+					if (i > 0 && !this->accept(',')) {
+						this->fail(fmt::format("{}() expects {} arguments", name, it->arguments));
+						return;
+					}
+
+					this->parseSum();
+					if (!this->error.empty()) {
+						return;
+					}
+				}
+
+				if (!this->accept(')')) {
+					this->fail("expected ')'");
+					return;
+				}
+
+				this->emit({.op = it->op}, 1 - static_cast<int>(it->arguments));
+			}
+
+			auto parsePrimary() -> void {
+				this->skipWhitespace();
+
+				if (this->pos >= this->text.size()) {
+					this->fail("unexpected end of expression");
+					return;
+				}
+
+				const auto c = this->text[this->pos];
+
+				if (this->accept('(')) {
+					this->parseSum();
+					if (!this->accept(')')) {
+						this->fail("expected ')'");
+					}
+					return;
+				}
+
+				if (c == '[') {
+					const auto end = this->text.find(']', this->pos);
+					if (end == std::string_view::npos) {
+						this->fail("expected ']'");
+						return;
+					}
+
+					this->pushInput(std::string(this->text.substr(this->pos + 1, end - this->pos - 1)));
+					this->pos = end + 1;
+					return;
+				}
+
+				if (std::isdigit(static_cast<unsigned char>(c)) != 0 || c == '.') {
+					double value{0};
+					const auto *begin = this->text.data() + this->pos;
+					const auto [ptr, ec] = std::from_chars(begin, this->text.data() + this->text.size(), value);
+
+					if (ec != std::errc()) {
+						this->fail("invalid number");
+						return;
+					}
+
+					this->pos += static_cast<size_t>(ptr - begin);
+					this->emit({.op = opcode_t::push_constant, .constant = value}, 1);
+					return;
+				}
+
+				if (std::isalpha(static_cast<unsigned char>(c)) != 0 || c == '_') {
+					const auto start = this->pos;
+					while (this->pos < this->text.size() &&
+						   (std::isalnum(static_cast<unsigned char>(this->text[this->pos])) != 0 ||
+							this->text[this->pos] == '_' || this->text[this->pos] == '.')) {
+						++this->pos;
+					}
+
+					const auto identifier = this->text.substr(start, this->pos - start);
+
+					if (this->accept('(')) {
+						this->parseFunction(identifier);
+					} else {
+						this->pushInput(std::string(identifier));
+					}
+					return;
+				}
+
+				this->fail(fmt::format("unexpected '{}'", c));
+			}
+
+			std::string_view text;
+			size_t pos{0};
+			size_t depth{0};
+			std::string error{};
+			parse_result_t result{};
+		};
+
+		template <typename F>
+		auto applyUnary(std::span<double> values, F fn) -> void {
+			for (auto &e : values) {
+				e = fn(e);
+			}
+		}
+
+		template <typename F>
+		auto applyBinary(std::span<double> lhs, std::span<const double> rhs, F fn) -> void {
+			for (size_t i = 0; i < lhs.size(); ++i) {
+				lhs[i] = fn(lhs[i], rhs[i]);
+			}
+		}
+	}  // namespace
+
+	auto parse(std::string_view text) -> tl::expected<parse_result_t, std::string> {
+		return Parser{text}.run();
+	}
+
+	Evaluator::Evaluator(const program_t &compiled_program) : program{compiled_program} {
+		this->stack.resize(compiled_program.max_stack_depth);
+
+		for (auto &e : this->stack) {
+			e.resize(batch_size);
+		}
+	}
+
+	auto Evaluator::evaluate(std::span<const std::span<const double>> inputs) -> std::span<const double> {
+		const auto count = inputs.empty() ? batch_size : inputs.front().size();
+		size_t top{0};
+
+		const auto at = [this, count](size_t index) { return std::span{this->stack[index]}.first(count); };
+
+		for (const auto &instruction : this->program.instructions) {
+			switch (instruction.op) {
+			case opcode_t::push_input:
+				std::ranges::copy(inputs[instruction.input], at(top).begin());
+				++top;
+				break;
+			case opcode_t::push_constant:
+				std::ranges::fill(at(top), instruction.constant);
+				++top;
+				break;
+			case opcode_t::add:
+				--top;
+				applyBinary(at(top - 1), at(top), [](double a, double b) { return a + b; });
+				break;
+			case opcode_t::subtract:
+				--top;
+				applyBinary(at(top - 1), at(top), [](double a, double b) { return a - b; });
+				break;
+			case opcode_t::multiply:
+				--top;
+				applyBinary(at(top - 1), at(top), [](double a, double b) { return a * b; });
+				break;
+			case opcode_t::divide:
+				--top;
+				applyBinary(at(top - 1), at(top), [](double a, double b) { return a / b; });
+				break;
+			case opcode_t::power:
+				--top;
+				applyBinary(at(top - 1), at(top), [](double a, double b) { return std::pow(a, b); });
+				break;
+			case opcode_t::min:
+				--top;
+				applyBinary(at(top - 1), at(top), [](double a, double b) { return std::min(a, b); });
+				break;
+			case opcode_t::max:
+				--top;
+				applyBinary(at(top - 1), at(top), [](double a, double b) { return std::max(a, b); });
+				break;
+			case opcode_t::negate:
+				applyUnary(at(top - 1), [](double a) { return -a; });
+				break;
+			case opcode_t::abs:
+				applyUnary(at(top - 1), [](double a) { return std::abs(a); });
+				break;
+			case opcode_t::sqrt:
+				applyUnary(at(top - 1), [](double a) { return std::sqrt(a); });
+				break;
+			case opcode_t::exp:
+				applyUnary(at(top - 1), [](double a) { return std::exp(a); });
+				break;
+			case opcode_t::log:
+				applyUnary(at(top - 1), [](double a) { return std::log(a); });
+				break;
+			case opcode_t::log10:
+				applyUnary(at(top - 1), [](double a) { return std::log10(a); });
+				break;
+			case opcode_t::sin:
+				applyUnary(at(top - 1), [](double a) { return std::sin(a); });
+				break;
+			case opcode_t::cos:
+				applyUnary(at(top - 1), [](double a) { return std::cos(a); });
+				break;
+			case opcode_t::tan:
+				applyUnary(at(top - 1), [](double a) { return std::tan(a); });
+				break;
+			}
+		}
+
+		return at(0);
+	}
+}  // namespace expression
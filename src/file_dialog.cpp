@@ -2,6 +2,8 @@
 
 #include <array>
 #include <filesystem>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include "nfd.hpp"
@@ -42,4 +44,27 @@ auto selectFilesFromDialog(bool select_folder) -> std::vector<std::filesystem::p
 	}
 
 	return {};
-}
\ No newline at end of file
+}
+
+auto selectSaveFileFromDialog(const std::string &filter_name, const std::string &extension)
+	-> std::optional<std::filesystem::path> {
+	const NFD::Guard nfd_guard{};
+	NFD::UniquePath out_path{};
+
+	const auto filters = std::array<nfdfilteritem_t, 1>{nfdfilteritem_t{filter_name.c_str(), extension.c_str()}};
+	const auto default_name = "export." + extension;
+
+	const auto result = NFD::SaveDialog(out_path, filters.data(), filters.size(), nullptr, default_name.c_str());
+
+	if (result == NFD_OKAY) {
+		return std::filesystem::path(out_path.get());
+	}
+
+	if (result == NFD_CANCEL) {
+		spdlog::debug("User pressed cancel.");
+	} else {
+		spdlog::error("Error: {}", NFD::GetError());
+	}
+
+	return std::nullopt;
+}
@@ -0,0 +1,200 @@
+#include "histogram_panel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "column_sketches.hpp"
+#include "dicts.hpp"
+#include "fmt/format.h"
+#include "global_state.hpp"
+#include "imgui.h"
+#include "imgui_extensions.hpp"
+#include "implot.h"
+#include "thread_pool.hpp"
+#include "window_context.hpp"
+
+namespace {
+	constexpr auto quantiles = std::array{0.01, 0.5, 0.99};
+
+	auto findColumn(std::vector<data_dict_t> &data, const std::string &uuid) -> data_dict_t * {
+		const auto it = std::ranges::find(data, uuid, &data_dict_t::uuid);
+		return it != data.end() ? &*it : nullptr;
+	}
+
+	auto isBusy(const histogram_panel_state_t &state) -> bool {
+		return state.job.valid() && state.job.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+	}
+
+	auto checkForFinishedJob(std::vector<data_dict_t> &data, histogram_panel_state_t &state) -> void {
+		if (!state.job.valid() || isBusy(state)) {
+			return;
+		}
+
+		auto sketches = state.job.get();
+		const auto job_data = std::move(state.job_data);
+
+		// the samples of the column may have been replaced meanwhile, the sketches would not match them
+		if (auto *column = findColumn(data, state.job_uuid); column != nullptr && column->data == job_data) {
+			column->sketches = std::move(sketches);
+		}
+	}
+
+	auto startBuilding(const data_dict_t &column, histogram_panel_state_t &state) -> void {
+		if (state.job.valid()) {
+			return;
+		}
+
+		state.job_uuid = column.uuid;
+		state.job_data = column.data;
+		state.job = ThreadPool::getInstance().submit(task_priority_t::visible, [values = column.data]() {
+			auto result = std::make_shared<const column_sketches_t>(buildColumnSketches(*values));
+			AppState::getInstance().wakeMainLoop();
+			return result;
+		});
+	}
+
+	auto updateResult(const data_dict_t &column, size_t first, size_t last, histogram_panel_state_t &state) -> void {
+		if (state.result_uuid == column.uuid && state.result_sketches == column.sketches &&
+			state.result_first == first && state.result_last == last) {
+			return;
+		}
+
+		const auto &sketches = *column.sketches;
+		state.result = queryDistribution(*column.data, sketches, first, last);
+		state.result_uuid = column.uuid;
+		state.result_sketches = column.sketches;
+		state.result_first = first;
+		state.result_last = last;
+
+		for (size_t i = 0; i < quantiles.size(); ++i) {
+			state.percentiles[i] = state.result.digest.quantile(quantiles[i]);
+		}
+
+		// only the occupied part of the column wide bins, so zooming into a narrow range still shows a useful plot
+		const auto &histogram = state.result.histogram;
+		const auto first_bin = static_cast<size_t>(std::distance(
+			histogram.begin(), std::ranges::find_if(histogram, [](uint64_t e) { return e > 0; })));
+		const auto last_bin = static_cast<size_t>(std::distance(
+			std::ranges::find_if(histogram | std::views::reverse, [](uint64_t e) { return e > 0; }),
+			histogram.rend()));
+
+		state.bin_width = sketches.getBinEdge(1) - sketches.getBinEdge(0);
+		state.bin_centers.clear();
+		state.bin_counts.clear();
+
+		for (auto i = first_bin; i < last_bin; ++i) {
+			state.bin_centers.push_back(sketches.getBinEdge(i) + (state.bin_width / 2.0));
+			state.bin_counts.push_back(static_cast<double>(histogram[i]));
+		}
+	}
+
+	auto drawHistogram(const data_dict_t &column, const histogram_panel_state_t &state) -> void {
+		if (!ImPlot::BeginPlot("##histogram", ImVec2(-1, -1))) {
+			return;
+		}
+
+		const auto x_label = column.unit.empty() ? column.name : fmt::format("{} [{}]", column.name, column.unit);
+		ImPlot::SetupAxes(x_label.c_str(), "count", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+
+		ImPlot::PlotBars(column.name.c_str(), state.bin_centers.data(), state.bin_counts.data(),
+						 static_cast<int>(state.bin_centers.size()), state.bin_width);
+		ImPlot::PlotInfLines("p1 / p50 / p99", state.percentiles.data(), static_cast<int>(state.percentiles.size()));
+
+		ImPlot::EndPlot();
+	}
+}  // namespace
+
+auto openHistogramWindow(WindowContext &window_context) -> void {
+	auto &state = window_context.getHistogramPanelStateRef();
+	auto &data = window_context.getData();
+	state.open = true;
+
+	if (findColumn(data, state.column_uuid) != nullptr) {
+		return;
+	}
+
+	for (const auto &index : window_context.getViewState().visible_columns) {
+		if (data[index].data_type == data_type_t::FLOAT) {
+			state.column_uuid = data[index].uuid;
+			break;
+		}
+	}
+}
+
+auto drawHistogramWindow(WindowContext &window_context) -> void {
+	auto &state = window_context.getHistogramPanelStateRef();
+	auto &data = window_context.getData();
+
+	// the summaries stay with the column even if the window gets closed meanwhile
+	checkForFinishedJob(data, state);
+
+	if (!state.open) {
+		return;
+	}
+
+	const auto title = fmt::format("Histogram - {}##histogram{}", window_context.getWindowTitle(),
+								   window_context.getUUID());
+
+	ImGui::SetNextWindowSize(ImVec2(600, 400), ImGuiCond_FirstUseEver);
+	if (!ImGui::Begin(title.c_str(), &state.open)) {
+		ImGui::End();
+		return;
+	}
+
+	ImGui::SetNextItemWidth(250.0f);
+	ImGuiExt::FloatColumnCombo("Column", data, state.column_uuid);
+	ImGui::SameLine();
+	ImGui::Checkbox("Percentile band in plot", &state.show_band);
+	ImGui::SetItemTooltip("Shades p1 to p99 of the visible range and marks the median");
+
+	const auto *column = findColumn(data, state.column_uuid);
+
+	if (column == nullptr) {
+		ImGui::TextUnformatted("Select a column.");
+		ImGui::End();
+		return;
+	}
+
+	if (column->sketches == nullptr) {
+		startBuilding(*column, state);
+		ImGuiExt::TextFormattedDisabled("building summaries...");
+		ImGui::End();
+		return;
+	}
+
+	const auto &timestamps = *column->timestamp;
+	const auto [x_min, x_max] = window_context.getVisibleXRange();
+	const auto first = std::ranges::lower_bound(timestamps, static_cast<time_t>(std::floor(x_min))) -
+					   timestamps.begin();
+	const auto last = std::ranges::upper_bound(timestamps, static_cast<time_t>(std::ceil(x_max))) - timestamps.begin();
+
+	updateResult(*column, static_cast<size_t>(first), static_cast<size_t>(last), state);
+
+	const auto &digest = state.result.digest;
+	if (digest.count() <= 0.0) {
+		ImGuiExt::TextFormattedDisabled("no samples in range");
+		ImGui::End();
+		return;
+	}
+
+	ImGuiExt::TextFormattedDisabled("n = {:g}, min {:g}, p1 {:g}, p50 {:g}, p99 {:g}, max {:g}", digest.count(),
+									digest.min(), state.percentiles[0], state.percentiles[1], state.percentiles[2],
+									digest.max());
+
+	window_context.switchToImPlotContext();
+	drawHistogram(*column, state);
+
+	ImGui::End();
+}
@@ -1,5 +1,10 @@
 #include "imgui_extensions.hpp"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "dicts.hpp"
 #include "imgui.h"
 #include "imgui_internal.h"
 
@@ -99,5 +104,30 @@ namespace ImGuiExt {
 	auto EndSubWindow() -> void {
 		ImGui::EndChild();
 	}
+
+	auto FloatColumnCombo(const char *label, const std::vector<data_dict_t> &data, std::string &uuid) -> bool {
+		const auto selected = std::ranges::find(data, uuid, &data_dict_t::uuid);
+		const auto *preview = selected != data.end() ? selected->name.c_str() : "";
+		bool changed{false};
+
+		if (!ImGui::BeginCombo(label, preview)) {
+			return false;
+		}
+
+		for (const auto &col : data) {
+			if (col.data_type != data_type_t::FLOAT || col.data->empty()) {
+				continue;
+			}
+
+			if (ImGui::Selectable(col.ids.label.c_str(), col.uuid == uuid)) {
+				changed = col.uuid != uuid;
+				uuid = col.uuid;
+			}
+		}
+
+		ImGui::EndCombo();
+		return changed;
+	}
+
 	// NOLINTEND(readability-identifier-naming)
 }  // namespace ImGuiExt
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
 #include <ctime>
@@ -5,6 +6,7 @@
 #include <filesystem>
 #include <list>
 #include <ranges>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -14,6 +16,7 @@
 #include "SDL3/SDL_opengl.h"
 #include "SDL3_image/SDL_image.h"
 #include "about_screen.hpp"
+#include "allocation_counter.hpp"
 #include "backends/imgui_impl_sdl3.h"
 #include "backends/imgui_impl_sdlrenderer3.h"
 #include "cxxopts.hpp"
@@ -24,16 +27,31 @@
 #include "spdlog/spdlog.h"
 
 // Own headers
+#include "catalog_panel.hpp"
+#include "cli_commands.hpp"
+#include "correlation_panel.hpp"
 #include "csv_handling.hpp"
 #include "custom_type_traits.hpp"
+#include "debug_menu.hpp"
+#include "derived_column_dialog.hpp"
 #include "dicts.hpp"
+#include "event_search_panel.hpp"
+#include "export_dialog.hpp"
 #include "file_dialog.hpp"
 #include "fonts.hpp"
 #include "global_state.hpp"
+#include "histogram_panel.hpp"
 #include "imgui_extensions.hpp"
+#include "memory_usage.hpp"
 #include "plotting.hpp"
+#include "profiler.hpp"
+#include "rolling_statistics.hpp"
+#include "spectrum_panel.hpp"
+#include "statistics_panel.hpp"
+#include "thread_pool.hpp"
 #include "winapi.hpp"
 #include "window_context.hpp"
+#include "xy_plot_panel.hpp"
 #include "IconsFontAwesome6.h"
 
 extern "C" const unsigned char icon_data[];
@@ -57,37 +75,279 @@ namespace {
 			spdlog::critical("Terminating without exception");
 		}
 
+		profiler::stopTrace();
+
 		std::exit(EXIT_FAILURE);  // NOLINT(concurrency-mt-unsafe)
 	}
 
-	auto updateDateRange(const auto &window_contexts) -> void {
+	auto updateDateRange(auto &window_contexts) -> void {
 		double date_min = std::numeric_limits<double>::max();
 		double date_max = std::numeric_limits<double>::lowest();
 		
-		for (const auto& window_context : window_contexts) {
-			const auto& data = window_context.getData();
+		for (auto &window_context : window_contexts) {
+			const auto &view_state = window_context.getViewState();
 
-			if (data.empty()) {
+			if (!view_state.has_visible_data) {
 				continue;
 			}
 
-			for (const auto &e : window_context.getData()) {
-				if (!e.visible) {
-					continue;
-				}
+			date_min = std::min(date_min, view_state.x_lims.first);
+			date_max = std::max(date_max, view_state.x_lims.second);
+		}
+
+		if (date_min != std::numeric_limits<double>::max() && date_max != std::numeric_limits<double>::lowest()) {
+			AppState::getInstance().date_range = {date_min, date_max};
+		}
+	}
+
+	struct loop_stats_t {
+		std::chrono::steady_clock::time_point interval_start{std::chrono::steady_clock::now()};
+		std::chrono::nanoseconds interval_cpu_start{getProcessCPUTime()};
+		size_t interval_frames{0};
+		size_t interval_input_events{0};
+		double interval_max_latency_ms{0.0};
+
+		double cpu_usage{0.0};
+		double idle_cpu_usage{0.0};
+		double frames_per_second{0.0};
+
+		Uint64 pending_input_timestamp{0};
+		double last_latency_ms{0.0};
+		double mean_latency_ms{0.0};
+		double max_latency_ms{0.0};
+
+		allocation_counter::counts_t last_frame_allocations{};
+
+		auto addLatencySample(double latency_ms) -> void {
+			static constexpr double smoothing = 0.1;
+
+			this->mean_latency_ms = this->mean_latency_ms == 0.0
+										? latency_ms
+										: (1.0 - smoothing) * this->mean_latency_ms + smoothing * latency_ms;
+			this->last_latency_ms = latency_ms;
+			this->interval_max_latency_ms = std::max(this->interval_max_latency_ms, latency_ms);
+		}
+	};
+
+	auto isInputEvent(Uint32 type) -> bool {
+		switch (type) {
+		case SDL_EVENT_KEY_DOWN:
+		case SDL_EVENT_KEY_UP:
+		case SDL_EVENT_TEXT_INPUT:
+		case SDL_EVENT_MOUSE_MOTION:
+		case SDL_EVENT_MOUSE_BUTTON_DOWN:
+		case SDL_EVENT_MOUSE_BUTTON_UP:
+		case SDL_EVENT_MOUSE_WHEEL:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// returns true once per interval when new values are available
+	auto updateLoopStats(loop_stats_t &stats) -> bool {
+		static constexpr auto interval = std::chrono::seconds(1);
+
+		const auto now = std::chrono::steady_clock::now();
+		const auto elapsed = now - stats.interval_start;
+
+		if (elapsed < interval) {
+			return false;
+		}
+
+		const auto cpu_now = getProcessCPUTime();
+		const auto elapsed_s = std::chrono::duration<double>(elapsed).count();
+
+		stats.cpu_usage = std::chrono::duration<double>(cpu_now - stats.interval_cpu_start).count() / elapsed_s;
+		stats.frames_per_second = static_cast<double>(stats.interval_frames) / elapsed_s;
+		stats.max_latency_ms = stats.interval_max_latency_ms;
+
+		if (stats.interval_input_events == 0) {
+			stats.idle_cpu_usage = stats.cpu_usage;
+		}
+
+		stats.interval_start = now;
+		stats.interval_cpu_start = cpu_now;
+		stats.interval_frames = 0;
+		stats.interval_input_events = 0;
+		stats.interval_max_latency_ms = 0.0;
+
+		return true;
+	}
+
+	auto drawRollingSettings(rolling_settings_t &settings) -> void {
+		ImGui::TextUnformatted("Rolling statistics");
+		ImGui::Separator();
+
+		for (size_t i = 0; i < rolling_statistics.size(); ++i) {
+			const auto name = std::string(getRollingStatisticName(rolling_statistics.at(i)));
+			ImGui::Checkbox(name.c_str(), &settings.enabled.at(i));
+		}
+
+		ImGui::SetNextItemWidth(120.0f);
+		if (ImGui::InputInt("Window (s)", &settings.window, 10, 60)) {
+			settings.window = std::max(settings.window, 1);
+		}
+	}
+
+	// returns true if the visibility of any column has changed
+	auto drawColumnList(WindowContext &ctx, const ImVec2 &size) -> bool {
+		const auto &app_state = AppState::getInstance();
+		auto &dict = ctx.getData();
+		auto &filter = ctx.getColumnFilterRef();
+		bool changed{false};
+
+		ImGui::BeginChild("Column List", size);
+		ImGui::SetNextItemWidth(-1.0f);
+		if (ImGui::InputTextWithHint("##Filter", ICON_FA_MAGNIFYING_GLASS " Filter (^ for prefix)",
+									 &filter.getInputRef())) {
+			filter.setQuery(filter.getInputRef());
+		}
+
+		const auto row_count = filter.isActive() ? filter.getMatches().size() : dict.size();
+		const auto getIndex = [&filter](size_t row) -> size_t {
+			return filter.isActive() ? filter.getMatches()[row] : row;
+		};
+
+		const auto subwindow_size = ImGui::GetContentRegionAvail();
+		if (ImGui::BeginListBox("##List Box", ImVec2(subwindow_size.x, subwindow_size.y))) {
+			ImGuiListClipper clipper;
+			clipper.Begin(static_cast<int>(row_count));
+
+			while (clipper.Step()) {
+				for (auto row = static_cast<size_t>(clipper.DisplayStart);
+					 row < static_cast<size_t>(clipper.DisplayEnd); ++row) {
+					auto &dct = dict[getIndex(row)];
+
+					const auto clicked = ImGui::Selectable(dct.ids.label.c_str(), &dct.visible);
+
+					if (dct.data_type == data_type_t::FLOAT && ImGui::BeginPopupContextItem()) {
+						drawRollingSettings(ctx.getRollingOverlaysRef()[dct.uuid].getSettingsRef());
+						ImGui::EndPopup();
+					}
+
+					if (!clicked) {
+						continue;
+					}
+
+					changed = true;
+
+					if (app_state.is_ctrl_pressed) {
+						continue;
+					}
+
+					if (app_state.is_shift_pressed) {
+						// select the range between the first visible row and the clicked one
+						size_t first_visible_row = row;
+						for (size_t i = 0; i < row_count; ++i) {
+							if (dict[getIndex(i)].visible) {
+								first_visible_row = i;
+								break;
+							}
+						}
+
+						const auto start = std::min(first_visible_row, row);
+						const auto stop = std::max(first_visible_row, row);
+
+						for (auto i = start; i <= stop; ++i) {
+							dict[getIndex(i)].visible = true;
+						}
+
+						continue;
+					}
 
-				if (e.timestamp->empty()) {
-					continue;
+					std::for_each(dict.begin(), dict.end(), [](auto &tmp) { tmp.visible = false; });
+					dct.visible = true;
 				}
+			}
+
+			ImGui::EndListBox();
+		}
+		ImGui::EndChild();
 
-				date_min = std::min(date_min, static_cast<double>(e.timestamp->front()));
-				date_max = std::max(date_max, static_cast<double>(e.timestamp->back()));
+		return changed;
+	}
+
+	// time window for the files opened next, set by --from/--to and in the file menu
+	struct load_window_input_t {
+		bool enabled{false};
+		std::string from{};
+		std::string to{};
+		std::string error{};
+		time_window_t window{};
+	};
+
+	auto parseLoadWindow(load_window_input_t &input) -> void {
+		input.window = {};
+		input.error.clear();
+
+		if (!input.enabled) {
+			return;
+		}
+
+		try {
+			size_t prefered_fmt{0};
+
+			if (!input.from.empty()) {
+				input.window.from = parseDate(input.from, prefered_fmt);
 			}
+
+			if (!input.to.empty()) {
+				input.window.to = parseDate(input.to, prefered_fmt);
+			}
+		} catch (const std::exception &e) {
+			input.window = {};
+			input.error = e.what();
 		}
+	}
 
-		if (date_min != std::numeric_limits<double>::max() && date_max != std::numeric_limits<double>::lowest()) {
-			AppState::getInstance().date_range = {date_min, date_max};
+	auto drawLoadWindowMenu(load_window_input_t &input) -> void {
+		if (!ImGui::BeginMenu("Load time window")) {
+			return;
 		}
+
+		bool changed = ImGui::Checkbox("Only load rows within", &input.enabled);
+
+		ImGui::BeginDisabled(!input.enabled);
+		changed |= ImGui::InputTextWithHint("From", "2025-01-01 00:00:00", &input.from);
+		changed |= ImGui::InputTextWithHint("To", "2025-01-08 00:00:00", &input.to);
+		ImGui::EndDisabled();
+
+		if (changed) {
+			parseLoadWindow(input);
+		}
+
+		if (!input.error.empty()) {
+			ImGuiExt::TextFormattedDisabled("{}, loading everything", input.error);
+		}
+
+		ImGui::EndMenu();
+	}
+
+	auto runMemoryReport(const std::vector<std::filesystem::path> &paths, const time_window_t &window) -> int {
+		const auto paths_expanded = preparePaths(paths);
+
+		if (paths_expanded.empty()) {
+			spdlog::error("No files given for memory report");
+			return EXIT_FAILURE;
+		}
+
+		progress_counter_t finished_files{0};
+		const cancellation_token_t stop_loading{false};
+		const auto result = loadCSVs(paths_expanded, finished_files, stop_loading, window);
+
+		window_memory_t usage{.title = paths_expanded.size() > 1
+										   ? paths_expanded.front().parent_path().filename().string()
+										   : paths_expanded.front().filename().string(),
+							  .columns = {},
+							  .peak_load = result.peak_memory};
+
+		for (const auto &col : result.data) {
+			usage.columns.push_back(getColumnMemoryUsage(col));
+		}
+
+		printMemoryReport({usage});
+		return EXIT_SUCCESS;
 	}
 
 	auto setSystemLocale() -> void {
@@ -108,7 +368,13 @@ namespace {
 auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognitive-complexity)
 	std::set_terminate(terminateHandler);
 
+	if (isCLICommand(argc, argv)) {
+		return runCLICommand(argc, argv);
+	}
+
 	std::vector<std::filesystem::path> commandline_paths{};
+	load_window_input_t load_window_input{};
+	bool open_as_catalog{false};
 
 	auto &app_state = AppState::getInstance();
 
@@ -119,6 +385,13 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 			("h,help", "Print usage")
 			("filename", "CSV file to load", cxxopts::value<std::vector<std::string>>(), "FILE")
 			("v,verbose", "verbose output")
+			("trace", "write a Chrome/Perfetto trace of loading, aggregation and rendering to FILE",
+				cxxopts::value<std::string>(), "FILE")
+			("memory-report", "load the given files, print their memory footprint per column and exit")
+			("from", "only load rows from DATE on, e.g. \"2025-01-01 00:00:00\", earlier files are skipped",
+				cxxopts::value<std::string>(), "DATE")
+			("to", "only load rows up to DATE, later files are skipped", cxxopts::value<std::string>(), "DATE")
+			("catalog", "open the files as catalog, only the visible files are loaded")
 			;
 
 		try {
@@ -141,6 +414,30 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 				app_state.show_debug_menu = true;
 				spdlog::info("verbose output enabled");
 			}
+
+			if (result.count("trace") != 0u) {
+				profiler::setThreadName("main");
+				profiler::startTrace(result["trace"].as<std::string>());
+			}
+
+			if (result.count("from") != 0u || result.count("to") != 0u) {
+				load_window_input.enabled = true;
+				load_window_input.from = result.count("from") != 0u ? result["from"].as<std::string>() : "";
+				load_window_input.to = result.count("to") != 0u ? result["to"].as<std::string>() : "";
+				parseLoadWindow(load_window_input);
+
+				if (!load_window_input.error.empty()) {
+					throw std::runtime_error(load_window_input.error);
+				}
+			}
+
+			open_as_catalog = result.count("catalog") != 0u;
+
+			if (result.count("memory-report") != 0u) {
+				const auto ret = runMemoryReport(commandline_paths, load_window_input.window);
+				profiler::stopTrace();
+				return ret;
+			}
 		} catch (const std::exception& e) {
 			spdlog::critical(e.what());
 			return EXIT_FAILURE;
@@ -155,13 +452,16 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 	{
 		const auto paths_expanded = preparePaths(commandline_paths);
 
-		if (!paths_expanded.empty()) {
-			window_contexts.emplace_back(paths_expanded, loadCSVs);
+		if (!paths_expanded.empty() && open_as_catalog) {
+			openCatalog(window_contexts.emplace_back(), paths_expanded);
+		} else if (!paths_expanded.empty()) {
+			window_contexts.emplace_back(paths_expanded, loadCSVs, load_window_input.window);
 		}
 	}
 
 	if (!SDL_Init(SDL_INIT_VIDEO)) {
 		spdlog::error("Error: {}", SDL_GetError());
+		profiler::stopTrace();
 		return -1;
 	}
 
@@ -202,6 +502,7 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 	spdlog::debug("Display scale: {}x", app_state.display_scale);
 
 	IMGUI_CHECKVERSION();
+	allocation_counter::installImGuiHooks();
 	ImGui::CreateContext();
 	ImGuiIO &io = ImGui::GetIO();
 	io.ConfigFlags |= ImGuiConfigFlags_DockingEnable | ImGuiConfigFlags_NavEnableKeyboard;
@@ -230,61 +531,111 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 
 	const auto background_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
+	app_state.wakeup_event_type = SDL_RegisterEvents(1);
+
 	// Main loop
 	bool done{false};
+	// ImGui needs a few frames after an input to settle hover states and layouts
+	static constexpr int redraw_frames_after_event = 3;
+	static constexpr Sint32 animation_interval_ms = 100;
+	static constexpr Sint32 idle_wakeup_interval_ms = 1'000;
+	int redraw_frames{redraw_frames_after_event};
+	loop_stats_t loop_stats{};
 
 	while (!done) {
 		bool open_selected{false};
 		bool select_folder{false};
+		bool select_catalog{false};
 		
+		const auto is_animating = std::ranges::any_of(
+			window_contexts, [](auto &ctx) { return ctx.getLoadingStatus().is_loading; });
+
 		{
-			SDL_Event event;
-			SDL_WaitEventTimeout(&event, 100);
-			ImGui_ImplSDL3_ProcessEvent(&event);
-			if (event.type == SDL_EVENT_QUIT) {
-				done = true;
-			}
+			const auto timeout_ms = [&]() -> Sint32 {
+				if (redraw_frames > 0) {
+					return 0;
+				}
 
-			if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED && event.window.windowID == SDL_GetWindowID(window)) {
-				done = true;
-			}
+				if (is_animating) {
+					return animation_interval_ms;
+				}
+
+				return idle_wakeup_interval_ms;
+			}();
+
+			// drain the whole queue so bursts of motion/wheel events are handled within one frame
+			SDL_Event event;
+			bool has_event = SDL_WaitEventTimeout(&event, timeout_ms);
 
-			if (event.type == SDL_EVENT_KEY_DOWN) {
-				if (event.key.key == SDLK_O && (event.key.mod & SDL_KMOD_CTRL) != 0) {
-					open_selected = true;
-					select_folder = (event.key.mod & SDL_KMOD_SHIFT) != 0;
+			while (has_event) {
+				ImGui_ImplSDL3_ProcessEvent(&event);
+				if (event.type == SDL_EVENT_QUIT) {
+					done = true;
 				}
 
-				if (event.key.key == SDLK_Q && (event.key.mod & SDL_KMOD_CTRL) != 0) {
+				if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED && event.window.windowID == SDL_GetWindowID(window)) {
 					done = true;
 				}
 
-				if ((event.key.mod & SDL_KMOD_CTRL) != 0) {
-					app_state.is_ctrl_pressed = true;
+				if (event.type == SDL_EVENT_KEY_DOWN) {
+					if (event.key.key == SDLK_O && (event.key.mod & SDL_KMOD_CTRL) != 0) {
+						open_selected = true;
+						select_folder = (event.key.mod & SDL_KMOD_SHIFT) != 0;
+					}
+
+					if (event.key.key == SDLK_Q && (event.key.mod & SDL_KMOD_CTRL) != 0) {
+						done = true;
+					}
+
+					if ((event.key.mod & SDL_KMOD_CTRL) != 0) {
+						app_state.is_ctrl_pressed = true;
+					}
+
+					if ((event.key.mod & SDL_KMOD_SHIFT) != 0) {
+						app_state.is_shift_pressed = true;
+					}
 				}
 
-				if ((event.key.mod & SDL_KMOD_SHIFT) != 0) {
-					app_state.is_shift_pressed = true;
+				if (event.type == SDL_EVENT_KEY_UP) {
+					if ((event.key.mod & SDL_KMOD_CTRL) == 0) {
+						app_state.is_ctrl_pressed = false;
+					}
+
+					if ((event.key.mod & SDL_KMOD_SHIFT) == 0) {
+						app_state.is_shift_pressed = false;
+					}
 				}
-			}
 
-			if (event.type == SDL_EVENT_KEY_UP) {
-				if ((event.key.mod & SDL_KMOD_CTRL) == 0) {
-					app_state.is_ctrl_pressed = false;
+				if (event.type == SDL_EVENT_WINDOW_DISPLAY_SCALE_CHANGED) {
+					app_state.display_scale = SDL_GetWindowDisplayScale(window);
+					io.FontGlobalScale = app_state.display_scale;
+					spdlog::debug("Display scale changed to {}x", app_state.display_scale);
 				}
 
-				if ((event.key.mod & SDL_KMOD_SHIFT) == 0) {
-					app_state.is_shift_pressed = false;
+				if (isInputEvent(event.type)) {
+					++loop_stats.interval_input_events;
+
+					if (loop_stats.pending_input_timestamp == 0) {
+						loop_stats.pending_input_timestamp = event.common.timestamp;
+					}
 				}
-			}
 
-			if (event.type == SDL_EVENT_WINDOW_DISPLAY_SCALE_CHANGED) {
-				app_state.display_scale = SDL_GetWindowDisplayScale(window);
-				io.FontGlobalScale = app_state.display_scale;
-				spdlog::debug("Display scale changed to {}x", app_state.display_scale);
+				redraw_frames = redraw_frames_after_event;
+				has_event = SDL_PollEvent(&event);
 			}
 		}
 
+		const auto stats_updated = updateLoopStats(loop_stats);
+
+		if (!done && redraw_frames == 0 && !is_animating && !(stats_updated && app_state.show_debug_menu)) {
+			continue;
+		}
+
+		redraw_frames = std::max(redraw_frames - 1, 0);
+
+		const profiler::ScopedTimer frame_timer{profiler::stage::frame};
+		const auto frame_allocations_start = allocation_counter::getThreadCounts();
+
 		ImGui_ImplSDLRenderer3_NewFrame();
 		ImGui_ImplSDL3_NewFrame();
 		ImGui::NewFrame();
@@ -296,6 +647,11 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 				if (ImGui::MenuItem("Open Folder", "Ctrl+Shift+O", &open_selected)) {
 					select_folder = true;
 				}
+				if (ImGui::MenuItem("Open Folder as Catalog", nullptr, &open_selected)) {
+					select_folder = true;
+					select_catalog = true;
+				}
+				drawLoadWindowMenu(load_window_input);
 				ImGui::Separator();
 				if (ImGui::MenuItem("Exit", "Ctrl+Q", &done)) {}
 				ImGui::EndMenu();
@@ -304,7 +660,9 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 			if (ImGui::BeginMenu("Settings")) {
 				ImGui::MenuItem("Always show date cursor", nullptr, &app_state.always_show_cursor);
 				ImGui::Separator();
-				ImGui::InputInt("Max displayed data points", &app_state.max_data_points, 100, 1'000);
+				if (ImGui::InputInt("Max displayed data points", &app_state.max_data_points, 100, 1'000)) {
+					++app_state.settings_generation;
+				}
 				ImGui::EndMenu();
 			}
 
@@ -315,6 +673,22 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 
 			if (app_state.show_debug_menu) {
 				if (ImGui::BeginMenu("Debug")) {
+					ImGuiExt::TextFormatted("CPU usage: {:.1f}%", loop_stats.cpu_usage * 100.0);
+					ImGuiExt::TextFormatted("Idle CPU usage: {:.1f}%", loop_stats.idle_cpu_usage * 100.0);
+					ImGuiExt::TextFormatted("Rendered frames: {:.1f}/s", loop_stats.frames_per_second);
+					ImGuiExt::TextFormatted("Input-to-photon latency: {:.1f} ms (avg. {:.1f} ms, max. {:.1f} ms)",
+											loop_stats.last_latency_ms, loop_stats.mean_latency_ms,
+											loop_stats.max_latency_ms);
+
+					if constexpr (allocation_counter::isEnabled()) {
+						ImGuiExt::TextFormatted("Allocations last frame: {} (ImGui: {})",
+												loop_stats.last_frame_allocations.heap,
+												loop_stats.last_frame_allocations.imgui);
+					}
+
+					ImGui::Separator();
+					ImGui::MenuItem("Profiler", nullptr, &app_state.show_profiler);
+					ImGui::MenuItem("Memory", nullptr, &app_state.show_memory);
 					ImGui::EndMenu();
 				}
 			}
@@ -326,9 +700,11 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 		if (open_selected) {
 			const auto paths = selectFilesFromDialog(select_folder);
 
-			if (!paths.empty()) {
+			if (!paths.empty() && select_catalog) {
+				openCatalog(window_contexts.emplace_back(), preparePaths(paths));
+			} else if (!paths.empty()) {
 				const auto paths_expanded = preparePaths(paths);
-				window_contexts.emplace_back(paths_expanded, loadCSVs);
+				window_contexts.emplace_back(paths_expanded, loadCSVs, load_window_input.window);
 			}
 		}
 
@@ -339,12 +715,16 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 		
 		if (app_state.show_debug_menu) {
 			ImGui::ShowMetricsWindow();
+			showProfilerWindow(&app_state.show_profiler);
+			showMemoryWindow(&app_state.show_memory, window_contexts);
 		}
 
 		updateDateRange(window_contexts);
 
 		for (auto &ctx : window_contexts) {
 			ctx.checkForFinishedLoading();
+			ctx.updateDerivedColumns();
+			updateCatalog(ctx);
 			auto &dict = ctx.getData();
 			auto window_open = ctx.getWindowOpenRef();
 			
@@ -353,6 +733,8 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 						 ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_MenuBar);
 
 			const auto loading_status = ctx.getLoadingStatus();
+			bool open_export{false};
+			bool open_derived_column{false};
 
 			if (ImGui::BeginMenuBar()) {
 				bool &global_x_link = ctx.getGlobalXLinkRef();
@@ -382,9 +764,95 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 				if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
 					ImGui::SetTooltip("Duplicate");
 				}
+
+				if (ImGui::MenuItem(ICON_FA_SQUARE_ROOT_VARIABLE, nullptr, nullptr, !loading_status.is_loading)) {
+					open_derived_column = true;
+				}
+
+				if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+					ImGui::SetTooltip("Add computed column");
+				}
+
+				if (ImGui::MenuItem(ICON_FA_FILE_EXPORT, nullptr, nullptr, !loading_status.is_loading)) {
+					open_export = true;
+				}
+
+				if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+					ImGui::SetTooltip("Export");
+				}
+
+				if (ImGui::MenuItem(ICON_FA_WAVE_SQUARE, nullptr, nullptr, !loading_status.is_loading)) {
+					openSpectrumWindow(ctx);
+				}
+
+				if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+					ImGui::SetTooltip("Spectrum");
+				}
+
+				if (ImGui::MenuItem(ICON_FA_TABLE_CELLS, nullptr, nullptr, !loading_status.is_loading)) {
+					openCorrelationWindow(ctx);
+				}
+
+				if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+					ImGui::SetTooltip("Correlation matrix");
+				}
+
+				if (ImGui::MenuItem(ICON_FA_CHART_COLUMN, nullptr, nullptr, !loading_status.is_loading)) {
+					openHistogramWindow(ctx);
+				}
+
+				if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+					ImGui::SetTooltip("Histogram");
+				}
+
+				if (ImGui::MenuItem(ICON_FA_MAGNIFYING_GLASS_CHART, nullptr, nullptr, !loading_status.is_loading)) {
+					openEventSearchWindow(ctx);
+				}
+
+				if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+					ImGui::SetTooltip("Event search");
+				}
+
+				if (ImGui::MenuItem(ICON_FA_CHART_SIMPLE, nullptr, nullptr, !loading_status.is_loading)) {
+					openXYPlotWindow(ctx);
+				}
+
+				if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+					ImGui::SetTooltip("XY plot");
+				}
+
+				if (ImGui::MenuItem(ICON_FA_CALCULATOR, nullptr, nullptr, !loading_status.is_loading)) {
+					openStatisticsWindow(ctx);
+				}
+
+				if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+					ImGui::SetTooltip("Statistics of the visible range");
+				}
+
+				if (ctx.getCatalogStateRef().isCatalog()) {
+					if (ImGui::MenuItem(ICON_FA_FOLDER_TREE, nullptr, nullptr, !loading_status.is_loading)) {
+						openCatalogWindow(ctx);
+					}
+
+					if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+						ImGui::SetTooltip("Files of the catalog");
+					}
+				}
 				ImGui::EndMenuBar();
 			}
 
+			if (open_export) {
+				openExportPopup(ctx);
+			}
+
+			drawExportPopup(ctx);
+
+			if (open_derived_column) {
+				openDerivedColumnPopup(ctx);
+			}
+
+			drawDerivedColumnPopup(ctx);
+
 			const auto window_content_size = ImGui::GetContentRegionAvail();
 
 			if (loading_status.is_loading) {
@@ -399,45 +867,9 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 				ImGui::ProgressBar(progress, ImVec2(window_content_size.x - 2.0f * padding, 20.0f), label.c_str());
 			} else {
 				if (!dict.empty()) {
-					ImGui::BeginChild("Column List", ImVec2(250, window_content_size.y));
-					const auto subwindow_size = ImGui::GetContentRegionAvail();
-					if (ImGui::BeginListBox("##List Box", ImVec2(subwindow_size.x, subwindow_size.y))) {
-						for (auto &dct : dict) {
-							const auto list_id = dct.name + "##" + dct.uuid;
-							if (ImGui::Selectable(list_id.c_str(), &dct.visible)) {
-								if (app_state.is_ctrl_pressed) {
-									break;
-								}
-
-								if (app_state.is_shift_pressed) {
-									const auto first_visible = std::find_if(
-										dict.begin(), dict.end(), [](const auto &tmp) { return tmp.visible; });
-
-									const auto current_dict =
-										std::find_if(dict.begin(), dict.end(),
-													 [&dct](const auto &tmp) { return tmp.uuid == dct.uuid; });
-
-									if (first_visible != dict.end() && current_dict != dict.end()) {
-										const auto first_index = std::distance(dict.begin(), first_visible);
-										const auto current_index = std::distance(dict.begin(), current_dict);
-
-										const auto start = std::min(first_index, current_index);
-										const auto stop = std::max(first_index, current_index);
-
-										std::for_each(dict.begin() + start, dict.begin() + stop + 1,
-													  [](auto &tmp) { tmp.visible = true; });
-									}
-
-									break;
-								}
-
-								std::for_each(dict.begin(), dict.end(), [](auto &tmp) { tmp.visible = false; });
-								dct.visible = true;
-							}
-						}
-						ImGui::EndListBox();
+					if (drawColumnList(ctx, ImVec2(250, window_content_size.y))) {
+						ctx.invalidateViewState();
 					}
-					ImGui::EndChild();
 
 					ImGui::SameLine();
 
@@ -448,7 +880,7 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 					plotDataInSubplots(ctx);
 					
 					if (app_state.show_debug_menu) {
-						ImGui::PushID(ctx.getUUID().c_str());
+						ImGui::PushID(ctx.getPlotID().c_str());
 						ImPlot::ShowMetricsWindow();
 						ImGui::PopID();
 					}
@@ -462,6 +894,16 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 
 			ImGui::End();
 
+			if (!loading_status.is_loading) {
+				drawSpectrumWindow(ctx);
+				drawCorrelationWindow(ctx);
+				drawHistogramWindow(ctx);
+				drawEventSearchWindow(ctx);
+				drawXYPlotWindow(ctx);
+				drawStatisticsWindow(ctx);
+				drawCatalogWindow(ctx);
+			}
+
 			if (!window_open) {
 				ImGui::ClearWindowSettings(ctx.getWindowID().c_str());
 				ctx.scheduleForDeletion();
@@ -472,6 +914,8 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 											 [](const auto &ctx) { return ctx.isScheduledForDeletion(); }),
 							  window_contexts.end());
 
+		const profiler::ScopedTimer render_timer{profiler::stage::render};
+
 		ImGui::Render();
 		SDL_SetRenderDrawColorFloat(app_state.renderer, background_color.x, background_color.y, background_color.z,
 									background_color.w);
@@ -490,9 +934,21 @@ auto main(int argc, char **argv) -> int {  // NOLINT(readability-function-cognit
 
         ImGui_ImplSDLRenderer3_RenderDrawData(ImGui::GetDrawData(), app_state.renderer);
         SDL_RenderPresent(app_state.renderer);
+
+		++loop_stats.interval_frames;
+		loop_stats.last_frame_allocations = allocation_counter::getThreadCounts() - frame_allocations_start;
+
+		if (loop_stats.pending_input_timestamp != 0) {
+			const auto latency_ns = SDL_GetTicksNS() - loop_stats.pending_input_timestamp;
+			loop_stats.addLatencySample(static_cast<double>(latency_ns) / 1e6);
+			loop_stats.pending_input_timestamp = 0;
+		}
 	}
 
 	// Cleanup
+	window_contexts.clear();
+	profiler::stopTrace();
+
 	ImGui_ImplSDLRenderer3_Shutdown();
 	ImGui_ImplSDL3_Shutdown();
 	ImGui::DestroyContext();
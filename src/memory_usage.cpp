@@ -0,0 +1,247 @@
+#include "memory_usage.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "column_sketches.hpp"
+#include "event_search.hpp"
+#include "fmt/format.h"
+#include "range_statistics.hpp"
+#include "window_context.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+#ifdef __linux__
+#include <fstream>
+#include <sstream>
+#endif
+
+namespace {
+	// size of the shared state created by std::make_shared in addition to the owned object
+	constexpr size_t shared_control_block_size = 2 * sizeof(void *);
+
+	template <typename T>
+	auto getVectorMemoryUsage(const std::vector<T> &vec) -> size_t {
+		return vec.capacity() * sizeof(T);
+	}
+
+	template <typename T>
+	auto getSharedVectorMemoryUsage(const std::shared_ptr<std::vector<T>> &ptr) -> size_t {
+		if (ptr == nullptr) {
+			return 0;
+		}
+
+		return shared_control_block_size + sizeof(std::vector<T>) + getVectorMemoryUsage(*ptr);
+	}
+
+	auto getAggregateLevelMemoryUsage(const std::shared_ptr<const aggregate_level_t> &ptr) -> size_t {
+		if (ptr == nullptr) {
+			return 0;
+		}
+
+		return shared_control_block_size + sizeof(aggregate_level_t) + getVectorMemoryUsage(ptr->values);
+	}
+
+#ifdef __linux__
+	// returns the value of a "VmXYZ:   1234 kB" line in /proc/self/status in bytes
+	auto readProcStatusValue(const std::string &status, const std::string &key) -> size_t {
+		const auto pos = status.find(key);
+		if (pos == std::string::npos) {
+			return 0;
+		}
+
+		std::istringstream ss{status.substr(pos + key.size())};
+		size_t value_kb{0};
+		ss >> value_kb;
+
+		return value_kb * 1024;
+	}
+#endif
+}  // namespace
+
+auto window_memory_t::total() const -> size_t {
+	auto sum = this->caches;
+
+	for (const auto &e : this->columns) {
+		sum += e.total();
+	}
+
+	return sum;
+}
+
+auto getMemoryUsage(const std::string &str) -> size_t {
+	static const auto sso_capacity = std::string{}.capacity();
+	return str.capacity() > sso_capacity ? str.capacity() + 1 : 0;
+}
+
+auto getMemoryUsage(const immediate_dict &dict) -> size_t {
+	return getMemoryUsage(dict.name) + getMemoryUsage(dict.unit) + getVectorMemoryUsage(dict.data);
+}
+
+auto getMemoryUsage(const std::unordered_map<std::string, immediate_dict> &dicts) -> size_t {
+	using node_t = std::pair<const std::string, immediate_dict>;
+
+	size_t sum = dicts.bucket_count() * sizeof(void *);
+
+	for (const auto &[key, value] : dicts) {
+		sum += sizeof(node_t) + sizeof(void *) + getMemoryUsage(key) + getMemoryUsage(value);
+	}
+
+	return sum;
+}
+
+auto getColumnMemoryUsage(const data_dict_t &col) -> column_memory_t {
+	return {.name = col.name,
+			.timestamps = getSharedVectorMemoryUsage(col.timestamp),
+			.values = getSharedVectorMemoryUsage(col.data),
+			.aggregates = getAggregateLevelMemoryUsage(col.aggregates) +
+						  (col.sketches != nullptr ? col.sketches->getMemoryUsage() : 0) +
+						  (col.extrema != nullptr ? col.extrema->getMemoryUsage() : 0) +
+						  (col.range_index != nullptr ? col.range_index->getMemoryUsage() : 0),
+			.caches = sizeof(data_dict_t) + getMemoryUsage(col.name) + getMemoryUsage(col.uuid) +
+					  getMemoryUsage(col.unit) + getMemoryUsage(col.ids.label) + getMemoryUsage(col.ids.shaded) +
+					  getMemoryUsage(col.ids.inf_line) + getMemoryUsage(col.ids.scatter_line) +
+					  getMemoryUsage(col.ids.axis_format)};
+}
+
+auto countBufferOwners(const std::list<WindowContext> &window_contexts) -> buffer_owners_t {
+	buffer_owners_t owners{};
+
+	for (const auto &ctx : window_contexts) {
+		std::unordered_set<const void *> buffers{};
+
+		for (const auto &col : ctx.getData()) {
+			buffers.insert(col.timestamp.get());
+			buffers.insert(col.data.get());
+		}
+
+		for (const auto *buffer : buffers) {
+			++owners[buffer];
+		}
+	}
+
+	return owners;
+}
+
+auto getWindowMemoryUsage(const WindowContext &ctx, const buffer_owners_t &owners) -> window_memory_t {
+	window_memory_t ret{.title = ctx.getWindowTitle(),
+						.columns = {},
+						.caches = ctx.getCacheMemoryUsage(),
+						.peak_load = ctx.getPeakLoadMemory()};
+	ret.columns.reserve(ctx.getData().size());
+
+	const auto is_shared = [&owners](const void *buffer) {
+		const auto it = owners.find(buffer);
+		return it != owners.end() && it->second > 1;
+	};
+
+	for (const auto &col : ctx.getData()) {
+		auto &usage = ret.columns.emplace_back(getColumnMemoryUsage(col));
+		usage.shared = is_shared(col.timestamp.get()) || is_shared(col.data.get());
+	}
+
+	return ret;
+}
+
+auto getTotalMemoryUsage(const std::list<WindowContext> &window_contexts) -> size_t {
+	std::unordered_set<const void *> counted_buffers{};
+	size_t sum{0};
+
+	for (const auto &ctx : window_contexts) {
+		sum += ctx.getCacheMemoryUsage();
+
+		for (const auto &col : ctx.getData()) {
+			const auto usage = getColumnMemoryUsage(col);
+			const auto level = getAggregateLevelMemoryUsage(col.aggregates);
+			sum += usage.aggregates - level + usage.caches;
+
+			// windows showing the same samples at the same resolution share their aggregates
+			if (counted_buffers.insert(col.aggregates.get()).second) {
+				sum += level;
+			}
+
+			if (counted_buffers.insert(col.timestamp.get()).second) {
+				sum += usage.timestamps;
+			}
+
+			if (counted_buffers.insert(col.data.get()).second) {
+				sum += usage.values;
+			}
+		}
+	}
+
+	return sum;
+}
+
+auto getProcessMemoryUsage() -> process_memory_t {
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters{};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) == 0) {
+		return {};
+	}
+
+	return {.resident = counters.WorkingSetSize, .peak_resident = counters.PeakWorkingSetSize};
+#elif defined(__linux__)
+	std::ifstream file{"/proc/self/status"};
+	const std::string status{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+	return {.resident = readProcStatusValue(status, "VmRSS:"), .peak_resident = readProcStatusValue(status, "VmHWM:")};
+#else
+	return {};
+#endif
+}
+
+auto formatBytes(size_t bytes) -> std::string {
+	static constexpr auto units = std::array{"B", "KiB", "MiB", "GiB", "TiB"};
+
+	auto value = static_cast<double>(bytes);
+	size_t unit = 0;
+
+	while (value >= 1024.0 && unit < units.size() - 1) {
+		value /= 1024.0;
+		++unit;
+	}
+
+	if (unit == 0) {
+		return fmt::format("{} {}", bytes, units.at(unit));
+	}
+
+	return fmt::format("{:.2f} {}", value, units.at(unit));
+}
+
+auto printMemoryReport(const std::vector<window_memory_t> &windows) -> void {
+	for (const auto &window : windows) {
+		fmt::print("{}: {} (peak while loading: {})\n", window.title, formatBytes(window.total()),
+				   formatBytes(window.peak_load));
+		fmt::print("{:<40} {:>14} {:>14} {:>14} {:>14} {:>14}\n", "column", "timestamps", "values", "aggregates",
+				   "caches", "total");
+
+		auto columns = window.columns;
+		std::ranges::sort(columns, std::ranges::greater{}, &column_memory_t::total);
+
+		for (const auto &col : columns) {
+			fmt::print("{:<40} {:>14} {:>14} {:>14} {:>14} {:>14}\n", col.name, col.timestamps, col.values,
+					   col.aggregates, col.caches, col.total());
+		}
+
+		if (window.caches > 0) {
+			fmt::print("{:<40} {:>14} {:>14} {:>14} {:>14} {:>14}\n", "(window caches)", 0, 0, 0, window.caches,
+					   window.caches);
+		}
+
+		fmt::print("\n");
+	}
+
+	const auto process = getProcessMemoryUsage();
+	fmt::print("process resident: {}, peak resident: {}\n", formatBytes(process.resident),
+			   formatBytes(process.peak_resident));
+}
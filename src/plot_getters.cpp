@@ -0,0 +1,77 @@
+#include "plot_getters.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <limits>
+
+#include "custom_type_traits.hpp"
+#include "dicts.hpp"
+#include "implot.h"
+#include "spdlog/spdlog.h"
+
+namespace {
+	auto getAggregatedPlotData(int i, void *data, auto fn) -> ImPlotPoint {
+		assert(i >= 0);
+		assert(data != nullptr);
+
+		const auto &plot_data = *static_cast<plot_data_t *>(data);
+		const auto &dd = *plot_data.data;
+
+		assert(dd.aggregates != nullptr);
+		assert(dd.aggregates->reduction_factor == plot_data.reduction_factor);
+
+		if (i == 0) {
+			return {plot_data.linked_date_range.first, std::numeric_limits<double>::quiet_NaN()};
+		}
+
+		if (i == plot_data.count - 3) {
+			return {std::numeric_limits<double>::quiet_NaN(), dd.fit_zoom_range.first};
+		}
+
+		if (i == plot_data.count - 2) {
+			return {std::numeric_limits<double>::quiet_NaN(), dd.fit_zoom_range.second};
+		}
+
+		if (i == plot_data.count - 1) {
+			return {plot_data.linked_date_range.second, std::numeric_limits<double>::quiet_NaN()};
+		}
+
+		const auto &aggregates = dd.aggregates->values;
+		const auto resulting_idx = std::min(plot_data.start_index + coerceCast<size_t>(i) - 1, aggregates.size() - 1);
+
+		try {
+			const auto &aggregate = aggregates.at(resulting_idx);
+			return {static_cast<double>(aggregate.date), fn(aggregate)};
+		} catch (const std::exception &e) {
+			spdlog::error("{} i = {}, plot_data.start_index = {}, aggregates.size() = {}", e.what(), resulting_idx,
+						  plot_data.start_index, aggregates.size());
+		}
+
+		return {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()};
+	}
+}  // namespace
+
+auto plotDict(int i, void *data) -> ImPlotPoint {
+	return getAggregatedPlotData(i, data, [](const auto &aggregate) { return aggregate.first; });
+}
+
+auto plotDictMean(int i, void *data) -> ImPlotPoint {
+	return getAggregatedPlotData(i, data, [](const auto &aggregate) { return aggregate.mean; });
+}
+
+auto plotDictMax(int i, void *data) -> ImPlotPoint {
+	return getAggregatedPlotData(i, data, [](const auto &aggregate) { return aggregate.max; });
+}
+
+auto plotDictMin(int i, void *data) -> ImPlotPoint {
+	return getAggregatedPlotData(i, data, [](const auto &aggregate) { return aggregate.min; });
+}
+
+auto plotDictStdPlus(int i, void *data) -> ImPlotPoint {
+	return getAggregatedPlotData(i, data, [](const auto &aggregate) { return aggregate.mean + aggregate.std; });
+}
+
+auto plotDictStdMinus(int i, void *data) -> ImPlotPoint {
+	return getAggregatedPlotData(i, data, [](const auto &aggregate) { return aggregate.mean - aggregate.std; });
+}
@@ -2,33 +2,31 @@
 
 #include <algorithm>
 #include <array>
-#include <cassert>
 #include <cstdint>
-#include <numeric>
+#include <iterator>
 #include <ranges>
 #include <utility>
+#include <vector>
 
+#include "aggregate_cache.hpp"
+#include "aggregation.hpp"
 #include "custom_type_traits.hpp"
 #include "dicts.hpp"
 #include "global_state.hpp"
+#include "histogram_panel.hpp"
 #include "imgui.h"
 #include "imgui_extensions.hpp"
 #include "implot.h"
 #include "implot_internal.h"
+#include "plot_getters.hpp"
+#include "profiler.hpp"
+#include "rolling_statistics.hpp"
 #include "spdlog/spdlog.h"
 #include "utility.hpp"
+#include "view_state.hpp"
 #include "window_context.hpp"
 
 namespace {
-	struct plot_data_t {
-		const data_dict_t *data;
-		size_t reduction_factor;
-		size_t start_index;
-		int count;
-
-		std::pair<double, double> linked_date_range;
-	};
-
 	constexpr auto reduction_steps =
 		std::array{1uz,		 10uz,	   50uz,	  100uz,	 500uz,		  1'000uz,	   5'000uz,
 				   10'000uz, 50'000uz, 100'000uz, 500'000uz, 1'000'000uz, 10'000'000uz};
@@ -48,219 +46,36 @@ namespace {
 		return getNextReductionFactor(dict.data->size() / static_cast<size_t>(max_points));
 	}
 
-	auto calcMax(std::span<const double> data) -> double {
-		return *std::ranges::max_element(data);
-	}
-
-	auto calcMin(std::span<const double> data) -> double {
-		return *std::ranges::min_element(data);
-	}
-
-	auto calcMean(std::span<const double> data) -> double {
-		return std::accumulate(data.begin(), data.end(), 0.0) / static_cast<double>(data.size());
-	}
-
-	auto calcStd(std::span<const double> data, double mean) -> double {
-		return std::sqrt(std::accumulate(data.begin(), data.end(), 0.0,
-										 [mean](const auto &a, const auto &b) { return a + (b - mean) * (b - mean); }) /
-						 static_cast<double>(data.size()));
-	}
-
-	auto getAggregatedPlotData(int i, void *data, auto fn) -> ImPlotPoint {
-		assert(i >= 0);
-		assert(data != nullptr);
-
-		const auto &plot_data = *static_cast<plot_data_t *>(data);
-		const auto &dd = *plot_data.data;
-
-		assert(dd.aggregated_to > 0);
-		assert(dd.aggregated_to == plot_data.reduction_factor);
-
-		if (i == 0) {
-			return {plot_data.linked_date_range.first, std::numeric_limits<double>::quiet_NaN()};
-		}
-
-		if (i == plot_data.count - 3) {
-			return {std::numeric_limits<double>::quiet_NaN(), dd.fit_zoom_range.first};
-		}
-
-		if (i == plot_data.count - 2) {
-			return {std::numeric_limits<double>::quiet_NaN(), dd.fit_zoom_range.second};
-		}
-
-		if (i == plot_data.count - 1) {
-			return {plot_data.linked_date_range.second, std::numeric_limits<double>::quiet_NaN()};
-		}
-
-		const auto resulting_idx =
-			std::min(plot_data.start_index + coerceCast<size_t>(i) - 1, dd.aggregates.size() - 1);
-
-		try {
-			const auto &aggregate = dd.aggregates.at(resulting_idx);
-			return {static_cast<double>(aggregate.date), fn(aggregate)};
-		} catch (const std::exception &e) {
-			spdlog::error("{} i = {}, plot_data.start_index = {}, aggregates.size() = {}", e.what(), resulting_idx,
-						  plot_data.start_index, dd.aggregates.size());
-		}
-
-		return {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()};
-	}
-
-	auto plotDict(int i, void *data) -> ImPlotPoint {
-		return getAggregatedPlotData(i, data, [](const auto &aggregate) { return aggregate.first; });
-	}
-
-	auto plotDictMean(int i, void *data) -> ImPlotPoint {
-		return getAggregatedPlotData(i, data, [](const auto &aggregate) { return aggregate.mean; });
-	}
-
-	auto plotDictMax(int i, void *data) -> ImPlotPoint {
-		return getAggregatedPlotData(i, data, [](const auto &aggregate) { return aggregate.max; });
-	}
-
-	auto plotDictMin(int i, void *data) -> ImPlotPoint {
-		return getAggregatedPlotData(i, data, [](const auto &aggregate) { return aggregate.min; });
-	}
-
-	auto plotDictStdPlus(int i, void *data) -> ImPlotPoint {
-		return getAggregatedPlotData(i, data, [](const auto &aggregate) { return aggregate.mean + aggregate.std; });
-	}
-
-	auto plotDictStdMinus(int i, void *data) -> ImPlotPoint {
-		return getAggregatedPlotData(i, data, [](const auto &aggregate) { return aggregate.mean - aggregate.std; });
-	}
-
-	auto createSegments(std::span<const time_t> timestamps, time_t gap_threshold)
-		-> std::vector<std::pair<size_t, size_t>> {
-		std::vector<std::pair<size_t, size_t>> segments;
-		size_t segment_start = 0;
-
-		for (size_t j = 1; j < timestamps.size(); ++j) {
-			const auto ts_diff = timestamps[j] - timestamps[j - 1];
-			if (ts_diff > gap_threshold) {
-				segments.emplace_back(segment_start, j - 1);
-				segment_start = j;
-			}
-		}
-
-		if (segment_start < timestamps.size()) {
-			segments.emplace_back(segment_start, timestamps.size() - 1);
-		}
-
-		if (segments.empty()) {
-			segments.emplace_back(0, timestamps.size() - 1);
-		}
-
-		return segments;
-	}
-
-	auto calculateAggregates(const data_dict_t &dict, size_t reduction_factor) -> std::vector<data_aggregate_t> {
-		const auto segments = createSegments(std::span{*dict.timestamp}, dict.delta_t * 10);
-
-		std::vector<data_aggregate_t> aggregates{};
-		aggregates.reserve((dict.data->size() / reduction_factor) + segments.size() + 1);
-
-		for (const auto& segment: segments) {
-			const auto segment_value_span =
-				std::span{*dict.data}.subspan(segment.first, segment.second - segment.first + 1);
-			const auto segment_date_span =
-				std::span{*dict.timestamp}.subspan(segment.first, segment.second - segment.first + 1);
-
-			for (size_t i = 0; i < segment_value_span.size(); i += reduction_factor) {
-				if (i >= segment_value_span.size()) {
-					break;
-				}
-
-				const auto count = std::min(reduction_factor, segment_value_span.size() - i);
-				const auto value_span = segment_value_span.subspan(i, count);
-				const auto date_span = segment_date_span.subspan(i, count);
-
-				if (count >= 3) {
-					const auto mean = calcMean(value_span);
-					const auto stdev = calcStd(value_span, mean);
-					const auto min = calcMin(value_span);
-					const auto max = calcMax(value_span);
-
-					aggregates.push_back({.date = date_span.front(),
-										  .min = min,
-										  .max = max,
-										  .mean = mean,
-										  .std = stdev,
-										  .first = value_span.front()});
-				} else {
-					aggregates.push_back({.date = date_span.front(),
-										  .min = value_span.front(),
-										  .max = value_span.front(),
-										  .mean = value_span.front(),
-										  .std = 0,
-										  .first = value_span.front()});
-				}
-			}
-
-			aggregates.push_back({.date = segment_date_span.back(),
-								  .min = std::numeric_limits<double>::quiet_NaN(),
-								  .max = std::numeric_limits<double>::quiet_NaN(),
-								  .mean = std::numeric_limits<double>::quiet_NaN(),
-								  .std = std::numeric_limits<double>::quiet_NaN(),
-								  .first = std::numeric_limits<double>::quiet_NaN()});
-		}
-
-		aggregates.shrink_to_fit();
-		return aggregates;
-	}
-
-	auto getValueRangeAggregated(const data_dict_t &dict, size_t reduction_factor) -> std::pair<double, double> {
-		auto max_val = std::numeric_limits<double>::lowest();
-		auto min_val = std::numeric_limits<double>::max();
-
-		for (size_t i = 0; i < dict.data->size(); i += reduction_factor) {
-			if (i >= dict.data->size()) {
-				break;
-			}
-
-			const auto count = std::min(reduction_factor, dict.data->size() - i);
-
-			if (reduction_factor == 1) {
-				max_val = std::max(max_val, dict.data->at(i));
-				min_val = std::min(min_val, dict.data->at(i));
-			} else if (reduction_factor <= 100) {
-				const auto min = calcMin(std::span{*dict.data}.subspan(i, count));
-				const auto max = calcMax(std::span{*dict.data}.subspan(i, count));
-				
-				max_val = std::max(max_val, max);
-				min_val = std::min(min_val, min);
-			} else {
-				const auto mean = calcMean(std::span{*dict.data}.subspan(i, count));
-				const auto stdev = calcStd(std::span{*dict.data}.subspan(i, count), mean);
-				
-				max_val = std::max(max_val, mean + stdev);
-				min_val = std::min(min_val, mean - stdev);
-			}
-		}
-
-		return {min_val, max_val};
-	}
-
 	auto recalculateFitZoomRange(data_dict_t &dict) -> void {
 		const auto max_data_points = AppState::getInstance().max_data_points;
 		if (dict.fit_zoom_calculated_for_points != max_data_points) {
 			const auto full_reduction_factor = calculateFullZoomReductionFactor(dict);
-			dict.fit_zoom_range = getValueRangeAggregated(dict, full_reduction_factor);
+			dict.fit_zoom_range = AggregateCache::getInstance().getFitRange(dict, full_reduction_factor);
 			dict.fit_zoom_calculated_for_points = max_data_points;
 		}
 	}
 
 	auto checkAggregate(data_dict_t& dict, size_t reduction_factor) -> void {
-		if (dict.aggregated_to == reduction_factor && !dict.aggregates.empty()) {
+		if (dict.aggregates != nullptr && dict.aggregates->reduction_factor == reduction_factor) {
 			return;
 		}
 
-		spdlog::debug("recalculating aggregates for {} with reduction factor {}", dict.name, reduction_factor);
+		spdlog::debug("switching aggregates for {} to reduction factor {}", dict.name, reduction_factor);
+		dict.aggregates = AggregateCache::getInstance().getLevel(dict, reduction_factor);
 
-		dict.aggregates = calculateAggregates(dict, reduction_factor);
-		dict.aggregated_to = reduction_factor;
+		// zooming by one step finds its level ready, the raw samples are never worth keeping twice
+		std::vector<size_t> neighbours{};
+		if (const auto it = std::ranges::find(reduction_steps, reduction_factor); it != reduction_steps.end()) {
+			if (it != reduction_steps.begin() && *std::prev(it) > 1) {
+				neighbours.push_back(*std::prev(it));
+			}
+
+			if (std::next(it) != reduction_steps.end()) {
+				neighbours.push_back(*std::next(it));
+			}
+		}
 
-		spdlog::debug("recalculated aggregates for {} with reduction factor {}", dict.name, reduction_factor);
+		AggregateCache::getInstance().prefetchLevels(dict, neighbours);
 	}
 
 	auto getDateRange(const data_dict_t &data) -> std::pair<double, double> {
@@ -317,28 +132,8 @@ namespace {
 		return {start_index, stop_index};
 	}
 
-	auto getXLims(const std::vector<data_dict_t> &data) -> std::pair<double, double> {
-		auto date_min = std::numeric_limits<time_t>::max();
-		auto date_max = std::numeric_limits<time_t>::lowest();
-
-		for (const auto &col : data) {
-			if (!col.visible) {
-				continue;
-			}
-
-			if (col.timestamp->empty()) {
-				continue;
-			}
-
-			date_min = std::min(date_min, col.timestamp->front());
-			date_max = std::max(date_max, col.timestamp->back());
-		}
-
-		return {static_cast<double>(date_min), static_cast<double>(date_max)};
-	}
-
-	auto getPaddedXLims(const std::vector<data_dict_t> &data) -> std::pair<double, double> {
-		auto [date_min, date_max] = getXLims(data);
+	auto getPaddedXLims(const view_state_t &view_state) -> std::pair<double, double> {
+		const auto [date_min, date_max] = view_state.x_lims;
 
 		const auto padding_percent = ImPlot::GetStyle().FitPadding.x;
 		const auto full_range = date_max - date_min;
@@ -358,7 +153,7 @@ namespace {
 		return {data_min - padding, data_max + padding};
 	}
 
-	auto fixSubplotRanges(const std::vector<data_dict_t> &data) -> void {
+	auto fixSubplotRanges(const view_state_t &view_state) -> void {
 		auto *implot_ctx = ImPlot::GetCurrentContext();
 		auto *subplot = implot_ctx->CurrentSubplot;
 
@@ -366,22 +161,8 @@ namespace {
 			return;
 		}
 
-		auto data_min = std::numeric_limits<double>::max();
-		auto data_max = std::numeric_limits<double>::lowest();
-		const auto [date_min, date_max] = getPaddedXLims(data);
-
-		for (const auto &col : data) {
-			if (!col.visible) {
-				continue;
-			}
-
-			if (col.timestamp->empty()) {
-				continue;
-			}
-
-			data_min = std::min(data_min, *std::ranges::min_element(*col.data));
-			data_max = std::max(data_max, *std::ranges::max_element(*col.data));
-		}
+		const auto [data_min, data_max] = view_state.value_lims;
+		const auto [date_min, date_max] = getPaddedXLims(view_state);
 
 		for (auto &col_link_data : subplot->ColLinkData) {
 			if (col_link_data.Min == 0 && col_link_data.Max == 1) {
@@ -457,27 +238,32 @@ namespace {
 		if ((app_state.always_show_cursor || app_state.is_ctrl_pressed) &&
 			app_state.global_x_mouse_position >= static_cast<double>(col.timestamp->front()) &&
 			app_state.global_x_mouse_position <= static_cast<double>(col.timestamp->back())) {
-				const auto scatter_line_name = "##" + col.uuid + "scatter_line_y";
 				const auto [val_x, val_y] = getValueOf(col, app_state.global_x_mouse_position);
 
-				const auto value_string = fmt::format("{:g}{}{}", val_y, col.unit.empty() ? "" : " ", col.unit);				
+				std::array<char, 64> value_string{};
+				fmt::format_to_n(value_string.data(), value_string.size() - 1, "{:g}{}{}", val_y,
+								 col.unit.empty() ? "" : " ", col.unit);
 				const auto annotation_offset = getAnnotationOffset(val_x, val_y);
 
 				ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, 0.25f);
 				ImPlot::SetNextMarkerStyle(ImPlotMarker_Square, 5.0f, plot_color, IMPLOT_AUTO, plot_color);
-				ImPlot::PlotScatter(scatter_line_name.c_str(), &val_x, &val_y, 1);
+				ImPlot::PlotScatter(col.ids.scatter_line.c_str(), &val_x, &val_y, 1);
 				ImPlot::PopStyleVar();
-				ImPlot::Annotation(val_x, val_y, plot_color, annotation_offset, false, "%s", value_string.c_str());
+				ImPlot::Annotation(val_x, val_y, plot_color, annotation_offset, false, "%s", value_string.data());
 			}
 	}
 
-	auto plotSingleMesurement(data_dict_t &col, const ImVec4 &plot_color, const std::pair<double, double> &date_lims)
-		-> void {
+	struct prepared_plot_t {
+		plot_data_t plot_data;
+		size_t reduction_factor;  // before rounding up to the next aggregation step
+	};
+
+	auto preparePlotData(data_dict_t &col, const ImPlotRange &x_range, const std::pair<double, double> &date_lims)
+		-> prepared_plot_t {
 		auto &app_state = AppState::getInstance();
 		const auto max_data_points = static_cast<size_t>(std::max(app_state.max_data_points, 1));
-		
-		const auto limits = ImPlot::GetPlotLimits(ImAxis_X1);
-		const auto [start_index, stop_index] = getIndicesFromTimeRange(*col.timestamp, limits.X);
+
+		const auto [start_index, stop_index] = getIndicesFromTimeRange(*col.timestamp, x_range);
 		const auto points_in_range = stop_index - start_index;
 		const auto reduction_factor =
 			std::clamp(fastCeil<size_t>(points_in_range, max_data_points), 1uz, std::numeric_limits<size_t>::max());
@@ -485,19 +271,65 @@ namespace {
 
 		checkAggregate(col, reduction_factor_stepped);
 
-		const auto [start_index_agg, stop_index_agg] = getIndicesFromAggregate(col.aggregates, limits.X);
+		const auto [start_index_agg, stop_index_agg] = getIndicesFromAggregate(col.aggregates->values, x_range);
 		const auto count = [&]() -> int {
 			auto temp = stop_index_agg - start_index_agg + 1;
-			temp = std::clamp(temp, 0uz, col.aggregates.size());
+			temp = std::clamp(temp, 0uz, col.aggregates->values.size());
 			return static_cast<int>(temp);
 		}();
-		const auto padded_count = count + 4;
 
-		plot_data_t plot_data{.data = &col,
+		return {.plot_data = {.data = &col,
 							  .reduction_factor = reduction_factor_stepped,
 							  .start_index = start_index_agg,
-							  .count = padded_count,
-							  .linked_date_range = date_lims};
+							  .count = count + 4,
+							  .linked_date_range = date_lims},
+				.reduction_factor = reduction_factor};
+	}
+
+	// rolling statistics of the column, drawn as plain lines on the same axis
+	auto plotRollingOverlays(const data_dict_t &col, const ImVec4 &plot_color, const ImPlotRange &x_range,
+							 const std::pair<double, double> &date_lims, rolling_overlays_t &overlays) -> void {
+		const auto it = overlays.find(col.uuid);
+		if (it == overlays.end()) {
+			return;
+		}
+
+		auto &overlay = it->second;
+		overlay.update(col, x_range.Min, x_range.Max);
+
+		for (auto &series : overlay.getSeries()) {
+			auto prepared = preparePlotData(series, x_range, date_lims);
+			const auto getter = prepared.reduction_factor > 1 ? plotDictMean : plotDict;
+
+			ImPlot::SetNextLineStyle(ImVec4(plot_color.x, plot_color.y, plot_color.z, 0.6f), 2.0f);
+			ImPlot::PlotLineG(series.name.c_str(), getter, &prepared.plot_data, prepared.plot_data.count);
+		}
+	}
+
+	// p1 to p99 of the visible range as band and the median as line, as calculated by the histogram window
+	auto drawPercentileBand(const data_dict_t &col, const ImVec4 &plot_color, const ImPlotRange &x_range,
+							const histogram_panel_state_t &histogram) -> void {
+		if (!histogram.open || !histogram.show_band || histogram.result_uuid != col.uuid ||
+			histogram.result.digest.count() <= 0.0) {
+			return;
+		}
+
+		const auto &[p1, p50, p99] = histogram.percentiles;
+		const auto xs = std::array{x_range.Min, x_range.Max};
+		const auto lower = std::array{p1, p1};
+		const auto upper = std::array{p99, p99};
+
+		ImPlot::SetNextFillStyle(plot_color, 0.1f);
+		ImPlot::PlotShaded("p1 - p99##percentile_band", xs.data(), lower.data(), upper.data(), 2);
+		ImPlot::SetNextLineStyle(ImVec4(plot_color.x, plot_color.y, plot_color.z, 0.5f));
+		ImPlot::PlotInfLines("median##percentile_band", &p50, 1, ImPlotInfLinesFlags_Horizontal);
+	}
+
+	auto plotSingleMesurement(data_dict_t &col, const ImVec4 &plot_color, const std::pair<double, double> &date_lims,
+							  WindowContext &window_context) -> void {
+		const auto limits = ImPlot::GetPlotLimits(ImAxis_X1);
+		auto [plot_data, reduction_factor] = preparePlotData(col, limits.X, date_lims);
+		const auto padded_count = plot_data.count;
 
 		switch (col.data_type) {
 			using enum data_type_t;
@@ -509,7 +341,7 @@ namespace {
 			ImPlot::SetNextLineStyle(plot_color);
 
 			if (reduction_factor > 1) {
-				const auto shaded_name = "##" + col.name + "##shaded";
+				const auto &shaded_name = col.ids.shaded;
 				ImPlot::PlotLineG(col.name.c_str(), plotDictMean, &plot_data, padded_count);
 
 				if (reduction_factor >= 100) {
@@ -530,19 +362,12 @@ namespace {
 			break;
 		}
 
-		drawTag(col, plot_color);
-	}
-
-	auto getFormatString(const data_dict_t &col) -> std::string {
-		if (col.unit.empty()) {
-			return "%g";
-		}
-
-		if (col.unit == "%") {
-			return "%g%%";
+		if (col.data_type == data_type_t::FLOAT) {
+			plotRollingOverlays(col, plot_color, limits.X, date_lims, window_context.getRollingOverlaysRef());
+			drawPercentileBand(col, plot_color, limits.X, window_context.getHistogramPanelStateRef());
 		}
 
-		return "%g " + col.unit;
+		drawTag(col, plot_color);
 	}
 
 	struct axes_spec_t {
@@ -553,8 +378,9 @@ namespace {
 		// NOLINTEND(misc-non-private-member-variables-in-classes)
 	};
 
-	auto prepareAxes(std::vector<std::string> &assigned_plot_ids, std::vector<data_dict_t> &data,
-					 const std::vector<ImVec4> &color_map, const bool is_x_linked) -> std::vector<axes_spec_t> {
+	auto prepareAxes(std::vector<axes_spec_t> &axes_specs, std::vector<std::string> &assigned_plot_ids,
+					 std::vector<data_dict_t> &data, const view_state_t &view_state,
+					 const std::vector<ImVec4> &color_map, const bool is_x_linked) -> void {
 		auto &app_state = AppState::getInstance();
 
 		static constexpr auto axes = std::array{
@@ -571,7 +397,7 @@ namespace {
 				return app_state.date_range;
 			}
 
-			return getPaddedXLims(data);
+			return getPaddedXLims(view_state);
 		}();
 
 		const auto require_reset = [&]() -> bool {
@@ -586,16 +412,10 @@ namespace {
 		ImPlot::SetupAxisLimits(ImAxis_X1, date_lims.first, date_lims.second,
 								require_reset ? ImGuiCond_Always : ImGuiCond_Once);
 
-		std::vector<axes_spec_t> axes_specs{};
-		axes_specs.reserve(3);
+		axes_specs.clear();
 
-		const auto old_assigned_plot_ids = assigned_plot_ids;
-		assigned_plot_ids.clear();
-
-		for (size_t i = 0; auto &col : data) {
-			if (!col.visible) {
-				continue;
-			}
+		for (size_t i = 0; const auto &index : view_state.visible_columns) {
+			auto &col = data[index];
 
 			if (col.timestamp->empty()) {
 				continue;
@@ -608,27 +428,36 @@ namespace {
 			const auto axis = axes[i];
 
 			const axes_spec_t spec{.axis = axis, .color = color_map[i % color_map.size()], .col = col};
-			const auto is_new_data = i < old_assigned_plot_ids.size() ? old_assigned_plot_ids[i] != col.uuid : true;
+			const auto is_new_data = i < assigned_plot_ids.size() ? assigned_plot_ids[i] != col.uuid : true;
 
 			ImPlot::SetupAxis(axis, col.name.c_str(), i % 2 != 0 ? ImPlotAxisFlags_Opposite : ImPlotAxisFlags_None);
-			ImPlot::SetupAxisFormat(axis, getFormatString(col).c_str());
+			ImPlot::SetupAxisFormat(axis, col.ids.axis_format.c_str());
 
 			const auto data_lims = getPaddedYLims(col);
 			ImPlot::SetupAxisLimits(axis, data_lims.first, data_lims.second,
 									is_new_data ? ImGuiCond_Always : ImGuiCond_Once);
 
 			axes_specs.push_back(spec);
-			assigned_plot_ids.push_back(col.uuid);
+
+			// assigning into the existing strings reuses their buffers
+			if (i < assigned_plot_ids.size()) {
+				if (is_new_data) {
+					assigned_plot_ids[i] = col.uuid;
+				}
+			} else {
+				assigned_plot_ids.push_back(col.uuid);
+			}
+
 			++i;
 		}
 
-		return axes_specs;
+		assigned_plot_ids.resize(axes_specs.size());
 	}
 
 	auto drawCursor(const data_dict_t &col) -> void {
 		auto &app_state = AppState::getInstance();
 		const auto cursor_color = getCursorColor();
-		const auto inf_line_name = "##" + col.uuid + "inf_line";
+		const auto &inf_line_name = col.ids.inf_line;
 
 		if (ImPlot::IsPlotHovered()) {
 			app_state.global_x_mouse_position =
@@ -643,7 +472,7 @@ namespace {
 		}
 	}
 
-	auto doPlotSingle(const axes_spec_t &axis_spec, bool is_x_linked) -> void {
+	auto doPlotSingle(const axes_spec_t &axis_spec, bool is_x_linked, WindowContext &window_context) -> void {
 		const auto date_lims = [&]() {
 			if (is_x_linked) {
 				auto &app_state = AppState::getInstance();
@@ -656,11 +485,19 @@ namespace {
 		drawCursor(axis_spec.col);
 
 		ImPlot::SetAxis(axis_spec.axis);
-		plotSingleMesurement(axis_spec.col, axis_spec.color, date_lims);
+		plotSingleMesurement(axis_spec.col, axis_spec.color, date_lims, window_context);
+	}
+
+	// set e.g. by the event search, applies to every plot of the window in this frame
+	auto applyRequestedXRange(const WindowContext &window_context) -> void {
+		if (const auto &range = window_context.getRequestedXRange(); range.has_value()) {
+			ImPlot::SetNextAxisLimits(ImAxis_X1, range->first, range->second, ImPlotCond_Always);
+		}
 	}
 
 	auto doPlotSubplots(int current_pos, int n_selected, int col_count, data_dict_t &col, const ImVec4 &plot_color,
-						const std::pair<double, double> &window_date_range, bool is_x_global_linked) -> void {
+						const std::pair<double, double> &window_date_range, bool is_x_global_linked,
+						WindowContext &window_context, ImPlotRange &visible_x_range) -> void {
 		auto &app_state = AppState::getInstance();
 		double &global_link_min = app_state.global_link.first;
 		double &global_link_max = app_state.global_link.second;
@@ -674,8 +511,9 @@ namespace {
 			ImPlot::SetNextAxisLinks(ImAxis_X1, &global_link_min, &global_link_max);
 		}
 
-		const auto plot_title = col.name + "##" + col.uuid;
-		if (ImPlot::BeginPlot(plot_title.c_str(), ImVec2(-1, 0),
+		applyRequestedXRange(window_context);
+
+		if (ImPlot::BeginPlot(col.ids.label.c_str(), ImVec2(-1, 0),
 							  (n_selected < 1 ? ImPlotFlags_NoLegend : 0) | ImPlotFlags_NoTitle)) {
 			const auto show_x_axis = [&]() -> bool {
 				if (current_pos >= n_selected - col_count) {
@@ -689,7 +527,7 @@ namespace {
 
 			ImPlot::SetupAxes("date", col.name.c_str(), x_axis_flags);
 			ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
-			ImPlot::SetupAxisFormat(ImAxis_Y1, getFormatString(col).c_str());
+			ImPlot::SetupAxisFormat(ImAxis_Y1, col.ids.axis_format.c_str());
 
 			const auto date_range = [is_x_linked, is_x_global_linked, current_subplot, &col, &global_link_min,
 									 &global_link_max]() {
@@ -732,7 +570,8 @@ namespace {
 				return getDateRange(col);
 			}();
 
-			plotSingleMesurement(col, plot_color, date_lims);
+			plotSingleMesurement(col, plot_color, date_lims, window_context);
+			visible_x_range = ImPlot::GetPlotLimits(ImAxis_X1).X;
 
 			drawCursor(col);
 
@@ -742,14 +581,13 @@ namespace {
 }  // namespace
 
 auto plotDataInSubplots(WindowContext &window_context) -> void {
+	const profiler::ScopedTimer timer{profiler::stage::plot};
 	const auto plot_size = ImGui::GetContentRegionAvail();
 
-	static auto data_filter = [](const auto &dct) { return dct.visible; };
-
 	auto &data = window_context.getData();
+	const auto &view_state = window_context.getViewState();
 
-	const auto n_selected =
-		static_cast<int>(std::count_if(data.begin(), data.end(), data_filter));
+	const auto n_selected = static_cast<int>(view_state.visible_columns.size());
 
 	if (n_selected == 0) {
 		return;
@@ -767,10 +605,10 @@ auto plotDataInSubplots(WindowContext &window_context) -> void {
 
 	if (window_context.getForceSubplot() &&
 		(std::isnan(app_state.global_link.first) || std::isnan(app_state.global_link.second))) {
-		app_state.global_link = getPaddedXLims(data);
+		app_state.global_link = getPaddedXLims(view_state);
 	}
 
-	const auto subplot_id = "##" + window_context.getUUID();
+	const auto &subplot_id = window_context.getPlotID();
 
 	static const auto color_map = [&] -> std::vector<ImVec4> {
 		const auto n_colors = ImPlot::GetColormapSize();
@@ -784,8 +622,8 @@ auto plotDataInSubplots(WindowContext &window_context) -> void {
 		return colors;
 	}();
 
-	for (auto& col : data | std::views::filter(data_filter)) {
-		recalculateFitZoomRange(col);
+	for (const auto &index : view_state.visible_columns) {
+		recalculateFitZoomRange(data[index]);
 	}
 
 	const auto is_x_linked = window_context.getGlobalXLink();
@@ -796,17 +634,20 @@ auto plotDataInSubplots(WindowContext &window_context) -> void {
 		
 			if (ImPlot::BeginSubplots(subplot_id.c_str(), rows, cols, plot_size, subplot_flags)) {
 			if (!is_x_linked) {
-				fixSubplotRanges(data);
+				fixSubplotRanges(view_state);
 			}
 
-			const auto window_date_range = getXLims(data);
+			const auto &window_date_range = view_state.x_lims;
+			ImPlotRange visible_x_range{window_date_range.first, window_date_range.second};
 
-			for (int i = 0; auto &col : data | std::views::filter(data_filter)) {
-				doPlotSubplots(i, n_selected, cols, col, color_map[coerceCast<size_t>(i) % color_map.size()],
-							   window_date_range, is_x_linked);
+			for (int i = 0; const auto &index : view_state.visible_columns) {
+				doPlotSubplots(i, n_selected, cols, data[index], color_map[coerceCast<size_t>(i) % color_map.size()],
+							   window_date_range, is_x_linked, window_context, visible_x_range);
 				++i;
 			}
 
+			window_context.setVisibleXRange(visible_x_range.Min, visible_x_range.Max);
+
 			ImPlot::EndSubplots();
 		}
 	} else {
@@ -814,12 +655,23 @@ auto plotDataInSubplots(WindowContext &window_context) -> void {
 			ImPlot::SetNextAxisLinks(ImAxis_X1, &app_state.global_link.first, &app_state.global_link.second);
 		}
 
+		applyRequestedXRange(window_context);
+
 		if (ImPlot::BeginPlot(subplot_id.c_str(), plot_size, ImPlotFlags_NoTitle)) {
-			for (const auto &e : prepareAxes(window_context.getAssignedPlotIDsRef(), data, color_map, is_x_linked)) {
-				doPlotSingle(e, is_x_linked);
+			// frame scoped scratch storage, keeps its capacity between frames
+			static std::vector<axes_spec_t> axes_specs{};
+			prepareAxes(axes_specs, window_context.getAssignedPlotIDsRef(), data, view_state, color_map, is_x_linked);
+
+			for (const auto &e : axes_specs) {
+				doPlotSingle(e, is_x_linked, window_context);
 			}
 
+			const auto visible_x_range = ImPlot::GetPlotLimits(ImAxis_X1).X;
+			window_context.setVisibleXRange(visible_x_range.Min, visible_x_range.Max);
+
 			ImPlot::EndPlot();
 		}
 	}
+
+	window_context.clearRequestedXRange();
 }
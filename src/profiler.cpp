@@ -0,0 +1,222 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+#include "string_helpers.hpp"
+
+namespace profiler {
+	namespace {
+		constexpr auto stage_names = std::array<std::string_view, stage_count>{
+			"loadCSV", "parseDate", "merge", "finalize", "calculateAggregates", "evaluateDerivedColumns",
+			"calculateRolling", "calculateSpectrum", "calculateCorrelationMatrix", "buildColumnSketches", "findEvents",
+			"joinColumns", "binDensity", "buildRangeIndex", "buildCatalog",
+			"exportResampled", "plotDataInSubplots", "render", "frame"};
+
+#ifdef ENABLE_PROFILING
+		constexpr size_t history_size = 256;
+
+		struct stage_history_t {
+			std::array<float, history_size> samples_ms{};
+			size_t next{0};
+			size_t total_count{0};
+			double last_ms{0.0};
+		};
+
+		struct trace_state_t {
+			std::ofstream file{};
+			clock::time_point start{};
+			bool first_event{true};
+			uint32_t next_thread_id{1};
+		};
+
+		// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+		std::mutex history_mutex;
+		std::array<stage_history_t, stage_count> histories{};
+
+		std::mutex trace_mutex;
+		trace_state_t trace_state{};
+		std::atomic<bool> tracing{false};
+
+		thread_local uint32_t trace_thread_id{0};
+		thread_local std::string trace_thread_name{};
+		// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+		auto toTraceTimestamp(clock::time_point tp) -> double {
+			return std::chrono::duration<double, std::micro>(tp - trace_state.start).count();
+		}
+
+		// needs trace_mutex to be held
+		auto writeTraceEvent(const std::string &event) -> void {
+			if (!trace_state.first_event) {
+				trace_state.file << ",\n";
+			}
+
+			trace_state.file << event;
+			trace_state.first_event = false;
+		}
+
+		// needs trace_mutex to be held, assigns a small id to the calling thread and emits its name
+		auto getTraceThreadID() -> uint32_t {
+			if (trace_thread_id == 0) {
+				trace_thread_id = trace_state.next_thread_id++;
+			}
+
+			static thread_local bool name_written{false};
+			if (!name_written) {
+				const auto name =
+					trace_thread_name.empty() ? fmt::format("worker {}", trace_thread_id) : trace_thread_name;
+				writeTraceEvent(fmt::format(
+					R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})",
+					trace_thread_id, escapeJSON(name)));
+				name_written = true;
+			}
+
+			return trace_thread_id;
+		}
+#endif
+	}  // namespace
+
+	auto getStageName(stage s) -> std::string_view {
+		return stage_names.at(static_cast<size_t>(s));
+	}
+
+#ifdef ENABLE_PROFILING
+	auto record(stage s, clock::duration duration) -> void {
+		const auto ms = std::chrono::duration<double, std::milli>(duration).count();
+
+		const std::lock_guard lock{history_mutex};
+		auto &history = histories.at(static_cast<size_t>(s));
+
+		history.samples_ms.at(history.next) = static_cast<float>(ms);
+		history.next = (history.next + 1) % history_size;
+		history.last_ms = ms;
+		++history.total_count;
+	}
+
+	auto getStageStatistics(stage s) -> stage_statistics_t {
+		const std::lock_guard lock{history_mutex};
+		const auto &history = histories.at(static_cast<size_t>(s));
+
+		stage_statistics_t stats{};
+		stats.total_count = history.total_count;
+		stats.last_ms = history.last_ms;
+
+		const auto count = std::min(history.total_count, history_size);
+		stats.samples_ms.reserve(count);
+
+		const auto first = count < history_size ? 0 : history.next;
+		for (size_t i = 0; i < count; ++i) {
+			stats.samples_ms.push_back(history.samples_ms.at((first + i) % history_size));
+		}
+
+		if (!stats.samples_ms.empty()) {
+			double sum = 0.0;
+
+			for (const auto &e : stats.samples_ms) {
+				sum += static_cast<double>(e);
+				stats.max_ms = std::max(stats.max_ms, static_cast<double>(e));
+			}
+
+			stats.mean_ms = sum / static_cast<double>(stats.samples_ms.size());
+		}
+
+		return stats;
+	}
+
+	auto reset() -> void {
+		const std::lock_guard lock{history_mutex};
+		histories = {};
+	}
+
+	auto isTracing() -> bool {
+		return tracing.load(std::memory_order_relaxed);
+	}
+
+	auto startTrace(const std::filesystem::path &path) -> bool {
+		const std::lock_guard lock{trace_mutex};
+
+		if (tracing) {
+			return false;
+		}
+
+		trace_state = {};
+		trace_state.file.open(path, std::ios::out | std::ios::trunc);
+
+		if (!trace_state.file.is_open()) {
+			spdlog::error("Could not open trace file: {}", path.string());
+			return false;
+		}
+
+		trace_state.start = clock::now();
+		trace_state.file << R"({"displayTimeUnit":"ms","traceEvents":[)" << "\n";
+		tracing = true;
+
+		spdlog::info("Writing trace to {}", path.string());
+		return true;
+	}
+
+	auto stopTrace() -> void {
+		const std::lock_guard lock{trace_mutex};
+
+		if (!tracing) {
+			return;
+		}
+
+		tracing = false;
+		trace_state.file << "\n]}\n";
+		trace_state.file.close();
+	}
+
+	auto setThreadName(std::string_view name) -> void {
+		trace_thread_name = name;
+	}
+
+	auto traceSpan(stage s, clock::time_point start, clock::time_point stop, std::string_view detail) -> void {
+		const std::lock_guard lock{trace_mutex};
+
+		if (!tracing) {
+			return;
+		}
+
+		const auto tid = getTraceThreadID();
+		const auto ts = toTraceTimestamp(start);
+		const auto dur = std::chrono::duration<double, std::micro>(stop - start).count();
+
+		if (detail.empty()) {
+			writeTraceEvent(
+				fmt::format(R"({{"name":"{}","cat":"pipeline","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":1,"tid":{}}})",
+							getStageName(s), ts, dur, tid));
+		} else {
+			writeTraceEvent(fmt::format(
+				R"({{"name":"{}","cat":"pipeline","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":1,"tid":{},"args":{{"detail":"{}"}}}})",
+				getStageName(s), ts, dur, tid, escapeJSON(detail)));
+		}
+	}
+#else
+	auto getStageStatistics(stage /*s*/) -> stage_statistics_t {
+		return {};
+	}
+
+	auto reset() -> void {}
+
+	auto startTrace(const std::filesystem::path & /*path*/) -> bool {
+		spdlog::warn("Tracing is not available, profiling has been disabled at compile time");
+		return false;
+	}
+
+	auto stopTrace() -> void {}
+	auto setThreadName(std::string_view /*name*/) -> void {}
+#endif
+}  // namespace profiler
@@ -0,0 +1,142 @@
+#include "quantile_sketch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace {
+	// k1 scale function of the t-digest paper, limits centroid sizes to ~q * (1 - q)
+	auto scale(double q, double compression) -> double {
+		return compression / (2.0 * std::numbers::pi) * std::asin((2.0 * q) - 1.0);
+	}
+
+	auto inverseScale(double k, double compression) -> double {
+		return (std::sin(k * 2.0 * std::numbers::pi / compression) + 1.0) / 2.0;
+	}
+}  // namespace
+
+auto TDigest::fromValues(std::span<const double> values, double compression_factor) -> TDigest {
+	TDigest digest{compression_factor};
+	digest.centroids.reserve(values.size());
+
+	for (const auto &e : values) {
+		if (std::isnan(e)) {
+			continue;
+		}
+
+		digest.centroids.push_back({.mean = e, .weight = 1.0});
+		digest.total_weight += 1.0;
+		digest.minimum = std::isnan(digest.minimum) ? e : std::min(digest.minimum, e);
+		digest.maximum = std::isnan(digest.maximum) ? e : std::max(digest.maximum, e);
+	}
+
+	digest.compress();
+	digest.centroids.shrink_to_fit();
+
+	return digest;
+}
+
+auto TDigest::add(double value) -> void {
+	if (std::isnan(value)) {
+		return;
+	}
+
+	this->centroids.push_back({.mean = value, .weight = 1.0});
+	this->total_weight += 1.0;
+	this->minimum = std::isnan(this->minimum) ? value : std::min(this->minimum, value);
+	this->maximum = std::isnan(this->maximum) ? value : std::max(this->maximum, value);
+
+	this->compressIfFull();
+}
+
+auto TDigest::merge(const TDigest &other) -> void {
+	if (other.total_weight <= 0.0) {
+		return;
+	}
+
+	this->centroids.insert(this->centroids.end(), other.centroids.begin(), other.centroids.end());
+	this->total_weight += other.total_weight;
+	this->minimum = std::isnan(this->minimum) ? other.minimum : std::min(this->minimum, other.minimum);
+	this->maximum = std::isnan(this->maximum) ? other.maximum : std::max(this->maximum, other.maximum);
+
+	this->compressIfFull();
+}
+
+auto TDigest::compressIfFull() -> void {
+	// amortizes sorting, the unmerged buffer may grow to a multiple of the compressed size
+	if (this->centroids.size() - this->compressed_size > static_cast<size_t>(10.0 * this->compression)) {
+		this->compress();
+	}
+}
+
+auto TDigest::compress() -> void {
+	if (this->centroids.size() == this->compressed_size) {
+		return;
+	}
+
+	std::ranges::sort(this->centroids, {}, &centroid_t::mean);
+
+	size_t out{0};
+	double weight_before{0.0};
+	auto limit = inverseScale(scale(0.0, this->compression) + 1.0, this->compression) * this->total_weight;
+
+	for (size_t i = 1; i < this->centroids.size(); ++i) {
+		auto &current = this->centroids[out];
+		const auto &next = this->centroids[i];
+
+		if (weight_before + current.weight + next.weight <= limit) {
+			const auto weight = current.weight + next.weight;
+			current.mean += (next.mean - current.mean) * next.weight / weight;
+			current.weight = weight;
+			continue;
+		}
+
+		weight_before += current.weight;
+		const auto q = weight_before / this->total_weight;
+		limit = inverseScale(scale(q, this->compression) + 1.0, this->compression) * this->total_weight;
+
+		this->centroids[++out] = next;
+	}
+
+	this->centroids.resize(out + 1);
+	this->compressed_size = this->centroids.size();
+}
+
+auto TDigest::quantile(double q) const -> double {
+	if (this->centroids.empty()) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	const auto target = std::clamp(q, 0.0, 1.0) * this->total_weight;
+
+	if (this->centroids.size() == 1) {
+		return this->centroids.front().mean;
+	}
+
+	// centroids are treated as points at the middle of their weight, with min and max at both ends
+	double previous_position{0.0};
+	auto previous_mean = this->minimum;
+	double cumulative{0.0};
+
+	for (const auto &c : this->centroids) {
+		const auto position = cumulative + (c.weight / 2.0);
+
+		if (target <= position) {
+			const auto span = position - previous_position;
+			const auto fraction = span > 0.0 ? (target - previous_position) / span : 0.0;
+			return previous_mean + (fraction * (c.mean - previous_mean));
+		}
+
+		previous_position = position;
+		previous_mean = c.mean;
+		cumulative += c.weight;
+	}
+
+	const auto span = this->total_weight - previous_position;
+	const auto fraction = span > 0.0 ? (target - previous_position) / span : 1.0;
+	return previous_mean + (fraction * (this->maximum - previous_mean));
+}
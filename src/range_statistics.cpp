@@ -0,0 +1,198 @@
+#include "range_statistics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "custom_type_traits.hpp"
+#include "dicts.hpp"
+#include "event_search.hpp"
+#include "profiler.hpp"
+
+namespace {
+	using block_t = block_extrema_t::block_t;
+
+	auto combine(const block_t &a, const block_t &b) -> block_t {
+		return {.min = std::min(a.min, b.min), .max = std::max(a.max, b.max), .has_nan = a.has_nan || b.has_nan};
+	}
+
+	auto scan(std::span<const double> values) -> block_t {
+		block_t result{.min = std::numeric_limits<double>::infinity(),
+					   .max = -std::numeric_limits<double>::infinity(),
+					   .has_nan = false};
+
+		for (const auto &e : values) {
+			if (!std::isnan(e)) {
+				result.min = std::min(result.min, e);
+				result.max = std::max(result.max, e);
+			}
+		}
+
+		return result;
+	}
+
+	auto buildLevels(const block_extrema_t &extrema) -> std::vector<std::vector<block_t>> {
+		std::vector<std::vector<block_t>> levels{extrema.blocks};
+
+		for (size_t width = 2; width <= extrema.blocks.size(); width *= 2) {
+			const auto &previous = levels.back();
+			std::vector<block_t> level(extrema.blocks.size() - width + 1);
+
+			for (size_t i = 0; i < level.size(); ++i) {
+				level[i] = combine(previous[i], previous[i + (width / 2)]);
+			}
+
+			levels.push_back(std::move(level));
+		}
+
+		return levels;
+	}
+
+	// intervals longer than this are gaps, same threshold as used to split plot segments
+	auto getGapThreshold(const data_dict_t &dict) -> time_t {
+		return std::max(dict.delta_t * 10, time_t{1});
+	}
+
+	auto queryExtrema(std::span<const double> values, const range_index_t &index, size_t first, size_t last)
+		-> block_t {
+		constexpr auto block_size = block_extrema_t::block_size;
+
+		const auto first_block = (first + block_size - 1) / block_size;
+		const auto last_block = last / block_size;
+
+		if (first_block >= last_block) {
+			return scan(values.subspan(first, last - first));
+		}
+
+		const auto blocks = last_block - first_block;
+		const auto level = coerceCast<size_t>(std::bit_width(blocks) - 1u);
+		const auto width = size_t{1} << level;
+
+		auto result = combine(index.levels[level][first_block], index.levels[level][last_block - width]);
+		result = combine(result, scan(values.subspan(first, (first_block * block_size) - first)));
+		result = combine(result, scan(values.subspan(last_block * block_size, last - (last_block * block_size))));
+
+		return result;
+	}
+}  // namespace
+
+auto range_index_t::getMemoryUsage() const -> size_t {
+	auto bytes = sizeof(range_index_t) + (this->sum.capacity() * sizeof(double)) +
+				 (this->sum_squares.capacity() * sizeof(double)) + (this->integral.capacity() * sizeof(double)) +
+				 (this->valid_count.capacity() * sizeof(size_t));
+
+	for (const auto &level : this->levels) {
+		bytes += level.capacity() * sizeof(block_t);
+	}
+
+	return bytes;
+}
+
+auto buildRangeIndex(const data_dict_t &dict, std::shared_ptr<const block_extrema_t> extrema) -> range_index_t {
+	const profiler::ScopedTimer timer{profiler::stage::range_statistics, dict.uuid};
+
+	const auto &values = *dict.data;
+	const auto &timestamps = *dict.timestamp;
+	const auto gap_threshold = getGapThreshold(dict);
+
+	range_index_t index{};
+	index.extrema = extrema != nullptr ? std::move(extrema)
+									   : std::make_shared<const block_extrema_t>(buildBlockExtrema(values));
+	index.levels = buildLevels(*index.extrema);
+
+	const auto has_nan = std::ranges::any_of(values, [](double e) { return std::isnan(e); });
+	const auto valid = std::ranges::count_if(values, [](double e) { return !std::isnan(e); });
+	if (valid > 0) {
+		index.shift = std::accumulate(values.begin(), values.end(), 0.0,
+									  [](double a, double e) { return std::isnan(e) ? a : a + e; }) /
+					  static_cast<double>(valid);
+	}
+
+	index.sum.resize(values.size() + 1);
+	index.sum_squares.resize(values.size() + 1);
+	index.integral.resize(values.size());
+	if (has_nan) {
+		index.valid_count.resize(values.size() + 1);
+	}
+
+	for (size_t i = 0; i < values.size(); ++i) {
+		const auto is_valid = !std::isnan(values[i]);
+		const auto shifted = is_valid ? values[i] - index.shift : 0.0;
+
+		index.sum[i + 1] = index.sum[i] + shifted;
+		index.sum_squares[i + 1] = index.sum_squares[i] + (shifted * shifted);
+
+		if (has_nan) {
+			index.valid_count[i + 1] = index.valid_count[i] + (is_valid ? 1 : 0);
+		}
+
+		if (i > 0) {
+			const auto dt = timestamps[i] - timestamps[i - 1];
+			const auto area = dt <= gap_threshold ? (values[i - 1] + values[i]) / 2.0 * static_cast<double>(dt) : 0.0;
+
+			index.integral[i] = index.integral[i - 1] + (std::isnan(area) ? 0.0 : area);
+		}
+	}
+
+	return index;
+}
+
+auto buildThresholdIndex(const data_dict_t &dict, double threshold) -> threshold_index_t {
+	const profiler::ScopedTimer timer{profiler::stage::range_statistics, dict.uuid};
+
+	const auto &values = *dict.data;
+	const auto &timestamps = *dict.timestamp;
+	const auto gap_threshold = getGapThreshold(dict);
+
+	threshold_index_t index{.threshold = threshold, .duration = std::vector<double>(values.size())};
+
+	for (size_t i = 1; i < values.size(); ++i) {
+		const auto dt = timestamps[i] - timestamps[i - 1];
+		const auto above = values[i - 1] > threshold && dt <= gap_threshold;
+
+		index.duration[i] = index.duration[i - 1] + (above ? static_cast<double>(dt) : 0.0);
+	}
+
+	return index;
+}
+
+auto queryRangeStatistics(const data_dict_t &dict, const range_index_t &index, const threshold_index_t *threshold,
+						  size_t first, size_t last) -> range_statistics_t {
+	range_statistics_t result{};
+	last = std::min(last, dict.data->size());
+
+	if (first >= last) {
+		return result;
+	}
+
+	result.count = index.valid_count.empty() ? last - first : index.valid_count[last] - index.valid_count[first];
+
+	if (result.count == 0) {
+		return result;
+	}
+
+	const auto n = static_cast<double>(result.count);
+	const auto mean = (index.sum[last] - index.sum[first]) / n;
+	const auto mean_squares = (index.sum_squares[last] - index.sum_squares[first]) / n;
+
+	result.mean = mean + index.shift;
+	result.std = std::sqrt(std::max(mean_squares - (mean * mean), 0.0));
+	result.integral = index.integral[last - 1] - index.integral[first];
+
+	const auto extrema = queryExtrema(*dict.data, index, first, last);
+	result.min = extrema.min;
+	result.max = extrema.max;
+
+	if (threshold != nullptr) {
+		result.duration_above = threshold->duration[last - 1] - threshold->duration[first];
+	}
+
+	return result;
+}
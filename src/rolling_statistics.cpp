@@ -0,0 +1,283 @@
+#include "rolling_statistics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "dicts.hpp"
+#include "fmt/format.h"
+#include "global_state.hpp"
+#include "memory_usage.hpp"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+	// index of the first sample inside the trailing window of sample i
+	auto getWindowStart(std::span<const time_t> timestamps, size_t i, time_t window) -> size_t {
+		const auto it = std::upper_bound(timestamps.begin(), timestamps.begin() + static_cast<ptrdiff_t>(i),
+										 timestamps[i] - window);
+		return static_cast<size_t>(it - timestamps.begin());
+	}
+
+	auto calculateMoments(std::span<const time_t> timestamps, std::span<const double> values, size_t start,
+						  size_t first, size_t last, time_t window, bool calculate_std) -> std::vector<double> {
+		std::vector<double> result{};
+		result.reserve(last - first);
+
+		// sums relative to the first value, keeps the cancellation in sum_sq - sum^2 / n small for large offsets
+		const auto reference = values[start];
+		double sum{0.0};
+		double sum_sq{0.0};
+		size_t left{start};
+
+		for (size_t i = start; i < last; ++i) {
+			const auto x = values[i] - reference;
+			sum += x;
+			sum_sq += x * x;
+
+			while (timestamps[left] <= timestamps[i] - window) {
+				const auto y = values[left] - reference;
+				sum -= y;
+				sum_sq -= y * y;
+				++left;
+			}
+
+			if (i < first) {
+				continue;
+			}
+
+			const auto n = static_cast<double>(i - left + 1);
+
+			if (!calculate_std) {
+				result.push_back(reference + (sum / n));
+			} else if (n < 2.0) {
+				result.push_back(0.0);
+			} else {
+				result.push_back(std::sqrt(std::max((sum_sq - (sum * sum / n)) / (n - 1.0), 0.0)));
+			}
+		}
+
+		return result;
+	}
+
+	// keeps the indices of all values which can still become the extremum, so every sample is pushed and popped once
+	template <typename Compare>
+	auto calculateExtremum(std::span<const time_t> timestamps, std::span<const double> values, size_t start,
+						   size_t first, size_t last, time_t window, Compare is_better) -> std::vector<double> {
+		std::vector<double> result{};
+		result.reserve(last - first);
+
+		std::deque<size_t> candidates{};
+
+		for (size_t i = start; i < last; ++i) {
+			while (!candidates.empty() && !is_better(values[candidates.back()], values[i])) {
+				candidates.pop_back();
+			}
+			candidates.push_back(i);
+
+			while (timestamps[candidates.front()] <= timestamps[i] - window) {
+				candidates.pop_front();
+			}
+
+			if (i >= first) {
+				result.push_back(values[candidates.front()]);
+			}
+		}
+
+		return result;
+	}
+
+	auto calculateLowPass(std::span<const time_t> timestamps, std::span<const double> values, size_t start,
+						  size_t first, size_t last, time_t window) -> std::vector<double> {
+		std::vector<double> result{};
+		result.reserve(last - first);
+
+		const auto time_constant = static_cast<double>(window);
+		auto y = values[start];
+
+		for (size_t i = start; i < last; ++i) {
+			if (i > start) {
+				const auto dt = static_cast<double>(timestamps[i] - timestamps[i - 1]);
+				const auto alpha = 1.0 - std::exp(-dt / time_constant);
+				y += alpha * (values[i] - y);
+			}
+
+			if (i >= first) {
+				result.push_back(y);
+			}
+		}
+
+		return result;
+	}
+}  // namespace
+
+auto getRollingStatisticName(rolling_statistic_t statistic) -> std::string_view {
+	switch (statistic) {
+		using enum rolling_statistic_t;
+	case MEAN:
+		return "mean";
+	case MIN:
+		return "min";
+	case MAX:
+		return "max";
+	case STD:
+		return "std";
+	case LOW_PASS:
+		return "low-pass";
+	}
+
+	return "";
+}
+
+auto getRollingWarmUp(rolling_statistic_t statistic, time_t window) -> time_t {
+	return statistic == rolling_statistic_t::LOW_PASS ? 5 * window : window;
+}
+
+auto calculateRolling(std::span<const time_t> timestamps, std::span<const double> values, size_t first, size_t last,
+					  rolling_statistic_t statistic, time_t window) -> std::vector<double> {
+	last = std::min({last, timestamps.size(), values.size()});
+	if (first >= last) {
+		return {};
+	}
+
+	window = std::max(window, time_t{1});
+	const auto start = getWindowStart(timestamps, first, getRollingWarmUp(statistic, window));
+
+	switch (statistic) {
+		using enum rolling_statistic_t;
+	case MEAN:
+		return calculateMoments(timestamps, values, start, first, last, window, false);
+	case STD:
+		return calculateMoments(timestamps, values, start, first, last, window, true);
+	case MIN:
+		return calculateExtremum(timestamps, values, start, first, last, window, std::less{});
+	case MAX:
+		return calculateExtremum(timestamps, values, start, first, last, window, std::greater{});
+	case LOW_PASS:
+		return calculateLowPass(timestamps, values, start, first, last, window);
+	}
+
+	return {};
+}
+
+auto rolling_settings_t::any() const -> bool {
+	return std::ranges::any_of(this->enabled, [](bool e) { return e; });
+}
+
+auto RollingOverlay::update(const data_dict_t &source, double x_min, double x_max) -> void {
+	if (this->job.valid()) {
+		if (this->job.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			return;
+		}
+
+		auto result = this->job.get();
+		this->series = std::move(result.series);
+		this->computed = std::move(result);
+	}
+
+	if (!this->settings.any() || source.timestamp->empty()) {
+		this->series.clear();
+		this->computed = {};
+		return;
+	}
+
+	const auto is_current = this->computed.settings == this->settings && this->computed.source == source.data.get() &&
+							x_min >= this->computed.from && x_max <= this->computed.to;
+
+	if (is_current) {
+		return;
+	}
+
+	// half a screen on each side, so panning does not immediately start the next calculation
+	const auto margin = (x_max - x_min) / 2.0;
+	request_t request{.timestamps = source.timestamp,
+					  .values = source.data,
+					  .name = source.name,
+					  .uuid = source.uuid,
+					  .unit = source.unit,
+					  .delta_t = source.delta_t,
+					  .settings = this->settings,
+					  .from = x_min - margin,
+					  .to = x_max + margin};
+
+	this->job = ThreadPool::getInstance().submit(
+		task_priority_t::visible, [request = std::move(request)]() -> result_t {
+			auto result = calculate(request);
+			AppState::getInstance().wakeMainLoop();
+			return result;
+		});
+}
+
+auto RollingOverlay::reset() -> void {
+	this->job = {};
+	this->computed = {};
+	this->series.clear();
+}
+
+auto RollingOverlay::getMemoryUsage() const -> size_t {
+	size_t sum{0};
+
+	for (const auto &e : this->series) {
+		sum += getColumnMemoryUsage(e).total();
+	}
+
+	return sum;
+}
+
+auto RollingOverlay::calculate(const request_t &request) -> result_t {
+	const profiler::ScopedTimer timer{profiler::stage::rolling_statistics, request.name};
+
+	result_t result{.series = {},
+					.settings = request.settings,
+					.source = request.values.get(),
+					.from = request.from,
+					.to = request.to};
+
+	const auto &timestamps = *request.timestamps;
+	const auto from = static_cast<time_t>(std::floor(request.from));
+	const auto to = static_cast<time_t>(std::ceil(request.to));
+
+	const auto first = static_cast<size_t>(std::ranges::lower_bound(timestamps, from) - timestamps.begin());
+	const auto last = static_cast<size_t>(std::ranges::upper_bound(timestamps, to) - timestamps.begin());
+
+	if (first >= last) {
+		return result;
+	}
+
+	const auto window = static_cast<time_t>(std::max(request.settings.window, 1));
+	const auto shared_timestamps = std::make_shared<std::vector<time_t>>(
+		timestamps.begin() + static_cast<ptrdiff_t>(first), timestamps.begin() + static_cast<ptrdiff_t>(last));
+
+	for (size_t i = 0; i < rolling_statistics.size(); ++i) {
+		if (!request.settings.enabled.at(i)) {
+			continue;
+		}
+
+		const auto statistic = rolling_statistics.at(i);
+
+		data_dict_t series{};
+		series.name = fmt::format("{} [{} {} s]", request.name, getRollingStatisticName(statistic), window);
+		series.uuid = fmt::format("{}_rolling_{}", request.uuid, i);
+		series.unit = request.unit;
+		series.visible = true;
+		series.timestamp = shared_timestamps;
+		series.delta_t = request.delta_t;
+		series.data = std::make_shared<std::vector<double>>(
+			calculateRolling(timestamps, *request.values, first, last, statistic, window));
+		series.updateIDs();
+
+		result.series.push_back(std::move(series));
+	}
+
+	return result;
+}
@@ -0,0 +1,203 @@
+#include "spectrum.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <ctime>
+#include <numbers>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "dicts.hpp"
+
+namespace {
+	constexpr size_t min_segment_length = 16;
+
+	auto isUniform(std::span<const time_t> timestamps, time_t interval) -> bool {
+		return std::ranges::adjacent_find(timestamps, [interval](time_t a, time_t b) { return b - a != interval; }) ==
+			   timestamps.end();
+	}
+
+	auto createHannWindow(size_t length) -> std::vector<double> {
+		std::vector<double> window(length);
+		const auto n = static_cast<double>(length);
+
+		// periodic variant, the usual choice for spectral analysis
+		for (size_t i = 0; i < length; ++i) {
+			window[i] = 0.5 - (0.5 * std::cos(2.0 * std::numbers::pi * static_cast<double>(i) / n));
+		}
+
+		return window;
+	}
+}  // namespace
+
+auto fft(std::span<std::complex<double>> data) -> void {
+	const auto n = data.size();
+	if (n < 2) {
+		return;
+	}
+
+	const auto bits = static_cast<size_t>(std::countr_zero(n));
+
+	for (size_t i = 0; i < n; ++i) {
+		size_t reversed{0};
+		for (size_t b = 0; b < bits; ++b) {
+			reversed |= ((i >> b) & 1u) << (bits - 1 - b);
+		}
+
+		if (i < reversed) {
+			std::swap(data[i], data[reversed]);
+		}
+	}
+
+	for (size_t length = 2; length <= n; length <<= 1u) {
+		const auto angle = -2.0 * std::numbers::pi / static_cast<double>(length);
+		const auto step = std::complex<double>{std::cos(angle), std::sin(angle)};
+
+		for (size_t start = 0; start < n; start += length) {
+			std::complex<double> twiddle{1.0, 0.0};
+
+			for (size_t k = 0; k < length / 2; ++k) {
+				const auto even = data[start + k];
+				const auto odd = data[start + k + (length / 2)] * twiddle;
+				data[start + k] = even + odd;
+				data[start + k + (length / 2)] = even - odd;
+				twiddle *= step;
+			}
+		}
+	}
+}
+
+auto fftReal(std::span<const double> input) -> std::vector<std::complex<double>> {
+	const auto n = input.size();
+	const auto half = n / 2;
+
+	if (n < 2) {
+		return {std::complex<double>{n == 1 ? input.front() : 0.0, 0.0}};
+	}
+
+	// even samples as real, odd samples as imaginary part
+	std::vector<std::complex<double>> packed(half);
+	for (size_t i = 0; i < half; ++i) {
+		packed[i] = {input[2 * i], input[(2 * i) + 1]};
+	}
+
+	fft(packed);
+
+	std::vector<std::complex<double>> result(half + 1);
+	const auto angle = -2.0 * std::numbers::pi / static_cast<double>(n);
+
+	for (size_t k = 0; k <= half; ++k) {
+		const auto z = packed[k % half];
+		const auto z_mirrored = std::conj(packed[(half - k) % half]);
+
+		const auto even = 0.5 * (z + z_mirrored);
+		const auto odd = std::complex<double>{0.0, -0.5} * (z - z_mirrored);
+		const auto twiddle = std::polar(1.0, angle * static_cast<double>(k));
+
+		result[k] = even + (twiddle * odd);
+	}
+
+	return result;
+}
+
+auto resampleUniform(const data_dict_t &dict, time_t from, time_t to, time_t interval) -> std::vector<double> {
+	const auto &timestamps = *dict.timestamp;
+	const auto &values = *dict.data;
+
+	if (timestamps.empty() || interval <= 0 || to < from) {
+		return {};
+	}
+
+	from = std::max(from, timestamps.front());
+	to = std::min(to, timestamps.back());
+
+	const auto first = static_cast<size_t>(std::ranges::lower_bound(timestamps, from) - timestamps.begin());
+	const auto last = static_cast<size_t>(std::ranges::upper_bound(timestamps, to) - timestamps.begin());
+
+	if (first >= last) {
+		return {};
+	}
+
+	const auto range = std::span{timestamps}.subspan(first, last - first);
+
+	if (isUniform(range, interval)) {
+		return {values.begin() + static_cast<ptrdiff_t>(first), values.begin() + static_cast<ptrdiff_t>(last)};
+	}
+
+	const auto count = static_cast<size_t>((range.back() - range.front()) / interval) + 1;
+	std::vector<double> result{};
+	result.reserve(count);
+
+	auto index = first;
+	for (size_t i = 0; i < count; ++i) {
+		const auto t = range.front() + (static_cast<time_t>(i) * interval);
+
+		while (index + 1 < last && timestamps[index + 1] <= t) {
+			++index;
+		}
+
+		if (index + 1 >= last || timestamps[index] == t) {
+			result.push_back(values[index]);
+			continue;
+		}
+
+		const auto fraction = static_cast<double>(t - timestamps[index]) /
+							  static_cast<double>(timestamps[index + 1] - timestamps[index]);
+		result.push_back(values[index] + (fraction * (values[index + 1] - values[index])));
+	}
+
+	return result;
+}
+
+auto calculateWelch(std::span<const double> samples, double sample_rate, size_t segment_length) -> psd_t {
+	psd_t result{};
+
+	if (samples.size() < min_segment_length || sample_rate <= 0.0) {
+		return result;
+	}
+
+	segment_length = std::bit_floor(std::clamp(segment_length, min_segment_length, samples.size()));
+	const auto step = segment_length / 2;
+	const auto bins = (segment_length / 2) + 1;
+
+	const auto window = createHannWindow(segment_length);
+	const auto window_power = std::inner_product(window.begin(), window.end(), window.begin(), 0.0);
+
+	result.sample_rate = sample_rate;
+	result.segment_length = segment_length;
+	result.power.assign(bins, 0.0);
+
+	std::vector<double> segment(segment_length);
+
+	for (size_t start = 0; start + segment_length <= samples.size(); start += step) {
+		const auto input = samples.subspan(start, segment_length);
+		const auto mean = std::accumulate(input.begin(), input.end(), 0.0) / static_cast<double>(segment_length);
+
+		for (size_t i = 0; i < segment_length; ++i) {
+			segment[i] = (input[i] - mean) * window[i];
+		}
+
+		const auto spectrum = fftReal(segment);
+		for (size_t k = 0; k < bins; ++k) {
+			result.power[k] += std::norm(spectrum[k]);
+		}
+
+		++result.segments;
+	}
+
+	const auto scale = 1.0 / (sample_rate * window_power * static_cast<double>(result.segments));
+	result.frequencies.resize(bins);
+
+	for (size_t k = 0; k < bins; ++k) {
+		// one-sided, all bins except DC and Nyquist contain the power of the negative frequencies as well
+		const auto one_sided = (k == 0 || k == bins - 1) ? 1.0 : 2.0;
+		result.power[k] *= scale * one_sided;
+		result.frequencies[k] = static_cast<double>(k) * sample_rate / static_cast<double>(segment_length);
+	}
+
+	return result;
+}
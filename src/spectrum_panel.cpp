@@ -0,0 +1,203 @@
+#include "spectrum_panel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <future>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "dicts.hpp"
+#include "fmt/format.h"
+#include "global_state.hpp"
+#include "imgui.h"
+#include "imgui_extensions.hpp"
+#include "implot.h"
+#include "profiler.hpp"
+#include "spectrum.hpp"
+#include "thread_pool.hpp"
+#include "window_context.hpp"
+
+namespace {
+	// limits the resampled range to 32 MiB, longer ranges are sampled coarser than delta_t
+	constexpr time_t max_samples = 1 << 22;
+
+	constexpr auto segment_lengths = std::array{256, 512, 1'024, 2'048, 4'096, 8'192, 16'384, 32'768, 65'536};
+
+	auto calculateSpectrum(const data_dict_t &column, const spectrum_key_t &key) -> psd_t {
+		const profiler::ScopedTimer timer{profiler::stage::spectrum, key.uuid};
+
+		const auto interval = std::max({column.delta_t, time_t{1}, ((key.to - key.from) / max_samples) + 1});
+		const auto samples = resampleUniform(column, key.from, key.to, interval);
+
+		return calculateWelch(samples, 1.0 / static_cast<double>(interval), key.segment_length);
+	}
+
+	auto findColumn(std::vector<data_dict_t> &data, const std::string &uuid) -> data_dict_t * {
+		const auto it = std::ranges::find(data, uuid, &data_dict_t::uuid);
+		return it != data.end() ? &*it : nullptr;
+	}
+
+	auto drawSegmentLengthCombo(spectrum_panel_state_t &state) -> void {
+		ImGui::SetNextItemWidth(100.0f);
+		if (!ImGui::BeginCombo("Segment", fmt::format("{}", state.segment_length).c_str())) {
+			return;
+		}
+
+		for (const auto &length : segment_lengths) {
+			if (ImGui::Selectable(fmt::format("{}", length).c_str(), length == state.segment_length)) {
+				state.segment_length = length;
+			}
+		}
+
+		ImGui::EndCombo();
+	}
+}  // namespace
+
+auto SpectrumJobs::get(const data_dict_t &column, const spectrum_key_t &key) -> std::shared_ptr<const psd_t> {
+	if (this->job.valid() && this->job.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+		this->latest = this->job.get();
+		this->cache[this->job_key] = this->latest;
+		this->insertion_order.push_back(this->job_key);
+
+		if (this->insertion_order.size() > cache_size) {
+			this->cache.erase(this->insertion_order.front());
+			this->insertion_order.pop_front();
+		}
+	}
+
+	if (const auto it = this->cache.find(key); it != this->cache.end()) {
+		this->latest = it->second;
+		return this->latest;
+	}
+
+	if (!this->job.valid()) {
+		// only the vectors are shared with the job, the column itself may be moved or aggregated meanwhile
+		data_dict_t source{};
+		source.timestamp = column.timestamp;
+		source.data = column.data;
+		source.delta_t = column.delta_t;
+
+		this->job_key = key;
+		this->job = ThreadPool::getInstance().submit(
+			task_priority_t::visible, [source = std::move(source), key]() -> std::shared_ptr<const psd_t> {
+				auto result = std::make_shared<const psd_t>(calculateSpectrum(source, key));
+				AppState::getInstance().wakeMainLoop();
+				return result;
+			});
+	}
+
+	return this->latest;
+}
+
+auto SpectrumJobs::isBusy() const -> bool {
+	return this->job.valid() && this->job.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+auto SpectrumJobs::clear() -> void {
+	this->cache.clear();
+	this->insertion_order.clear();
+	this->job = {};
+	this->latest.reset();
+}
+
+auto SpectrumJobs::getMemoryUsage() const -> size_t {
+	std::set<const psd_t *> spectra{this->latest.get()};
+	for (const auto &[key, psd] : this->cache) {
+		spectra.insert(psd.get());
+	}
+
+	size_t sum{0};
+	for (const auto *psd : spectra) {
+		if (psd != nullptr) {
+			sum += sizeof(psd_t) + ((psd->frequencies.capacity() + psd->power.capacity()) * sizeof(double));
+		}
+	}
+
+	return sum;
+}
+
+auto openSpectrumWindow(WindowContext &window_context) -> void {
+	auto &state = window_context.getSpectrumPanelStateRef();
+	auto &data = window_context.getData();
+	state.open = true;
+
+	if (findColumn(data, state.column_uuid) != nullptr) {
+		return;
+	}
+
+	for (const auto &index : window_context.getViewState().visible_columns) {
+		if (data[index].data_type == data_type_t::FLOAT) {
+			state.column_uuid = data[index].uuid;
+			break;
+		}
+	}
+}
+
+auto drawSpectrumWindow(WindowContext &window_context) -> void {
+	auto &state = window_context.getSpectrumPanelStateRef();
+	if (!state.open) {
+		return;
+	}
+
+	const auto title = fmt::format("Spectrum - {}##spectrum{}", window_context.getWindowTitle(),
+								   window_context.getUUID());
+
+	ImGui::SetNextWindowSize(ImVec2(700, 450), ImGuiCond_FirstUseEver);
+	if (!ImGui::Begin(title.c_str(), &state.open)) {
+		ImGui::End();
+		return;
+	}
+
+	auto &data = window_context.getData();
+	ImGui::SetNextItemWidth(250.0f);
+	ImGuiExt::FloatColumnCombo("Column", data, state.column_uuid);
+	ImGui::SameLine();
+	drawSegmentLengthCombo(state);
+
+	const auto *column = findColumn(data, state.column_uuid);
+
+	if (column == nullptr) {
+		ImGui::TextUnformatted("Select a column.");
+		ImGui::End();
+		return;
+	}
+
+	const auto [x_min, x_max] = window_context.getVisibleXRange();
+	const spectrum_key_t key{.uuid = column->uuid,
+							 .from = static_cast<time_t>(std::floor(x_min)),
+							 .to = static_cast<time_t>(std::ceil(x_max)),
+							 .segment_length = static_cast<size_t>(state.segment_length)};
+
+	const auto psd = state.jobs.get(*column, key);
+
+	if (psd != nullptr && psd->segments > 0) {
+		ImGuiExt::TextFormattedDisabled("{} segments of {} samples at {:g} Hz{}", psd->segments, psd->segment_length,
+										psd->sample_rate, state.jobs.isBusy() ? ", calculating..." : "");
+	} else {
+		ImGuiExt::TextFormattedDisabled("{}", state.jobs.isBusy() ? "calculating..." : "not enough samples in range");
+	}
+
+	window_context.switchToImPlotContext();
+
+	if (psd != nullptr && psd->frequencies.size() > 1 && ImPlot::BeginPlot("##spectrum", ImVec2(-1, -1))) {
+		const auto y_label = column->unit.empty() ? std::string{"PSD [1/Hz]"}
+												  : fmt::format("PSD [{}²/Hz]", column->unit);
+
+		ImPlot::SetupAxes("frequency [Hz]", y_label.c_str(), ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+		ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+		ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
+
+		// the DC bin has no place on a logarithmic axis
+		ImPlot::PlotLine(column->name.c_str(), psd->frequencies.data() + 1, psd->power.data() + 1,
+						 static_cast<int>(psd->frequencies.size() - 1));
+
+		ImPlot::EndPlot();
+	}
+
+	ImGui::End();
+}
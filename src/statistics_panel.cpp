@@ -0,0 +1,242 @@
+#include "statistics_panel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "dicts.hpp"
+#include "fmt/format.h"
+#include "global_state.hpp"
+#include "imgui.h"
+#include "imgui_extensions.hpp"
+#include "range_statistics.hpp"
+#include "thread_pool.hpp"
+#include "window_context.hpp"
+
+namespace {
+	auto isBusy(const statistics_panel_state_t &state) -> bool {
+		return state.job.valid() && state.job.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+	}
+
+	auto findThresholdIndex(const statistics_panel_state_t &state, const data_dict_t &col)
+		-> const threshold_index_t * {
+		const auto it = state.threshold_indexes.find(col.uuid);
+		return it != state.threshold_indexes.end() && it->second.data == col.data ? it->second.index.get() : nullptr;
+	}
+
+	auto needsThresholdIndex(const statistics_panel_state_t &state, const data_dict_t &col) -> bool {
+		return state.use_threshold && findThresholdIndex(state, col) == nullptr;
+	}
+
+	auto checkForFinishedJob(std::vector<data_dict_t> &data, statistics_panel_state_t &state) -> void {
+		if (!state.job.valid() || isBusy(state)) {
+			return;
+		}
+
+		for (auto &result : state.job.get()) {
+			// the samples of the column may have been replaced while the job was running
+			const auto it = std::ranges::find(data, result.uuid, &data_dict_t::uuid);
+			if (it == data.end() || it->data != result.data) {
+				continue;
+			}
+
+			if (result.range != nullptr) {
+				it->range_index = result.range;
+				if (it->extrema == nullptr) {
+					it->extrema = result.range->extrema;
+				}
+			}
+
+			// the threshold may have changed while the job was running
+			if (result.threshold != nullptr && result.threshold->threshold == state.threshold) {
+				state.threshold_indexes[result.uuid] = {.data = result.data, .index = std::move(result.threshold)};
+			}
+		}
+	}
+
+	auto startJob(WindowContext &window_context, statistics_panel_state_t &state) -> void {
+		const auto &data = window_context.getData();
+
+		// only the vectors are shared with the job, the columns themselves may be moved or aggregated meanwhile
+		std::vector<data_dict_t> columns{};
+		for (const auto &index : window_context.getViewState().visible_columns) {
+			const auto &col = data[index];
+			if (col.data_type != data_type_t::FLOAT || col.data->empty() ||
+				(col.range_index != nullptr && !needsThresholdIndex(state, col))) {
+				continue;
+			}
+
+			auto &copy = columns.emplace_back();
+			copy.uuid = col.uuid;
+			copy.timestamp = col.timestamp;
+			copy.data = col.data;
+			copy.delta_t = col.delta_t;
+			copy.extrema = col.extrema;
+			copy.range_index = col.range_index;
+		}
+
+		if (columns.empty()) {
+			return;
+		}
+
+		const auto threshold = state.use_threshold ? std::optional{state.threshold} : std::nullopt;
+
+		state.job = ThreadPool::getInstance().submit(
+			task_priority_t::visible, [columns = std::move(columns), threshold]() {
+				std::vector<statistics_index_t> results(columns.size());
+				std::ranges::transform(columns, results.begin(), [](const auto &e) {
+					return statistics_index_t{.uuid = e.uuid, .data = e.data};
+				});
+
+				ThreadPool::getInstance().parallelFor(task_priority_t::visible, columns.size(), [&](size_t i) {
+					const auto &col = columns[i];
+
+					if (col.range_index == nullptr) {
+						results[i].range = std::make_shared<const range_index_t>(buildRangeIndex(col, col.extrema));
+					}
+
+					if (threshold.has_value()) {
+						results[i].threshold =
+							std::make_shared<const threshold_index_t>(buildThresholdIndex(col, *threshold));
+					}
+				});
+
+				AppState::getInstance().wakeMainLoop();
+				return results;
+			});
+	}
+
+	auto drawThresholdInput(statistics_panel_state_t &state) -> void {
+		ImGui::Checkbox("Duration above", &state.use_threshold);
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(120.0f);
+
+		ImGui::BeginDisabled(!state.use_threshold);
+		ImGui::InputDouble("##threshold", &state.threshold_input);
+		ImGui::EndDisabled();
+
+		if (ImGui::IsItemDeactivatedAfterEdit() && state.threshold_input != state.threshold) {
+			state.threshold = state.threshold_input;
+			state.threshold_indexes.clear();
+		}
+	}
+
+	auto drawRow(const data_dict_t &col, const statistics_panel_state_t &state, double x_min, double x_max) -> void {
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		ImGuiExt::TextUnformatted(col.name);
+
+		const auto *threshold = findThresholdIndex(state, col);
+
+		if (col.range_index == nullptr) {
+			ImGui::TableNextColumn();
+			ImGuiExt::TextFormattedDisabled("indexing...");
+			return;
+		}
+
+		// binary searches for the range and constant time for everything else, whatever the range length
+		const auto &timestamps = *col.timestamp;
+		const auto first = std::ranges::lower_bound(timestamps, static_cast<time_t>(std::floor(x_min))) -
+						   timestamps.begin();
+		const auto last = std::ranges::upper_bound(timestamps, static_cast<time_t>(std::ceil(x_max))) -
+						  timestamps.begin();
+		const auto s = queryRangeStatistics(col, *col.range_index, threshold, static_cast<size_t>(first),
+											static_cast<size_t>(last));
+
+		ImGui::TableNextColumn();
+		ImGuiExt::TextFormatted("{}", s.count);
+
+		if (s.count == 0) {
+			return;
+		}
+
+		ImGui::TableNextColumn();
+		ImGuiExt::TextFormatted("{:.6g}", s.min);
+		ImGui::TableNextColumn();
+		ImGuiExt::TextFormatted("{:.6g}", s.max);
+		ImGui::TableNextColumn();
+		ImGuiExt::TextFormatted("{:.6g}", s.mean);
+		ImGui::TableNextColumn();
+		ImGuiExt::TextFormatted("{:.6g}", s.std);
+		ImGui::TableNextColumn();
+		ImGuiExt::TextFormatted("{:.6g}", s.integral);
+
+		if (state.use_threshold) {
+			ImGui::TableNextColumn();
+			if (threshold != nullptr) {
+				ImGuiExt::TextFormatted("{:g} s", s.duration_above);
+			} else {
+				ImGuiExt::TextFormattedDisabled("indexing...");
+			}
+		}
+	}
+}  // namespace
+
+auto openStatisticsWindow(WindowContext &window_context) -> void {
+	window_context.getStatisticsPanelStateRef().open = true;
+}
+
+auto drawStatisticsWindow(WindowContext &window_context) -> void {
+	auto &state = window_context.getStatisticsPanelStateRef();
+	auto &data = window_context.getData();
+
+	// the range indexes are handed to the columns even if the window gets closed meanwhile
+	checkForFinishedJob(data, state);
+
+	if (!state.open) {
+		return;
+	}
+
+	if (!state.job.valid()) {
+		startJob(window_context, state);
+	}
+
+	const auto title = fmt::format("Statistics - {}##statistics{}", window_context.getWindowTitle(),
+								   window_context.getUUID());
+
+	ImGui::SetNextWindowSize(ImVec2(800, 300), ImGuiCond_FirstUseEver);
+	if (!ImGui::Begin(title.c_str(), &state.open)) {
+		ImGui::End();
+		return;
+	}
+
+	drawThresholdInput(state);
+
+	const auto [x_min, x_max] = window_context.getVisibleXRange();
+	const auto column_count = state.use_threshold ? 8 : 7;
+	static constexpr auto table_flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY |
+										ImGuiTableFlags_Resizable;
+
+	if (ImGui::BeginTable("##statistics", column_count, table_flags)) {
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Column");
+		ImGui::TableSetupColumn("Count");
+		ImGui::TableSetupColumn("Min");
+		ImGui::TableSetupColumn("Max");
+		ImGui::TableSetupColumn("Mean");
+		ImGui::TableSetupColumn("Std");
+		ImGui::TableSetupColumn("Integral [x s]");
+		if (state.use_threshold) {
+			ImGui::TableSetupColumn("Above");
+		}
+		ImGui::TableHeadersRow();
+
+		for (const auto &index : window_context.getViewState().visible_columns) {
+			const auto &col = data[index];
+			if (col.data_type == data_type_t::FLOAT && !col.data->empty()) {
+				drawRow(col, state, x_min, x_max);
+			}
+		}
+
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
@@ -4,6 +4,8 @@
 #include <string>
 #include <string_view>
 
+#include "fmt/format.h"
+
 auto trim(std::string_view str) -> std::string_view {
 	const auto pos1 = str.find_first_not_of(" \t\n\r");
 	if (pos1 == std::string::npos) {
@@ -47,4 +49,47 @@ auto getIncrementedWindowTitle(const std::string &title) -> std::string {
 	}
 
 	return base_title + " (" + std::to_string(number + 1) + ")";
-}
\ No newline at end of file
+}
+
+auto escapeJSON(std::string_view str) -> std::string {
+	std::string ret{};
+	ret.reserve(str.size());
+
+	for (const auto &c : str) {
+		switch (c) {
+		case '"':
+			ret += "\\\"";
+			break;
+		case '\\':
+			ret += "\\\\";
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				ret += fmt::format("\\u{:04x}", static_cast<int>(c));
+			} else {
+				ret += c;
+			}
+		}
+	}
+
+	return ret;
+}
+
+auto escapeCSV(std::string_view str) -> std::string {
+	if (str.find_first_of(",;\"\n\r") == std::string_view::npos) {
+		return std::string(str);
+	}
+
+	std::string ret{"\""};
+	ret.reserve(str.size() + 2);
+
+	for (const auto &c : str) {
+		if (c == '"') {
+			ret += '"';
+		}
+		ret += c;
+	}
+
+	ret += '"';
+	return ret;
+}
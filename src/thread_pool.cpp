@@ -0,0 +1,159 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#include "fmt/format.h"
+#include "profiler.hpp"
+
+namespace {
+	constexpr auto no_worker = std::numeric_limits<size_t>::max();
+
+	// index of the worker running on this thread
+	thread_local size_t current_worker = no_worker;
+
+	struct parallel_for_state_t {
+		std::atomic<size_t> next{0};
+		std::atomic<size_t> done{0};
+		std::mutex mutex{};
+		std::exception_ptr exception{};
+	};
+
+	// takes indices until none are left, fn is only touched for an index actually taken
+	auto runIndices(parallel_for_state_t &state, size_t count, const std::function<void(size_t)> *fn) -> void {
+		for (auto i = state.next.fetch_add(1); i < count; i = state.next.fetch_add(1)) {
+			try {
+				(*fn)(i);
+			} catch (...) {
+				const std::lock_guard lock{state.mutex};
+				if (state.exception == nullptr) {
+					state.exception = std::current_exception();
+				}
+			}
+
+			if (state.done.fetch_add(1) + 1 == count) {
+				state.done.notify_all();
+			}
+		}
+	}
+}  // namespace
+
+ThreadPool::ThreadPool() {
+	const auto worker_count = std::max(2u, std::thread::hardware_concurrency());
+
+	for (size_t i = 0; i < worker_count; ++i) {
+		this->queues.push_back(std::make_unique<worker_queue_t>());
+	}
+
+	for (size_t i = 0; i < worker_count; ++i) {
+		this->workers.emplace_back([this, i](const std::stop_token &stop) { this->run(stop, i); });
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	for (auto &worker : this->workers) {
+		worker.request_stop();
+	}
+
+	this->wake.notify_all();
+	this->workers.clear();
+}
+
+auto ThreadPool::push(task_priority_t priority, task_t task) -> void {
+	const auto worker = current_worker != no_worker
+							? current_worker
+							: this->next_queue.fetch_add(1, std::memory_order_relaxed) % this->queues.size();
+
+	{
+		auto &queue = *this->queues[worker];
+		const std::lock_guard lock{queue.mutex};
+		queue.tasks[static_cast<size_t>(priority)].push_back(std::move(task));
+	}
+
+	{
+		const std::lock_guard lock{this->sleep_mutex};
+		++this->pending;
+	}
+
+	this->wake.notify_one();
+}
+
+auto ThreadPool::take(size_t worker) -> task_t {
+	task_t task{};
+
+	// the highest priority of all queues first, within one priority the own newest task before stealing the oldest
+	for (size_t priority = 0; priority < task_priority_count && !task; ++priority) {
+		for (size_t offset = 0; offset < this->queues.size() && !task; ++offset) {
+			auto &queue = *this->queues[(worker + offset) % this->queues.size()];
+			const std::lock_guard lock{queue.mutex};
+			auto &tasks = queue.tasks[priority];
+
+			if (tasks.empty()) {
+				continue;
+			}
+
+			if (offset == 0) {
+				task = std::move(tasks.back());
+				tasks.pop_back();
+			} else {
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+		}
+	}
+
+	if (task) {
+		const std::lock_guard lock{this->sleep_mutex};
+		--this->pending;
+	}
+
+	return task;
+}
+
+auto ThreadPool::run(const std::stop_token &stop, size_t worker) -> void {
+	current_worker = worker;
+	profiler::setThreadName(fmt::format("pool {}", worker));
+
+	while (!stop.stop_requested()) {
+		if (auto task = this->take(worker)) {
+			task();
+			continue;
+		}
+
+		std::unique_lock lock{this->sleep_mutex};
+		this->wake.wait(lock, stop, [this]() { return this->pending > 0; });
+	}
+}
+
+auto ThreadPool::parallelFor(task_priority_t priority, size_t count, const std::function<void(size_t)> &fn) -> void {
+	if (count == 0) {
+		return;
+	}
+
+	// helpers starting after all indices were taken return right away, fn may be gone by then
+	auto state = std::make_shared<parallel_for_state_t>();
+	const auto helpers = std::min(count - 1, this->getWorkerCount());
+
+	for (size_t i = 0; i < helpers; ++i) {
+		this->push(priority, [state, count, fn = &fn]() { runIndices(*state, count, fn); });
+	}
+
+	runIndices(*state, count, &fn);
+
+	for (auto done = state->done.load(); done < count; done = state->done.load()) {
+		state->done.wait(done);
+	}
+
+	if (state->exception != nullptr) {
+		std::rethrow_exception(state->exception);
+	}
+}
@@ -0,0 +1,282 @@
+#include "time_join.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "dicts.hpp"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
+#include "utility.hpp"
+
+namespace {
+	// the joined range is split into blocks of about this many input samples, but not more blocks than this
+	constexpr size_t samples_per_block = 65'536;
+	constexpr size_t max_blocks = 256;
+
+	auto mergeSpans(std::span<const std::span<const time_t>> timestamps) -> std::vector<time_t> {
+		std::vector<time_t> merged{};
+
+		if (timestamps.size() == 1) {
+			return {timestamps.front().begin(), timestamps.front().end()};
+		}
+
+		std::vector<time_t> temp{};
+
+		for (const auto &e : timestamps) {
+			temp.clear();
+			temp.reserve(merged.size() + e.size());
+			std::ranges::set_union(merged, e, std::back_inserter(temp));
+			std::swap(merged, temp);
+		}
+
+		const auto [first, last] = std::ranges::unique(merged);
+		merged.erase(first, last);
+
+		return merged;
+	}
+
+	auto sliceTimestamps(const data_dict_t &dict, time_t from, time_t to) -> std::span<const time_t> {
+		const auto timestamps = std::span{*dict.timestamp};
+		const auto first = std::ranges::lower_bound(timestamps, from);
+		const auto last = std::ranges::upper_bound(timestamps, to);
+
+		return {first, last};
+	}
+
+	// joins [from, to] with cursors starting at from, so blocks are independent of each other
+	auto joinBlock(std::span<const data_dict_t *const> columns, time_t from, time_t to, const join_options_t &options)
+		-> joined_columns_t {
+		std::vector<std::span<const time_t>> slices{};
+		std::vector<JoinCursor> cursors{};
+
+		for (const auto *col : columns) {
+			slices.push_back(sliceTimestamps(*col, from, to));
+			auto &cursor = options.tolerance > 0 ? cursors.emplace_back(*col, options.tolerance)
+												 : cursors.emplace_back(*col);
+			cursor.seek(from);
+		}
+
+		const auto timeline = mergeSpans(slices);
+
+		joined_columns_t joined{};
+		joined.values.resize(columns.size());
+		std::vector<double> row(columns.size());
+
+		for (const auto &t : timeline) {
+			bool complete{true};
+
+			for (size_t i = 0; i < cursors.size(); ++i) {
+				row[i] = cursors[i].at(t, options.method);
+				complete = complete && !std::isnan(row[i]);
+			}
+
+			if (!complete) {
+				continue;
+			}
+
+			joined.timestamps.push_back(t);
+			for (size_t i = 0; i < row.size(); ++i) {
+				joined.values[i].push_back(row[i]);
+			}
+		}
+
+		return joined;
+	}
+}  // namespace
+
+auto getJoinMethodName(join_method_t method) -> std::string_view {
+	switch (method) {
+		using enum join_method_t;
+	case PREVIOUS:
+		return "previous";
+	case NEAREST:
+		return "nearest";
+	case LINEAR:
+		return "linear";
+	}
+
+	return "";
+}
+
+auto mergeTimestamps(std::span<const data_dict_t *const> columns) -> std::vector<time_t> {
+	std::vector<std::span<const time_t>> timestamps{};
+	for (const auto *col : columns) {
+		timestamps.emplace_back(*col->timestamp);
+	}
+
+	return mergeSpans(timestamps);
+}
+
+JoinCursor::JoinCursor(const data_dict_t &dict) : JoinCursor(dict, std::max(dict.delta_t * 10, time_t{1})) {}
+
+JoinCursor::JoinCursor(const data_dict_t &dict, time_t max_distance)
+	: timestamps{*dict.timestamp}, values{*dict.data}, tolerance{max_distance} {}
+
+auto JoinCursor::advance(time_t t) -> void {
+	while (this->index + 1 < this->timestamps.size() && this->timestamps[this->index + 1] <= t) {
+		++this->index;
+	}
+}
+
+auto JoinCursor::seek(time_t t) -> void {
+	const auto it = std::ranges::upper_bound(this->timestamps, t);
+	this->index = it == this->timestamps.begin() ? 0 : static_cast<size_t>(it - this->timestamps.begin()) - 1;
+}
+
+auto JoinCursor::previous(time_t t) -> double {
+	this->advance(t);
+
+	if (this->timestamps.empty() || this->timestamps[this->index] > t ||
+		t - this->timestamps[this->index] > this->tolerance) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	return this->values[this->index];
+}
+
+auto JoinCursor::nearest(time_t t) -> double {
+	this->advance(t);
+
+	// the closest sample is either the last one at or before t or the one after it
+	auto result = std::numeric_limits<double>::quiet_NaN();
+	auto best_distance = this->tolerance;
+
+	for (auto i = this->index; i < std::min(this->index + 2, this->timestamps.size()); ++i) {
+		const auto distance = std::abs(this->timestamps[i] - t);
+
+		if (distance <= best_distance && (std::isnan(result) || distance < best_distance)) {
+			result = this->values[i];
+			best_distance = distance;
+		}
+	}
+
+	return result;
+}
+
+auto JoinCursor::linear(time_t t) -> double {
+	this->advance(t);
+
+	if (this->timestamps.empty() || this->timestamps[this->index] > t) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	const auto t0 = this->timestamps[this->index];
+	if (t0 == t) {
+		return this->values[this->index];
+	}
+
+	if (this->index + 1 >= this->timestamps.size()) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	const auto t1 = this->timestamps[this->index + 1];
+	if (t - t0 > this->tolerance || t1 - t > this->tolerance) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	const auto fraction = static_cast<double>(t - t0) / static_cast<double>(t1 - t0);
+	return std::lerp(this->values[this->index], this->values[this->index + 1], fraction);
+}
+
+auto JoinCursor::at(time_t t, join_method_t method) -> double {
+	switch (method) {
+		using enum join_method_t;
+	case PREVIOUS:
+		return this->previous(t);
+	case NEAREST:
+		return this->nearest(t);
+	case LINEAR:
+		return this->linear(t);
+	}
+
+	return std::numeric_limits<double>::quiet_NaN();
+}
+
+auto sampleOnGrid(const data_dict_t &dict, time_t from, time_t interval, size_t count) -> std::vector<double> {
+	std::vector<double> result(count);
+	JoinCursor cursor{dict};
+
+	for (size_t i = 0; i < count; ++i) {
+		result[i] = cursor.previous(from + (static_cast<time_t>(i) * interval));
+	}
+
+	return result;
+}
+
+auto joined_columns_t::getMemoryUsage() const -> size_t {
+	auto sum = sizeof(joined_columns_t) + (this->timestamps.capacity() * sizeof(time_t)) +
+			   (this->values.capacity() * sizeof(std::vector<double>));
+
+	for (const auto &e : this->values) {
+		sum += e.capacity() * sizeof(double);
+	}
+
+	return sum;
+}
+
+auto joinColumns(std::span<const data_dict_t *const> columns, time_t from, time_t to, const join_options_t &options,
+				 task_priority_t priority) -> joined_columns_t {
+	const profiler::ScopedTimer timer{profiler::stage::join_columns};
+
+	joined_columns_t joined{};
+	joined.values.resize(columns.size());
+
+	if (columns.empty() || std::ranges::any_of(columns, [](const auto *e) { return e->timestamp->empty(); })) {
+		return joined;
+	}
+
+	// rows only exist at timestamps of the columns
+	const auto first = std::ranges::min(columns, {}, [](const auto *e) { return e->timestamp->front(); });
+	const auto last = std::ranges::max(columns, {}, [](const auto *e) { return e->timestamp->back(); });
+	from = std::max(from, first->timestamp->front());
+	to = std::min(to, last->timestamp->back());
+
+	if (from > to) {
+		return joined;
+	}
+
+	size_t samples{0};
+	for (const auto *col : columns) {
+		samples += sliceTimestamps(*col, from, to).size();
+	}
+
+	const auto block_count = std::clamp(samples / samples_per_block, size_t{1}, max_blocks);
+	const auto block_length = fastCeil(to - from + 1, static_cast<time_t>(block_count));
+
+	std::vector<joined_columns_t> blocks(block_count);
+	ThreadPool::getInstance().parallelFor(priority, block_count, [&](size_t i) {
+		const auto block_from = from + (static_cast<time_t>(i) * block_length);
+		const auto block_to = std::min(to, block_from + block_length - 1);
+
+		if (block_from <= block_to) {
+			blocks[i] = joinBlock(columns, block_from, block_to, options);
+		}
+	});
+
+	size_t rows{0};
+	for (const auto &block : blocks) {
+		rows += block.timestamps.size();
+	}
+
+	joined.timestamps.reserve(rows);
+	for (auto &e : joined.values) {
+		e.reserve(rows);
+	}
+
+	for (const auto &block : blocks) {
+		joined.timestamps.insert(joined.timestamps.end(), block.timestamps.begin(), block.timestamps.end());
+
+		for (size_t i = 0; i < block.values.size(); ++i) {
+			joined.values[i].insert(joined.values[i].end(), block.values[i].begin(), block.values[i].end());
+		}
+	}
+
+	return joined;
+}
@@ -0,0 +1,44 @@
+#include "view_state.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "dicts.hpp"
+
+auto computeViewState(const std::vector<data_dict_t> &data, view_state_t &state) -> void {
+	state.visible_columns.clear();
+
+	auto date_min = std::numeric_limits<time_t>::max();
+	auto date_max = std::numeric_limits<time_t>::lowest();
+	auto value_min = std::numeric_limits<double>::max();
+	auto value_max = std::numeric_limits<double>::lowest();
+
+	for (size_t i = 0; i < data.size(); ++i) {
+		const auto &col = data[i];
+
+		if (!col.visible) {
+			continue;
+		}
+
+		state.visible_columns.push_back(i);
+
+		if (col.timestamp->empty()) {
+			continue;
+		}
+
+		date_min = std::min(date_min, col.timestamp->front());
+		date_max = std::max(date_max, col.timestamp->back());
+
+		if (!col.data->empty()) {
+			const auto [min_it, max_it] = std::ranges::minmax_element(*col.data);
+			value_min = std::min(value_min, *min_it);
+			value_max = std::max(value_max, *max_it);
+		}
+	}
+
+	state.x_lims = {static_cast<double>(date_min), static_cast<double>(date_max)};
+	state.value_lims = {value_min, value_max};
+	state.has_visible_data = date_min != std::numeric_limits<time_t>::max();
+}
@@ -7,8 +7,12 @@
 #ifdef __linux__
 #include <unistd.h>
 #include <sys/types.h>
+#include <time.h>
 #endif
 
+#include <chrono>
+#include <cstdint>
+#include <ctime>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -83,4 +87,33 @@ auto openWebpage(std::string url) -> void {
 #else
 #warning "Unknown OS, can't open webpages"
 #endif
-}
\ No newline at end of file
+}
+
+auto getProcessCPUTime() -> std::chrono::nanoseconds {
+#if defined(_WIN32)
+	FILETIME creation_time{};
+	FILETIME exit_time{};
+	FILETIME kernel_time{};
+	FILETIME user_time{};
+
+	if (GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time) == 0) {
+		return {};
+	}
+
+	const auto to_100ns = [](const FILETIME &ft) -> uint64_t {
+		return (static_cast<uint64_t>(ft.dwHighDateTime) << 32u) | ft.dwLowDateTime;
+	};
+
+	return std::chrono::nanoseconds{(to_100ns(kernel_time) + to_100ns(user_time)) * 100};
+#elif defined(__linux__)
+	timespec ts{};
+	if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) {
+		return {};
+	}
+
+	return std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec};
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::duration<double>(static_cast<double>(std::clock()) / CLOCKS_PER_SEC));
+#endif
+}
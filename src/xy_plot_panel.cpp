@@ -0,0 +1,396 @@
+#include "xy_plot_panel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <future>
+#include <limits>
+#include <memory>
+#include <set>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "density_grid.hpp"
+#include "dicts.hpp"
+#include "fmt/format.h"
+#include "global_state.hpp"
+#include "imgui.h"
+#include "imgui_extensions.hpp"
+#include "implot.h"
+#include "thread_pool.hpp"
+#include "time_join.hpp"
+#include "window_context.hpp"
+
+namespace {
+	// markers become an unreadable, slow blob beyond this, the density is shown instead
+	constexpr size_t max_scatter_points = 1'000'000;
+	// bins of 2x2 pixels keep the heatmap at a few hundred thousand cells even on large screens
+	constexpr float pixels_per_bin = 2.0f;
+	constexpr size_t max_bins = 1'024;
+
+	auto findColumn(const std::vector<data_dict_t> &data, const std::string &uuid) -> const data_dict_t * {
+		const auto it = std::ranges::find(data, uuid, &data_dict_t::uuid);
+		return it != data.end() && it->data_type == data_type_t::FLOAT && !it->data->empty() ? &*it : nullptr;
+	}
+
+	auto getAxisLabel(const data_dict_t &col) -> std::string {
+		return col.unit.empty() ? col.name : fmt::format("{} [{}]", col.name, col.unit);
+	}
+
+	auto drawYColumnsCombo(const std::vector<data_dict_t> &data, std::vector<std::string> &uuids) -> void {
+		const auto *first = uuids.size() == 1 ? findColumn(data, uuids.front()) : nullptr;
+		const auto preview = first != nullptr ? first->name : fmt::format("{} columns", uuids.size());
+
+		ImGui::SetNextItemWidth(250.0f);
+		if (!ImGui::BeginCombo("Y", preview.c_str())) {
+			return;
+		}
+
+		for (const auto &col : data) {
+			if (col.data_type != data_type_t::FLOAT || col.data->empty()) {
+				continue;
+			}
+
+			const auto it = std::ranges::find(uuids, col.uuid);
+			bool selected = it != uuids.end();
+
+			if (ImGui::Checkbox(col.ids.label.c_str(), &selected)) {
+				if (selected) {
+					uuids.push_back(col.uuid);
+				} else {
+					uuids.erase(it);
+				}
+			}
+		}
+
+		ImGui::EndCombo();
+	}
+
+	auto drawJoinOptions(join_options_t &options) -> void {
+		ImGui::SetNextItemWidth(100.0f);
+		if (ImGui::BeginCombo("Join", getJoinMethodName(options.method).data())) {
+			for (const auto &method : join_methods) {
+				if (ImGui::Selectable(getJoinMethodName(method).data(), method == options.method)) {
+					options.method = method;
+				}
+			}
+
+			ImGui::EndCombo();
+		}
+
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(100.0f);
+
+		static_assert(sizeof(time_t) == sizeof(ImS64));
+		if (ImGui::InputScalar("Tolerance [s]", ImGuiDataType_S64, &options.tolerance)) {
+			options.tolerance = std::max(options.tolerance, time_t{0});
+		}
+
+		ImGui::SetItemTooltip("Maximum distance of the samples used for a point, 0 uses the gap threshold of a column");
+	}
+
+	// fits the axes to the data instead of the plotted items, a density grid only covers the previous view
+	auto fitAxes(const joined_columns_t &joined) -> void {
+		if (joined.timestamps.empty()) {
+			return;
+		}
+
+		const auto [x_min, x_max] = std::ranges::minmax(joined.values.front());
+		auto y_min = std::numeric_limits<double>::infinity();
+		auto y_max = -std::numeric_limits<double>::infinity();
+
+		for (size_t i = 1; i < joined.values.size(); ++i) {
+			const auto [min, max] = std::ranges::minmax(joined.values[i]);
+			y_min = std::min(y_min, min);
+			y_max = std::max(y_max, max);
+		}
+
+		ImPlot::SetNextAxesLimits(x_min, x_max, y_min, y_max, ImPlotCond_Always);
+	}
+
+	auto getBinCount(float pixels) -> size_t {
+		return std::clamp(static_cast<size_t>(pixels / pixels_per_bin), size_t{1}, max_bins);
+	}
+
+	auto drawDensity(DensityJobs &jobs, const std::shared_ptr<const joined_columns_t> &joined) -> void {
+		const auto limits = ImPlot::GetPlotLimits();
+		const auto size = ImPlot::GetPlotSize();
+		const density_bounds_t bounds{.x_min = limits.X.Min,
+									  .x_max = limits.X.Max,
+									  .y_min = limits.Y.Min,
+									  .y_max = limits.Y.Max,
+									  .columns = getBinCount(size.x),
+									  .rows = getBinCount(size.y)};
+
+		// drawn at the bounds it was binned for, so an older grid stays in place while zooming
+		const auto grid = jobs.get(joined, bounds);
+		if (grid == nullptr || grid->counts.empty()) {
+			return;
+		}
+
+		const auto &b = grid->bounds;
+		ImPlot::PushColormap(ImPlotColormap_Viridis);
+		ImPlot::PlotHeatmap("##density", grid->counts.data(), static_cast<int>(b.rows), static_cast<int>(b.columns),
+							0.0, std::log10(1.0 + grid->max_count), nullptr, ImPlotPoint(b.x_min, b.y_min),
+							ImPlotPoint(b.x_max, b.y_max));
+		ImPlot::PopColormap();
+	}
+}  // namespace
+
+auto XYJoinJobs::get(std::span<const data_dict_t *const> columns, const xy_key_t &key)
+	-> std::shared_ptr<const joined_columns_t> {
+	if (this->job.valid() && this->job.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+		this->latest = this->job.get();
+		this->cache[this->job_key] = this->latest;
+		this->insertion_order.push_back(this->job_key);
+
+		if (this->insertion_order.size() > cache_size) {
+			this->cache.erase(this->insertion_order.front());
+			this->insertion_order.pop_front();
+		}
+	}
+
+	if (const auto it = this->cache.find(key); it != this->cache.end()) {
+		this->latest = it->second;
+		return this->latest;
+	}
+
+	if (!this->job.valid()) {
+		// only the vectors are shared with the job, the columns themselves may be moved or aggregated meanwhile
+		std::vector<data_dict_t> sources{};
+		for (const auto *col : columns) {
+			auto &source = sources.emplace_back();
+			source.uuid = col->uuid;
+			source.timestamp = col->timestamp;
+			source.data = col->data;
+			source.delta_t = col->delta_t;
+		}
+
+		this->job_key = key;
+		this->job = ThreadPool::getInstance().submit(task_priority_t::visible, [sources = std::move(sources), key]() {
+			std::vector<const data_dict_t *> pointers{};
+			for (const auto &source : sources) {
+				pointers.push_back(&source);
+			}
+
+			const join_options_t options{.method = key.method, .tolerance = key.tolerance};
+			auto result = std::make_shared<const joined_columns_t>(joinColumns(pointers, key.from, key.to, options));
+			AppState::getInstance().wakeMainLoop();
+			return result;
+		});
+	}
+
+	return this->latest;
+}
+
+auto XYJoinJobs::isBusy() const -> bool {
+	return this->job.valid() && this->job.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+auto XYJoinJobs::clear() -> void {
+	this->cache.clear();
+	this->insertion_order.clear();
+	this->job = {};
+	this->latest.reset();
+}
+
+auto XYJoinJobs::getMemoryUsage() const -> size_t {
+	std::set<const joined_columns_t *> results{this->latest.get()};
+	for (const auto &[key, joined] : this->cache) {
+		results.insert(joined.get());
+	}
+
+	size_t sum{0};
+	for (const auto *joined : results) {
+		if (joined != nullptr) {
+			sum += joined->getMemoryUsage();
+		}
+	}
+
+	return sum;
+}
+
+auto DensityJobs::get(const std::shared_ptr<const joined_columns_t> &joined, const density_bounds_t &bounds)
+	-> std::shared_ptr<const density_grid_t> {
+	if (this->job.valid() && this->job.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+		auto result = this->job.get();
+		this->latest = std::move(result.grid);
+		this->latest_source = this->job_source;
+
+		if (this->job_source == this->source) {
+			this->points = std::move(result.points);
+		}
+	}
+
+	if (joined != this->source) {
+		this->source = joined;
+		this->points.reset();
+	}
+
+	if (this->latest != nullptr && this->latest_source == this->source && this->latest->bounds == bounds) {
+		return this->latest;
+	}
+
+	if (!this->job.valid()) {
+		this->job_source = this->source;
+		this->job = ThreadPool::getInstance().submit(
+			task_priority_t::visible, [joined, points = this->points, bounds]() {
+				auto sorted = points != nullptr
+								  ? points
+								  : std::make_shared<const std::vector<xy_point_t>>(sortPointsByX(*joined));
+				auto grid = binDensity(*sorted, bounds);
+
+				// logarithmic, so sparse outliers stay visible next to dense clusters, max_count stays the raw count
+				std::ranges::transform(grid.counts, grid.counts.begin(), [](double e) { return std::log10(1.0 + e); });
+
+				density_job_result_t result{.points = std::move(sorted),
+											.grid = std::make_shared<const density_grid_t>(std::move(grid))};
+				AppState::getInstance().wakeMainLoop();
+				return result;
+			});
+	}
+
+	return this->latest;
+}
+
+auto DensityJobs::isBusy() const -> bool {
+	return this->job.valid() && this->job.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+auto DensityJobs::getMemoryUsage() const -> size_t {
+	size_t sum{0};
+
+	if (this->points != nullptr) {
+		sum += sizeof(std::vector<xy_point_t>) + (this->points->capacity() * sizeof(xy_point_t));
+	}
+
+	if (this->latest != nullptr) {
+		sum += sizeof(density_grid_t) + (this->latest->counts.capacity() * sizeof(double));
+	}
+
+	return sum;
+}
+
+auto openXYPlotWindow(WindowContext &window_context) -> void {
+	auto &state = window_context.getXYPlotPanelStateRef();
+	const auto &data = window_context.getData();
+	state.open = true;
+
+	if (findColumn(data, state.x_uuid) != nullptr) {
+		return;
+	}
+
+	// the first two visible columns, e.g. speed and torque
+	state.y_uuids.clear();
+	for (const auto &index : window_context.getViewState().visible_columns) {
+		if (findColumn(data, data[index].uuid) == nullptr) {
+			continue;
+		}
+
+		if (state.x_uuid.empty() || findColumn(data, state.x_uuid) == nullptr) {
+			state.x_uuid = data[index].uuid;
+		} else {
+			state.y_uuids.push_back(data[index].uuid);
+			break;
+		}
+	}
+}
+
+auto drawXYPlotWindow(WindowContext &window_context) -> void {
+	auto &state = window_context.getXYPlotPanelStateRef();
+	if (!state.open) {
+		return;
+	}
+
+	const auto title = fmt::format("XY plot - {}##xy_plot{}", window_context.getWindowTitle(),
+								   window_context.getUUID());
+
+	ImGui::SetNextWindowSize(ImVec2(600, 600), ImGuiCond_FirstUseEver);
+	if (!ImGui::Begin(title.c_str(), &state.open)) {
+		ImGui::End();
+		return;
+	}
+
+	const auto &data = window_context.getData();
+
+	ImGui::SetNextItemWidth(250.0f);
+	ImGuiExt::FloatColumnCombo("X", data, state.x_uuid);
+	ImGui::SameLine();
+	drawYColumnsCombo(data, state.y_uuids);
+	drawJoinOptions(state.join);
+	ImGui::SameLine();
+	ImGui::Checkbox("Density", &state.density);
+	ImGui::SetItemTooltip("Shows the number of points per pixel instead of the points, always used beyond %zu points",
+						  max_scatter_points);
+
+	std::vector<const data_dict_t *> columns{findColumn(data, state.x_uuid)};
+	for (const auto &uuid : state.y_uuids) {
+		if (const auto *col = findColumn(data, uuid); col != nullptr) {
+			columns.push_back(col);
+		}
+	}
+
+	if (columns.front() == nullptr || columns.size() < 2) {
+		ImGui::TextUnformatted("Select an X and at least one Y column.");
+		ImGui::End();
+		return;
+	}
+
+	const auto [x_min, x_max] = window_context.getVisibleXRange();
+	xy_key_t key{.uuids = {},
+				 .from = static_cast<time_t>(std::floor(x_min)),
+				 .to = static_cast<time_t>(std::ceil(x_max)),
+				 .method = state.join.method,
+				 .tolerance = state.join.tolerance};
+
+	for (const auto *col : columns) {
+		key.uuids.push_back(col->uuid);
+	}
+
+	const auto joined = state.jobs.get(columns, key);
+	const auto busy = state.jobs.isBusy();
+
+	// an older result may belong to other columns while the new one is being joined
+	if (joined == nullptr || joined->values.size() != columns.size()) {
+		ImGuiExt::TextFormattedDisabled("{}", busy ? "joining..." : "no data");
+		ImGui::End();
+		return;
+	}
+
+	const auto points = joined->timestamps.size() * (columns.size() - 1);
+	const auto use_density = state.density || points > max_scatter_points;
+
+	ImGuiExt::TextFormattedDisabled("{} points{}{}", points, use_density ? " as density" : "",
+									busy || (use_density && state.density_jobs.isBusy()) ? ", calculating..." : "");
+
+	window_context.switchToImPlotContext();
+
+	if (joined != state.shown) {
+		fitAxes(*joined);
+		state.shown = joined;
+	}
+
+	if (ImPlot::BeginPlot("##xy", ImVec2(-1, -1))) {
+		const auto x_label = getAxisLabel(*columns.front());
+		const auto y_label = columns.size() == 2 ? getAxisLabel(*columns[1]) : std::string{};
+		ImPlot::SetupAxes(x_label.c_str(), y_label.c_str());
+
+		if (use_density) {
+			drawDensity(state.density_jobs, joined);
+		} else {
+			const auto count = static_cast<int>(joined->timestamps.size());
+			for (size_t i = 1; i < columns.size(); ++i) {
+				ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 1.5f);
+				ImPlot::PlotScatter(columns[i]->name.c_str(), joined->values.front().data(), joined->values[i].data(),
+									count);
+			}
+		}
+
+		ImPlot::EndPlot();
+	}
+
+	ImGui::End();
+}
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "cxxopts.hpp"
+#include "dataset_generator.hpp"
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+namespace {
+	auto parseStart(const std::string &str) -> time_t {
+		std::istringstream ss{str};
+		std::chrono::sys_seconds tp{};
+		ss >> std::chrono::parse("%Y-%m-%d %H:%M:%S", tp);
+
+		if (ss.fail()) {
+			throw std::runtime_error(fmt::format("Failed to parse date: \"{}\"", str));
+		}
+
+		return std::chrono::system_clock::to_time_t(tp);
+	}
+}  // namespace
+
+auto main(int argc, char **argv) -> int {
+	cxxopts::Options options(argv[0], "Writes synthetic CSV files in the format Spreadsheet Analyzer loads");
+
+	const dataset_options_t defaults{};
+
+	options.add_options()
+		("h,help", "Print usage")
+		("o,output", "output directory", cxxopts::value<std::string>()->default_value("."), "DIR")
+		("prefix", "file name prefix", cxxopts::value<std::string>()->default_value(defaults.prefix), "NAME")
+		("seed", "random seed", cxxopts::value<uint64_t>()->default_value(std::to_string(defaults.seed)), "N")
+		("files", "number of files", cxxopts::value<size_t>()->default_value(std::to_string(defaults.files)), "N")
+		("rows", "rows per file", cxxopts::value<size_t>()->default_value(std::to_string(defaults.rows)), "N")
+		("columns", "number of channels", cxxopts::value<size_t>()->default_value(std::to_string(defaults.columns)),
+			"N")
+		("start", "first timestamp, e.g. \"2025-01-01 00:00:00\"", cxxopts::value<std::string>(), "DATE")
+		("interval", "seconds between samples",
+			cxxopts::value<time_t>()->default_value(std::to_string(defaults.interval)), "SECONDS")
+		("jitter", "maximum timestamp deviation in seconds",
+			cxxopts::value<time_t>()->default_value(std::to_string(defaults.jitter)), "SECONDS")
+		("gap-probability", "probability per row to start a gap", cxxopts::value<double>()->default_value("0"), "P")
+		("gap-length", "samples per gap",
+			cxxopts::value<size_t>()->default_value(std::to_string(defaults.gap_length)), "N")
+		("overlap", "rows shared between consecutive files", cxxopts::value<size_t>()->default_value("0"), "N")
+		("booleans", "fraction of boolean channels", cxxopts::value<double>()->default_value("0"), "FRACTION")
+		("enums", "fraction of enum channels", cxxopts::value<double>()->default_value("0"), "FRACTION")
+		("enum-levels", "levels of enum channels",
+			cxxopts::value<size_t>()->default_value(std::to_string(defaults.enum_levels)), "N")
+		("empty", "probability of an empty cell", cxxopts::value<double>()->default_value("0"), "P")
+		("malformed", "probability of a malformed line", cxxopts::value<double>()->default_value("0"), "P")
+		("slash-dates", "write dates as 2025/01/01 instead of 2025-01-01")
+		;
+
+	try {
+		const auto result = options.parse(argc, argv);
+
+		if (result.count("help") != 0u) {
+			std::cout << options.help() << '\n';
+			return EXIT_SUCCESS;
+		}
+
+		dataset_options_t dataset{
+			.seed = result["seed"].as<uint64_t>(),
+			.files = result["files"].as<size_t>(),
+			.rows = result["rows"].as<size_t>(),
+			.columns = result["columns"].as<size_t>(),
+			.start = defaults.start,
+			.interval = result["interval"].as<time_t>(),
+			.jitter = result["jitter"].as<time_t>(),
+			.gap_probability = result["gap-probability"].as<double>(),
+			.gap_length = result["gap-length"].as<size_t>(),
+			.overlap = result["overlap"].as<size_t>(),
+			.boolean_fraction = result["booleans"].as<double>(),
+			.enum_fraction = result["enums"].as<double>(),
+			.enum_levels = result["enum-levels"].as<size_t>(),
+			.empty_cell_probability = result["empty"].as<double>(),
+			.malformed_line_probability = result["malformed"].as<double>(),
+			.slash_dates = result.count("slash-dates") != 0u,
+			.prefix = result["prefix"].as<std::string>()};
+
+		if (result.count("start") != 0u) {
+			dataset.start = parseStart(result["start"].as<std::string>());
+		}
+
+		const auto paths = generateDataset(dataset, result["output"].as<std::string>());
+
+		for (const auto &path : paths) {
+			std::cout << path.string() << '\n';
+		}
+
+		if (!std::cout.flush()) {
+			spdlog::critical("Failed to write the file names");
+			return EXIT_FAILURE;
+		}
+	} catch (const std::exception &e) {
+		spdlog::critical(e.what());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}